@@ -130,6 +130,8 @@ extern bool optimize_bounded_sort;
 
 static double yb_transaction_priority_lower_bound = 0.0;
 static double yb_transaction_priority_upper_bound = 1.0;
+static bool yb_read_from_followers = false;
+static int yb_follower_read_staleness_ms = 30000;
 
 static int	GUC_check_errcode_value;
 
@@ -204,6 +206,8 @@ static bool check_transaction_priority_lower_bound(double *newval, void **extra,
 extern void YBCAssignTransactionPriorityLowerBound(double newval, void* extra);
 static bool check_transaction_priority_upper_bound(double *newval, void **extra, GucSource source);
 extern void YBCAssignTransactionPriorityUpperBound(double newval, void* extra);
+extern void YBCAssignReadFromFollowers(bool newval, void* extra);
+extern void YBCAssignFollowerReadStalenessMs(int newval, void* extra);
 
 /* Private functions in guc-file.l that need to be called from guc.c */
 static ConfigVariable *ProcessConfigFileInternal(GucContext context,
@@ -1887,6 +1891,17 @@ static struct config_bool ConfigureNamesBool[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"yb_read_from_followers", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Allow read-only transactions to read from the closest replica."),
+			gettext_noop("Reads see data as of yb_follower_read_staleness_ms ago. Replicas "
+						 "that are further behind redirect the read to the tablet leader.")
+		},
+		&yb_read_from_followers,
+		false,
+		NULL, YBCAssignReadFromFollowers, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, false, NULL, NULL, NULL
@@ -3120,6 +3135,20 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"yb_follower_read_staleness_ms", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets how far in the past read-only transactions read when "
+						 "yb_read_from_followers is enabled."),
+			gettext_noop("Limited by the default timestamp_history_retention_interval_sec "
+						 "of the tablet servers, because older history could be already "
+						 "compacted away."),
+			GUC_UNIT_MS
+		},
+		&yb_follower_read_staleness_ms,
+		30000, 0, 120000,
+		NULL, YBCAssignFollowerReadStalenessMs, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, 0, 0, NULL, NULL, NULL
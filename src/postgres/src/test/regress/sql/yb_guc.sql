@@ -23,3 +23,14 @@ set yb_transaction_priority_upper_bound = 0.3;
 set yb_transaction_priority_upper_bound = 0.6;
 set yb_transaction_priority_lower_bound = 0.4;
 set yb_transaction_priority_lower_bound = 0.6;
+
+-- Check follower reads settings.
+-- Invalid values.
+set yb_follower_read_staleness_ms = -1;
+
+-- Valid values.
+set yb_read_from_followers = true;
+set yb_follower_read_staleness_ms = 0;
+set yb_follower_read_staleness_ms = '5s';
+show yb_follower_read_staleness_ms;
+set yb_read_from_followers = false;
@@ -700,6 +700,11 @@ std::unique_ptr<YBPgsqlReadOp> YBPgsqlReadOp::NewSelect(const shared_ptr<YBTable
   return op;
 }
 
+OpGroup YBPgsqlReadOp::group() {
+  return yb_consistency_level_ == YBConsistencyLevel::CONSISTENT_PREFIX
+      ? OpGroup::kConsistentPrefixRead : OpGroup::kLeaderRead;
+}
+
 std::unique_ptr<YBPgsqlReadOp> YBPgsqlReadOp::DeepCopy() {
   auto op = NewSelect(table_);
   op->set_yb_consistency_level(yb_consistency_level());
@@ -80,6 +80,11 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator cannot seek by tuple id");
   }
 
+  // Seeks forward to the given tuple by its id. See DocRowwiseIterator for details.
+  virtual Result<bool> SeekTupleForward(const Slice& tuple_id) {
+    return SeekTuple(tuple_id);
+  }
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
@@ -98,6 +98,17 @@ class YQLStorageIf {
                                      const ReadHybridTime& read_time,
                                      const QLValuePB& ybctid,
                                      common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
+
+  // Create iterator for querying by a batch of ybctids, which must be sorted. The iterator is not
+  // bounded to any key and is expected to be positioned with SeekTupleForward.
+  virtual CHECKED_STATUS GetIteratorForYbctidBatch(
+      const Schema& projection,
+      const Schema& schema,
+      const TransactionOperationContextOpt& txn_op_context,
+      CoarseTimePoint deadline,
+      const ReadHybridTime& read_time,
+      const std::vector<Slice>& ybctids,
+      common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
 };
 
 }  // namespace common
@@ -97,6 +97,7 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   }
   pb->set_is_ysql_catalog_table(is_ysql_catalog_table_);
   pb->set_is_backfilling(is_backfilling_);
+  pb->set_use_partition_tombstones(use_partition_tombstones_);
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -128,6 +129,9 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_is_backfilling()) {
     table_properties.SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_use_partition_tombstones()) {
+    table_properties.SetUsePartitionTombstones(pb.use_partition_tombstones());
+  }
   return table_properties;
 }
 
@@ -156,6 +160,9 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_is_backfilling()) {
     SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_use_partition_tombstones()) {
+    SetUsePartitionTombstones(pb.use_partition_tombstones());
+  }
 }
 
 void TableProperties::Reset() {
@@ -168,6 +175,7 @@ void TableProperties::Reset() {
   num_tablets_ = 0;
   is_ysql_catalog_table_ = false;
   is_backfilling_ = false;
+  use_partition_tombstones_ = false;
 }
 
 string TableProperties::ToString() const {
@@ -180,6 +188,9 @@ string TableProperties::ToString() const {
   if (HasCopartitionTableId()) {
     result += Format("copartition_table_id: $0 ", copartition_table_id_);
   }
+  if (use_partition_tombstones_) {
+    result += "use_partition_tombstones: true ";
+  }
   return result + Format(
       "consistency_level: $0 is_ysql_catalog_table: $1 }",
       consistency_level_,
@@ -378,7 +378,8 @@ class TableProperties {
 
     return default_time_to_live_ == other.default_time_to_live_ &&
            use_mangled_column_name_ == other.use_mangled_column_name_ &&
-           contain_counters_ == other.contain_counters_;
+           contain_counters_ == other.contain_counters_ &&
+           use_partition_tombstones_ == other.use_partition_tombstones_;
 
     // Ignoring num_tablets_.
     // Ignoring is_backfilling_.
@@ -414,6 +415,7 @@ class TableProperties {
     // Ignoring contain_counters_.
     // Ignoring is_backfilling_.
     // Ignoring wal_retention_secs_.
+    // Ignoring use_partition_tombstones_.
     return true;
   }
 
@@ -497,6 +499,14 @@ class TableProperties {
 
   void SetIsBackfilling(bool is_backfilling) { is_backfilling_ = is_backfilling; }
 
+  void SetUsePartitionTombstones(bool value) {
+    use_partition_tombstones_ = value;
+  }
+
+  bool use_partition_tombstones() const {
+    return use_partition_tombstones_;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -523,6 +533,7 @@ class TableProperties {
   bool use_mangled_column_name_ = false;
   int num_tablets_ = 0;
   bool is_ysql_catalog_table_ = false;
+  bool use_partition_tombstones_ = false;
 };
 
 typedef uint32_t PgTableOid;
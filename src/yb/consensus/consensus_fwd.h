@@ -23,6 +23,7 @@ namespace consensus {
 
 class Consensus;
 class ConsensusContext;
+class MultiRaftManager;
 class PeerProxyFactory;
 class PeerMessageQueue;
 class RaftConfigPB;
@@ -51,6 +52,9 @@ typedef std::unique_ptr<ConsensusServiceProxy> ConsensusServiceProxyPtr;
 class LeaderElection;
 typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
 
+class MultiRaftHeartbeatBatcher;
+typedef std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcherPtr;
+
 class PeerProxy;
 typedef std::unique_ptr<PeerProxy> PeerProxyPtr;
 
@@ -31,6 +31,7 @@
 //
 
 #include <chrono>
+#include <mutex>
 
 #include <gtest/gtest.h>
 
@@ -54,6 +55,9 @@
 
 using namespace std::chrono_literals;
 
+DECLARE_int32(consensus_max_inflight_requests_per_peer);
+DECLARE_int32(raft_heartbeat_interval_ms);
+
 METRIC_DECLARE_entity(tablet);
 
 namespace yb {
@@ -199,9 +203,6 @@ TEST_F(ConsensusPeersTest, TestRemotePeer) {
   // Append a bunch of messages to the queue.
   AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 20);
 
-  // The above append ends up appending messages in term 2, so we update the peer's term to match.
-  remote_peer->SetTermForTest(2);
-
   // signal the peer there are requests pending.
   ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
 
@@ -212,6 +213,263 @@ TEST_F(ConsensusPeersTest, TestRemotePeer) {
   CheckLastRemoteEntry(proxy, 2, 20);
 }
 
+// Proxy that batches heartbeats. The batch consists of a single heartbeat, that is handled in the
+// same way as a regular update.
+class BatchingTestPeerProxy : public NoOpTestPeerProxy {
+ public:
+  using NoOpTestPeerProxy::NoOpTestPeerProxy;
+
+  bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                           ConsensusResponsePB* response,
+                           StdStatusCallback callback) override {
+    EXPECT_EQ(request.ops_size(), 0);
+    auto controller = std::make_shared<rpc::RpcController>();
+    UpdateAsync(&request, RequestTriggerMode::kAlwaysSend, response, controller.get(),
+                [this, callback, controller] {
+      callback(Status::OK());
+      ++num_batched_heartbeats_;
+    });
+    return true;
+  }
+
+  int num_batched_heartbeats() const {
+    return num_batched_heartbeats_.load();
+  }
+
+ private:
+  std::atomic<int> num_batched_heartbeats_{0};
+};
+
+// Tests that periodic heartbeats are sent through the batching path of the proxy, while requests
+// signalled by consensus are sent with a regular update, even when they do not carry ops.
+TEST_F(ConsensusPeersTest, TestBatchedHeartbeats) {
+  // The first peer does not send periodic heartbeats during the test.
+  FLAGS_raft_heartbeat_interval_ms = 60000;
+  auto peer_pb = FakeRaftPeerPB(kFollowerUuid);
+  auto proxy = new BatchingTestPeerProxy(raft_pool_.get(), peer_pb);
+  auto remote_peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      peer_pb, kTabletId, kLeaderUuid, PeerProxyPtr(proxy), message_queue_.get(),
+      raft_pool_token_.get(), nullptr /* consensus */, messenger_.get()));
+  auto se = ScopeExit([&remote_peer] {
+    remote_peer->Close();
+  });
+
+  ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 20);
+  ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+  WaitForMajorityReplicatedIndex(20);
+  ASSERT_EQ(yb::OpId::FromPB(proxy->last_received()), yb::OpId(2, 20));
+  ASSERT_EQ(proxy->num_batched_heartbeats(), 0);
+
+  // Periodic heartbeats of the second peer are batched once it caught up.
+  FLAGS_raft_heartbeat_interval_ms = 100;
+  auto peer_pb2 = FakeRaftPeerPB("peer-2");
+  auto proxy2 = new BatchingTestPeerProxy(raft_pool_.get(), peer_pb2);
+  auto remote_peer2 = ASSERT_RESULT(Peer::NewRemotePeer(
+      peer_pb2, kTabletId, kLeaderUuid, PeerProxyPtr(proxy2), message_queue_.get(),
+      raft_pool_token_.get(), nullptr /* consensus */, messenger_.get()));
+  auto se2 = ScopeExit([&remote_peer2] {
+    remote_peer2->Close();
+  });
+  ASSERT_OK(WaitFor(
+      [proxy2] { return proxy2->num_batched_heartbeats() > 0; }, 10s, "Batched heartbeat response"));
+}
+
+// Proxy that applies requests to a fake follower log right away, but could hold the responses until
+// the test releases them, so that several requests are in flight at the same time.
+class PipelinedTestPeerProxy : public PeerProxy {
+ public:
+  explicit PipelinedTestPeerProxy(ThreadPool* pool) : pool_(pool) {}
+
+  void UpdateAsync(const ConsensusRequestPB* request,
+                   RequestTriggerMode trigger_mode,
+                   ConsensusResponsePB* response,
+                   rpc::RpcController* controller,
+                   const rpc::ResponseCallback& callback) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hold_requests_) {
+      held_requests_.push_back(HeldRequest{request, response, callback});
+      return;
+    }
+    ApplyRequestUnlocked(request, response, callback);
+  }
+
+  void RequestConsensusVoteAsync(const VoteRequestPB* request,
+                                 VoteResponsePB* response,
+                                 rpc::RpcController* controller,
+                                 const rpc::ResponseCallback& callback) override {
+    LOG(DFATAL) << "Not implemented";
+  }
+
+  void HoldRequests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_requests_ = true;
+  }
+
+  // Stops holding requests and applies the held ones, the latest first, as if they were reordered
+  // on the way to the follower.
+  void ApplyRequestsInReverseOrder() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_requests_ = false;
+    for (auto it = held_requests_.rbegin(); it != held_requests_.rend(); ++it) {
+      ApplyRequestUnlocked(it->request, it->response, it->callback);
+    }
+    held_requests_.clear();
+  }
+
+  size_t num_held_requests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_requests_.size();
+  }
+
+  void HoldResponses() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_responses_ = true;
+  }
+
+  // Stops holding responses and delivers the held ones, the latest first.
+  void RespondInReverseOrder() {
+    std::vector<rpc::ResponseCallback> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      hold_responses_ = false;
+      callbacks.swap(held_responses_);
+    }
+    for (auto it = callbacks.rbegin(); it != callbacks.rend(); ++it) {
+      (*it)();
+    }
+  }
+
+  int64_t last_received_index() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_received_.index();
+  }
+
+  int num_ops_received() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_ops_received_;
+  }
+
+  size_t num_held_responses() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_responses_.size();
+  }
+
+ private:
+  struct HeldRequest {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::ResponseCallback callback;
+  };
+
+  void ApplyRequestUnlocked(const ConsensusRequestPB* request,
+                            ConsensusResponsePB* response,
+                            const rpc::ResponseCallback& callback) {
+    response->Clear();
+    if (OpIdLessThan(last_received_, request->preceding_id())) {
+      ConsensusErrorPB* error = response->mutable_status()->mutable_error();
+      error->set_code(ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH);
+      StatusToPB(STATUS(IllegalState, ""), error->mutable_status());
+    } else if (request->ops_size() > 0) {
+      last_received_ = request->ops(request->ops_size() - 1).id();
+      num_ops_received_ += request->ops_size();
+    }
+    response->set_responder_uuid(kFollowerUuid);
+    response->set_responder_term(request->caller_term());
+    *response->mutable_status()->mutable_last_received() = last_received_;
+    *response->mutable_status()->mutable_last_received_current_leader() = last_received_;
+    response->mutable_status()->set_last_committed_idx(last_received_.index());
+    if (hold_responses_) {
+      held_responses_.push_back(callback);
+    } else {
+      WARN_NOT_OK(pool_->SubmitFunc(callback), "Submit failed");
+    }
+  }
+
+  ThreadPool* const pool_;
+  std::mutex mutex_;
+  OpIdPB last_received_ = MinimumOpId();
+  int num_ops_received_ = 0;
+  bool hold_requests_ = false;
+  bool hold_responses_ = false;
+  std::vector<HeldRequest> held_requests_;
+  std::vector<rpc::ResponseCallback> held_responses_;
+};
+
+// Tests that the leader sends new ops to a peer before the previous ones are acknowledged when
+// requests are pipelined, and that responses arriving out of order do not make it resend ops.
+TEST_F(ConsensusPeersTest, TestPipelinedRequests) {
+  FLAGS_consensus_max_inflight_requests_per_peer = 5;
+  // Heartbeats should not take slots of the requests sent by the test.
+  FLAGS_raft_heartbeat_interval_ms = 60000;
+
+  auto proxy = new PipelinedTestPeerProxy(raft_pool_.get());
+  auto peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      FakeRaftPeerPB(kFollowerUuid), kTabletId, kLeaderUuid, PeerProxyPtr(proxy),
+      message_queue_.get(), raft_pool_token_.get(), nullptr /* consensus */, messenger_.get()));
+  auto se = ScopeExit([&peer] {
+    peer->Close();
+  });
+
+  // Replicate the first op without holding responses, so the peer is known to be in sync.
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 1);
+  ASSERT_OK(peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  WaitForMajorityReplicatedIndex(1);
+
+  proxy->HoldResponses();
+  const int kLastIndex = 4;
+  for (int index = 2; index <= kLastIndex; ++index) {
+    AppendReplicateMessagesToQueue(message_queue_.get(), clock_, index, 1);
+    // The signal is ignored while the previous request is still being prepared, so repeat it.
+    ASSERT_OK(WaitFor([&peer, proxy, index] {
+      EXPECT_OK(peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+      return proxy->last_received_index() >= index;
+    }, 10s, Format("Peer received op $0", index)));
+  }
+
+  // All ops were sent before any of them was acknowledged.
+  ASSERT_GE(proxy->num_held_responses(), static_cast<size_t>(kLastIndex - 1));
+  ASSERT_FALSE(consensus_->IsMajorityReplicated(2));
+
+  proxy->RespondInReverseOrder();
+  WaitForMajorityReplicatedIndex(kLastIndex);
+  ASSERT_EQ(proxy->num_ops_received(), kLastIndex);
+}
+
+// Tests that pipelined requests which reach the follower out of order are recovered from: the
+// later requests are rejected, and their ops are sent again once the earlier request is applied.
+TEST_F(ConsensusPeersTest, TestPipelinedRequestsReordered) {
+  FLAGS_consensus_max_inflight_requests_per_peer = 5;
+  // Heartbeats should not take slots of the requests sent by the test.
+  FLAGS_raft_heartbeat_interval_ms = 60000;
+
+  auto proxy = new PipelinedTestPeerProxy(raft_pool_.get());
+  auto peer = ASSERT_RESULT(Peer::NewRemotePeer(
+      FakeRaftPeerPB(kFollowerUuid), kTabletId, kLeaderUuid, PeerProxyPtr(proxy),
+      message_queue_.get(), raft_pool_token_.get(), nullptr /* consensus */, messenger_.get()));
+  auto se = ScopeExit([&peer] {
+    peer->Close();
+  });
+
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 1, 1);
+  ASSERT_OK(peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  WaitForMajorityReplicatedIndex(1);
+
+  proxy->HoldRequests();
+  const int kLastIndex = 4;
+  for (int index = 2; index <= kLastIndex; ++index) {
+    AppendReplicateMessagesToQueue(message_queue_.get(), clock_, index, 1);
+    ASSERT_OK(WaitFor([&peer, proxy, index] {
+      EXPECT_OK(peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+      return proxy->num_held_requests() >= static_cast<size_t>(index - 1);
+    }, 10s, Format("Request with op $0 sent", index)));
+  }
+
+  proxy->ApplyRequestsInReverseOrder();
+  WaitForMajorityReplicatedIndex(kLastIndex);
+  ASSERT_EQ(proxy->last_received_index(), kLastIndex);
+}
+
 TEST_F(ConsensusPeersTest, TestLocalAppendAndRemotePeerDelay) {
   // Create a set of remote peers.
   std::shared_ptr<Peer> remote_peer1;
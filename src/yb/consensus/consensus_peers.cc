@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/strings/substitute.h"
@@ -81,6 +82,14 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_int32(consensus_max_inflight_requests_per_peer, 1,
+             "Maximum number of UpdateConsensus requests that a leader keeps in flight to the same "
+             "peer. With values greater than 1 the leader sends the next batch of operations "
+             "without waiting for the previous one to be acknowledged, which improves replication "
+             "throughput over high latency links.");
+TAG_FLAG(consensus_max_inflight_requests_per_peer, advanced);
+TAG_FLAG(consensus_max_inflight_requests_per_peer, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -112,6 +121,14 @@ using rpc::PeriodicTimer;
 using rpc::RpcController;
 using strings::Substitute;
 
+struct Peer::UpdateRequest {
+  // Id assigned to the request by the queue, used to match the response with the request.
+  int64_t id = PeerMessageQueue::kUnknownRequestId;
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  rpc::RpcController controller;
+};
+
 Peer::Peer(
     const RaftPeerPB& peer_pb, string tablet_id, string leader_uuid, PeerProxyPtr proxy,
     PeerMessageQueue* queue, ThreadPoolToken* raft_pool_token, Consensus* consensus,
@@ -121,14 +138,11 @@ Peer::Peer(
       peer_pb_(peer_pb),
       proxy_(std::move(proxy)),
       queue_(queue),
+      last_committed_index_sent_(kMinimumOpIdIndex),
       raft_pool_token_(raft_pool_token),
       consensus_(consensus),
       messenger_(messenger) {}
 
-void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
-}
-
 Status Peer::Init() {
   std::lock_guard<simple_spinlock> lock(peer_lock_);
   queue_->TrackPeer(peer_pb_.permanent_uuid());
@@ -139,7 +153,7 @@ Status Peer::Init() {
       messenger_,
       [weak_peer]() {
         if (auto p = weak_peer.lock()) {
-          Status s = p->SignalRequest(RequestTriggerMode::kAlwaysSend);
+          Status s = p->DoSignalRequest(RequestTriggerMode::kAlwaysSend, PeriodicHeartbeat::kTrue);
         }
       },
       MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms));
@@ -149,6 +163,11 @@ Status Peer::Init() {
 }
 
 Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
+  return DoSignalRequest(trigger_mode, PeriodicHeartbeat::kFalse);
+}
+
+Status Peer::DoSignalRequest(
+    RequestTriggerMode trigger_mode, PeriodicHeartbeat periodic_heartbeat) {
   // If the peer is currently sending, return Status::OK().
   // If there are new requests in the queue we'll get them on ProcessResponse().
   auto performing_lock = LockPerforming(std::try_to_lock);
@@ -185,7 +204,7 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
     using_thread_pool_.fetch_add(1, std::memory_order_acq_rel);
   }
   auto status = raft_pool_token_->SubmitFunc(
-      std::bind(&Peer::SendNextRequest, shared_from_this(), trigger_mode));
+      std::bind(&Peer::SendNextRequest, shared_from_this(), trigger_mode, periodic_heartbeat));
   using_thread_pool_.fetch_sub(1, std::memory_order_acq_rel);
   if (status.ok()) {
     performing_lock.release();
@@ -193,7 +212,7 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   return status;
 }
 
-void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
+void Peer::SendNextRequest(RequestTriggerMode trigger_mode, PeriodicHeartbeat periodic_heartbeat) {
   auto retain_self = shared_from_this();
   DCHECK(performing_mutex_.is_locked()) << "Cannot send request";
 
@@ -203,24 +222,32 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     return;
   }
 
-  // The peer has no pending request nor is sending: send the request.
+  // The peer is not sending and has a free slot for a request: send the request.
+  auto update = std::make_shared<UpdateRequest>();
+  auto& request = update->request;
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_op_id() ?
-      request_.committed_op_id().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_committed_index_sent_;
   ReplicateMsgsHolder msgs_holder;
   Status s = queue_->RequestForPeer(
-      peer_pb_.permanent_uuid(), &request_, &msgs_holder, &needs_remote_bootstrap,
+      peer_pb_.permanent_uuid(), &request, &msgs_holder, &needs_remote_bootstrap,
       &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_op_id() ?
-      request_.committed_op_id().index() : kMinimumOpIdIndex;
+  int64_t commit_index_after = request.has_committed_op_id() ?
+      request.committed_op_id().index() : kMinimumOpIdIndex;
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(INFO) << "Could not obtain request from queue for peer: " << s;
     return;
   }
 
+  // Requests are pipelined only while the peer accepts them. Otherwise wait for the responses to
+  // the requests in flight, they will trigger the next request.
+  if (num_in_flight_requests_ > 0 &&
+      (needs_remote_bootstrap || !last_exchange_successful || failed_attempts_ > 0)) {
+    return;
+  }
+
   if (PREDICT_FALSE(needs_remote_bootstrap)) {
     Status status;
     if (!FLAGS_TEST_enable_remote_bootstrap) {
@@ -280,13 +307,11 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
   }
 
-  if (request_.tablet_id().empty()) {
-    request_.set_tablet_id(tablet_id_);
-    request_.set_caller_uuid(leader_uuid_);
-    request_.set_dest_uuid(peer_pb_.permanent_uuid());
-  }
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = (request.ops_size() > 0) || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
@@ -301,16 +326,40 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
 
   MAYBE_FAULT(FLAGS_TEST_fault_crash_on_leader_request_fraction);
 
+  // Remember the committed index only when the request is really sent. Otherwise a request that was
+  // dropped above would make the next one look like it carries no new committed index.
+  last_committed_index_sent_ = commit_index_after;
+  update->id = queue_->RegisterInFlightRequest(peer_pb_.permanent_uuid(), request);
+  ++num_in_flight_requests_;
+  // While the limit of requests in flight is reached, performing_mutex_ stays locked, so that
+  // nobody sends requests until a response frees a slot.
+  window_full_ = num_in_flight_requests_ >=
+                 std::max(GetAtomicFlag(&FLAGS_consensus_max_inflight_requests_per_peer), 1);
+  const bool window_full = window_full_;
+
   processing_lock.unlock();
-  performing_lock.release();
+  if (window_full) {
+    performing_lock.release();
+  } else {
+    performing_lock.unlock();
+  }
 
   // We will cleanup ops from request in ProcessResponse, because otherwise there could be race
   // condition. When rest of this function is running in parallel to ProcessResponse.
   msgs_holder.ReleaseOps();
 
-  controller_.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
-  proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, retain_self));
+  // Heartbeats could be batched with heartbeats of other tablets to the same server. Requests that
+  // advance the committed index are sent directly, so followers apply them without a delay.
+  if (periodic_heartbeat && !req_has_ops &&
+      proxy_->BatchHeartbeatAsync(
+          request, &update->response,
+          std::bind(&Peer::ProcessHeartbeatResponse, retain_self, update, _1))) {
+    return;
+  }
+
+  update->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  proxy_->UpdateAsync(&request, trigger_mode, &update->response, &update->controller,
+                      std::bind(&Peer::ProcessResponse, retain_self, update));
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -323,20 +372,41 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
   return lock;
 }
 
-void Peer::ProcessResponse() {
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops().size(), nullptr /* elements */);
+void Peer::ProcessResponse(const UpdateRequestPtr& update) {
+  update->request.mutable_ops()->ExtractSubrange(
+      0, update->request.ops().size(), nullptr /* elements */);
 
-  DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
-  Status status = controller_.status();
-  controller_.Reset();
+  Status status = update->controller.status();
+  update->controller.Reset();
 
-  auto performing_lock = LockPerforming(std::adopt_lock);
+  DoProcessResponse(update, status);
+}
+
+void Peer::ProcessHeartbeatResponse(const UpdateRequestPtr& update, const Status& status) {
+  DoProcessResponse(update, status);
+}
+
+void Peer::DoProcessResponse(const UpdateRequestPtr& update, const Status& status) {
+  std::unique_lock<AtomicTryMutex> performing_lock;
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    DCHECK_GT(num_in_flight_requests_, 0) << "Got a response when nothing was pending";
+    --num_in_flight_requests_;
+    if (window_full_) {
+      // This response frees a slot, so take over performing_mutex_ from the requests in flight.
+      DCHECK(performing_mutex_.is_locked());
+      window_full_ = false;
+      performing_lock = LockPerforming(std::adopt_lock);
+    }
+  }
 
   auto processing_lock = StartProcessingUnlocked();
   if (!processing_lock.owns_lock()) {
     return;
   }
 
+  const auto& response = update->response;
+
   if (!status.ok()) {
     if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
@@ -350,23 +420,23 @@ void Peer::ProcessResponse() {
     return;
   }
 
-  if (response_.has_propagated_hybrid_time()) {
-    queue_->clock()->Update(HybridTime(response_.propagated_hybrid_time()));
+  if (response.has_propagated_hybrid_time()) {
+    queue_->clock()->Update(HybridTime(response.propagated_hybrid_time()));
   }
 
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+                   response.error().ShortDebugString()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
     return;
   }
 
-  auto s = StatusFromResponse(response_);
+  auto s = StatusFromResponse(response);
   if (!s.ok() &&
       tserver::TabletServerError(s) == tserver::TabletServerErrorPB::TABLET_NOT_RUNNING &&
       tablet::RaftGroupStateError(s) == tablet::RaftGroupStatePB::FAILED) {
@@ -379,33 +449,41 @@ void Peer::ProcessResponse() {
         peer_pb_.permanent_uuid(),
         Format("Tablet in peer $0 is in FAILED state, will try to evict peer",
                peer_pb_.permanent_uuid()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
   }
 
   // Response should be either error or status.
-  LOG_IF(DFATAL, response_.has_error() == response_.has_status())
-    << "Invalid response: " << response_.ShortDebugString();
+  LOG_IF(DFATAL, response.has_error() == response.has_status())
+    << "Invalid response: " << response.ShortDebugString();
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
     return;
   }
 
   failed_attempts_ = 0;
-  bool more_pending = queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_);
+  bool more_pending = queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response, update->id);
 
   if (more_pending) {
+    if (!performing_lock.owns_lock()) {
+      // Requests are pipelined and there was a free slot, so another request could be prepared
+      // concurrently. In this case the next response will send the pending ops.
+      performing_lock = LockPerforming(std::try_to_lock);
+      if (!performing_lock.owns_lock()) {
+        return;
+      }
+    }
     processing_lock.unlock();
     performing_lock.release();
-    SendNextRequest(RequestTriggerMode::kAlwaysSend);
+    SendNextRequest(RequestTriggerMode::kAlwaysSend, PeriodicHeartbeat::kFalse);
   }
 }
 
@@ -447,7 +525,9 @@ void Peer::ProcessRemoteBootstrapResponse() {
 }
 
 void Peer::ProcessResponseError(const Status& status) {
-  DCHECK(performing_mutex_.is_locked());
+  // Requests sent after the failed one will not be accepted by the peer, so the next request should
+  // resend all ops that were not acknowledged yet.
+  queue_->AbortInFlightRequests(peer_pb_.permanent_uuid());
   failed_attempts_++;
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Couldn't send request. "
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
@@ -499,8 +579,10 @@ Peer::~Peer() {
   CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr multi_raft_batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      multi_raft_batcher_(std::move(multi_raft_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -512,6 +594,16 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+bool RpcPeerProxy::BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                                       ConsensusResponsePB* response,
+                                       StdStatusCallback callback) {
+  if (!multi_raft_batcher_) {
+    return false;
+  }
+  multi_raft_batcher_->AddRequestToBatch(request, response, std::move(callback));
+  return true;
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -544,13 +636,18 @@ void RpcPeerProxy::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* req
 RpcPeerProxy::~RpcPeerProxy() {}
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(
-    Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from)
-    : messenger_(messenger), proxy_cache_(proxy_cache), from_(std::move(from)) {}
+    Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+    MultiRaftManager* multi_raft_manager)
+    : messenger_(messenger), proxy_cache_(proxy_cache), from_(std::move(from)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  auto multi_raft_batcher = multi_raft_manager_
+      ? multi_raft_manager_->AddOrGetBatcher(hostport) : nullptr;
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(multi_raft_batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
@@ -52,6 +52,7 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/semaphore.h"
 #include "yb/util/status.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 class HostPort;
@@ -118,9 +119,16 @@ namespace consensus {
 //        v                               v
 //  SignalRequest()                    return
 //
+// When consensus_max_inflight_requests_per_peer is greater than 1, requests are pipelined: the
+// peer does not wait for the response to send the next request while the number of requests in
+// flight is below this limit. In this case "processing" above means that a request is being
+// prepared, or that the limit of requests in flight is reached.
 class Peer;
 typedef std::shared_ptr<Peer> PeerPtr;
 
+// Whether a request is triggered by the periodic heartbeater of the peer.
+YB_STRONGLY_TYPED_BOOL(PeriodicHeartbeat);
+
 class Peer : public std::enable_shared_from_this<Peer> {
  public:
   Peer(const RaftPeerPB& peer, std::string tablet_id, std::string leader_uuid,
@@ -151,8 +159,6 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // the ThreadPoolToken.
   void Close();
 
-  void SetTermForTest(int term);
-
   ~Peer();
 
   // Creates a new remote peer and makes the queue track it.'
@@ -173,11 +179,28 @@ class Peer : public std::enable_shared_from_this<Peer> {
   }
 
  private:
-  void SendNextRequest(RequestTriggerMode trigger_mode);
+  // State of an UpdateConsensus request sent to the peer.
+  struct UpdateRequest;
+  typedef std::shared_ptr<UpdateRequest> UpdateRequestPtr;
+
+  // Implementation of SignalRequest, periodic_heartbeat is set when called by heartbeater_.
+  CHECKED_STATUS DoSignalRequest(
+      RequestTriggerMode trigger_mode, PeriodicHeartbeat periodic_heartbeat);
+
+  // Periodic heartbeats that carry neither ops nor a new committed index could be batched with
+  // heartbeats of other tablets, other requests are sent directly.
+  void SendNextRequest(RequestTriggerMode trigger_mode, PeriodicHeartbeat periodic_heartbeat);
 
   // Signals that a response was received from the peer. This method does response handling that
   // requires IO or may block.
-  void ProcessResponse();
+  void ProcessResponse(const UpdateRequestPtr& update);
+
+  // Signals that a response to the heartbeat sent as part of a batch was received.
+  void ProcessHeartbeatResponse(const UpdateRequestPtr& update, const Status& status);
+
+  // Handles the response with the given RPC status, common part of ProcessResponse and
+  // ProcessHeartbeatResponse.
+  void DoProcessResponse(const UpdateRequestPtr& update, const Status& status);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -214,9 +237,9 @@ class Peer : public std::enable_shared_from_this<Peer> {
   PeerMessageQueue* queue_;
   uint64_t failed_attempts_ = 0;
 
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  // Committed op index in the latest consensus update request, used to detect whether the next
+  // request tells the peer anything new.
+  int64_t last_committed_index_sent_;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
@@ -224,8 +247,10 @@ class Peer : public std::enable_shared_from_this<Peer> {
 
   rpc::RpcController controller_;
 
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request outstanding at a time, and to wait for the outstanding requests at Close().
+  // Held while a request is prepared, or while the limit of outstanding requests is reached.  This
+  // is used in order to ensure that we only have a single request outstanding at a time (or up to
+  // consensus_max_inflight_requests_per_peer when requests are pipelined), and to wait for the
+  // outstanding requests at Close().
   AtomicTryMutex performing_mutex_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -246,6 +271,11 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // holding peer_lock_.
   mutable simple_spinlock peer_lock_;
   State state_ = kPeerCreated;
+  // Number of consensus update requests sent to the peer and not answered yet.
+  int num_in_flight_requests_ = 0;
+  // Whether performing_mutex_ is held because the limit of requests in flight was reached. The
+  // response that frees a slot takes over performing_mutex_ in this case.
+  bool window_full_ = false;
   Consensus* consensus_ = nullptr;
   rpc::Messenger* messenger_ = nullptr;
   std::atomic<int> using_thread_pool_{0};
@@ -263,6 +293,15 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a heartbeat, i.e. a request without ops, as part of a batch of heartbeats to the same
+  // server. Returns false if heartbeats to this peer are not batched, in this case the request
+  // should be sent with UpdateAsync.
+  virtual bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                                   ConsensusResponsePB* response,
+                                   StdStatusCallback callback) {
+    return false;
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -313,7 +352,8 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr multi_raft_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -321,6 +361,10 @@ class RpcPeerProxy : public PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  bool BatchHeartbeatAsync(const ConsensusRequestPB& request,
+                           ConsensusResponsePB* response,
+                           StdStatusCallback callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
@@ -346,12 +390,15 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  MultiRaftHeartbeatBatcherPtr multi_raft_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
-  RpcPeerProxyFactory(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from);
+  // multi_raft_manager is optional, when specified heartbeats to the same server are batched.
+  RpcPeerProxyFactory(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+                      MultiRaftManager* multi_raft_manager = nullptr);
 
   PeerProxyPtr NewProxy(const RaftPeerPB& peer_pb) override;
 
@@ -363,6 +410,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   rpc::Messenger* messenger_ = nullptr;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
@@ -346,6 +346,129 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response));
 }
 
+// Tests that a pipelined request continues after the ops that are still in flight, that a stale
+// response arriving out of order does not move the peer back, and that ops which were not
+// acknowledged are sent again after the requests in flight are aborted.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  ASSERT_TRUE(UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId()));
+
+  bool needs_remote_bootstrap;
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 5);
+  ConsensusRequestPB first_request;
+  ReplicateMsgsHolder first_refs;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &first_request, &first_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(first_request.ops_size(), 5);
+  auto first_id = queue_->RegisterInFlightRequest(kPeerUuid, first_request);
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 6, 5);
+  ConsensusRequestPB second_request;
+  ReplicateMsgsHolder second_refs;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &second_request, &second_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(second_request.ops_size(), 5);
+  ASSERT_OPID_EQ(second_request.preceding_id(), first_request.ops(4).id());
+  auto second_id = queue_->RegisterInFlightRequest(kPeerUuid, second_request);
+  WaitForLocalPeerToAckIndex(10);
+
+  // The response to the second request arrives first.
+  SetLastReceivedAndLastCommitted(&response, second_request.ops(4).id());
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, second_id));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), second_request.ops(4).id());
+
+  SetLastReceivedAndLastCommitted(&response, first_request.ops(4).id());
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, first_id));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), second_request.ops(4).id());
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 11, 10);
+  ConsensusRequestPB third_request;
+  ReplicateMsgsHolder third_refs;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &third_request, &third_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(third_request.ops(0).id().index(), 11);
+  queue_->RegisterInFlightRequest(kPeerUuid, third_request);
+
+  // The third request fails, so the next request starts right after the last acknowledged op.
+  queue_->AbortInFlightRequests(kPeerUuid);
+  ConsensusRequestPB retry_request;
+  ReplicateMsgsHolder retry_refs;
+  ASSERT_OK(queue_->RequestForPeer(
+      kPeerUuid, &retry_request, &retry_refs, &needs_remote_bootstrap));
+  ASSERT_EQ(retry_request.ops(0).id().index(), 11);
+}
+
+// Tests that when pipelined requests reach the peer out of order, the rejection of the later
+// request does not abort the earlier one that is still in flight, and only the ops of the rejected
+// request are sent again.
+TEST_F(ConsensusQueueTest, TestPipelinedRequestsReordered) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  ASSERT_TRUE(UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId()));
+
+  bool needs_remote_bootstrap;
+  auto send_request = [this, &needs_remote_bootstrap](
+      ConsensusRequestPB* request, ReplicateMsgsHolder* refs) -> int64_t {
+    EXPECT_OK(queue_->RequestForPeer(kPeerUuid, request, refs, &needs_remote_bootstrap));
+    return queue_->RegisterInFlightRequest(kPeerUuid, *request);
+  };
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 5);
+  ConsensusRequestPB acked_request;
+  ReplicateMsgsHolder acked_refs;
+  auto acked_id = send_request(&acked_request, &acked_refs);
+  ASSERT_EQ(acked_request.ops_size(), 5);
+  SetLastReceivedAndLastCommitted(&response, acked_request.ops(4).id());
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, acked_id));
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 6, 5);
+  ConsensusRequestPB first_request;
+  ReplicateMsgsHolder first_refs;
+  auto first_id = send_request(&first_request, &first_refs);
+  ASSERT_EQ(first_request.ops(0).id().index(), 6);
+
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 11, 5);
+  ConsensusRequestPB second_request;
+  ReplicateMsgsHolder second_refs;
+  auto second_id = send_request(&second_request, &second_refs);
+  ASSERT_EQ(second_request.ops(0).id().index(), 11);
+  WaitForLocalPeerToAckIndex(15);
+
+  // The second request reaches the peer first, so the peer rejects it.
+  response.mutable_status()->Clear();
+  RefuseWithLogPropertyMismatch(&response, acked_request.ops(4).id(), acked_request.ops(4).id());
+  response.mutable_status()->set_last_committed_idx(5);
+  ASSERT_TRUE(queue_->ResponseFromPeer(response.responder_uuid(), response, second_id));
+
+  // The first request is still in flight, so only the ops of the second one are resent.
+  ConsensusRequestPB retry_request;
+  ReplicateMsgsHolder retry_refs;
+  auto retry_id = send_request(&retry_request, &retry_refs);
+  ASSERT_EQ(retry_request.ops(0).id().index(), 11);
+  ASSERT_OPID_EQ(retry_request.preceding_id(), first_request.ops(4).id());
+
+  // A repeated rejection of the dropped request is stale and ignored.
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, second_id));
+
+  response.mutable_status()->Clear();
+  SetLastReceivedAndLastCommitted(&response, first_request.ops(4).id());
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, first_id));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), first_request.ops(4).id());
+
+  SetLastReceivedAndLastCommitted(&response, retry_request.ops(4).id());
+  ASSERT_FALSE(queue_->ResponseFromPeer(response.responder_uuid(), response, retry_id));
+  ASSERT_OPID_EQ(queue_->GetAllReplicatedIndexForTests(), second_request.ops(4).id());
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -161,6 +161,8 @@ METRIC_DEFINE_gauge_int64(tablet, in_progress_ops, "Leader Operations in Progres
 
 const auto kCDCConsumerCheckpointInterval = FLAGS_cdc_checkpoint_opid_interval_ms * 1ms;
 
+constexpr int64_t PeerMessageQueue::kUnknownRequestId;
+
 std::string MajorityReplicatedData::ToString() const {
   return Format(
       "{ op_id: $0 leader_lease_expiration: $1 ht_lease_expiration: $2 num_sst_files: $3 }",
@@ -429,6 +431,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   bool is_new;
   int64_t next_index;
   int64_t to_index;
+  bool pipelined;
   HybridTime propagated_safe_time;
 
   // Should be before now_ht, i.e. not greater than propagated_hybrid_time.
@@ -497,7 +500,14 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
 
     next_index = peer->next_index;
-    if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0) {
+    pipelined = !peer->in_flight_requests.empty();
+    if (pipelined) {
+      // Requests to this peer are pipelined, so continue right after the ops that are already in
+      // flight instead of sending them again.
+      next_index = std::max(next_index, peer->in_flight_requests.back().last_op_index + 1);
+    }
+    if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0 &&
+        !pipelined) {
       // Previous request to peer has not been acked. Reduce number of entries to be sent
       // in this attempt using exponential backoff. Note that to_index is inclusive.
       to_index = next_index + std::max<int64_t>((peer->last_num_messages_sent >> 1) - 1, 0);
@@ -580,7 +590,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
         return STATUS(NotFound, "Peer not tracked.");
       }
 
-      peer->last_num_messages_sent = result->messages.size();
+      if (!pipelined) {
+        peer->last_num_messages_sent = result->messages.size();
+      }
     }
 
     ScopedTrackedConsumption consumption;
@@ -994,6 +1006,34 @@ OpIdPB PeerMessageQueue::OpIdWatermark() {
   return GetWatermark<Policy>();
 }
 
+int64_t PeerMessageQueue::RegisterInFlightRequest(
+    const std::string& uuid, const ConsensusRequestPB& request) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (PREDICT_FALSE(peer == nullptr)) {
+    return kUnknownRequestId;
+  }
+
+  const int64_t last_op_index = request.ops().empty()
+      ? request.preceding_id().index() : request.ops(request.ops_size() - 1).id().index();
+  peer->in_flight_requests.push_back(InFlightRequest {
+    peer->next_request_id++,
+    last_op_index,
+    request.committed_op_id().index(),
+    peer->leader_lease_expiration.last_sent,
+    peer->leader_ht_lease_expiration.last_sent,
+  });
+  return peer->in_flight_requests.back().id;
+}
+
+void PeerMessageQueue::AbortInFlightRequests(const std::string& uuid) {
+  LockGuard lock(queue_lock_);
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, uuid);
+  if (peer) {
+    peer->in_flight_requests.clear();
+  }
+}
+
 void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid) {
   LockGuard l(queue_lock_);
   TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_uuid);
@@ -1002,7 +1042,8 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
 }
 
 bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
-                                        const ConsensusResponsePB& response) {
+                                        const ConsensusResponsePB& response,
+                                        int64_t request_id) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -1020,6 +1061,26 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       return false;
     }
 
+    // The request could be already gone from the in-flight list if the in-flight requests were
+    // aborted because of an error.
+    bool request_found = false;
+    InFlightRequest in_flight_request{};
+    if (request_id != kUnknownRequestId) {
+      auto& in_flight_requests = peer->in_flight_requests;
+      auto it = std::find_if(
+          in_flight_requests.begin(), in_flight_requests.end(),
+          [request_id](const InFlightRequest& request) { return request.id == request_id; });
+      if (it != in_flight_requests.end()) {
+        in_flight_request = *it;
+        in_flight_requests.erase(it);
+        request_found = true;
+      }
+    }
+    // When requests are pipelined, responses could arrive out of order. So a response to anything
+    // but the last sent request could be older than what we already know about the peer.
+    const bool maybe_stale = request_id != kUnknownRequestId &&
+        (!request_found || in_flight_request.id + 1 != peer->next_request_id);
+
     // Remotely bootstrap the peer if the tablet is not found or deleted.
     if (response.has_error()) {
       // We only let special types of errors through to this point from the peer.
@@ -1027,6 +1088,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
           << response.ShortDebugString();
 
       peer->needs_remote_bootstrap = true;
+      peer->in_flight_requests.clear();
       // Since we received a response from the peer, we know it is alive. So we need to update
       // peer->last_successful_communication_time, otherwise, we will remove this peer from the
       // configuration if the remote bootstrap is not completed within
@@ -1050,8 +1112,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     // Application level errors should be handled elsewhere
     DCHECK(!response.has_error());
 
-    // Take a snapshot of the current peer status.
-    TrackedPeer previous = *peer;
+    const bool was_new = peer->is_new;
 
     // Update the peer status based on the response.
     peer->is_new = false;
@@ -1072,7 +1133,53 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       DCHECK(status.has_last_received_current_leader());
       DCHECK(status.has_last_committed_idx());
 
-      peer->last_known_committed_idx = status.last_committed_idx();
+      if (PREDICT_FALSE(status.has_error())) {
+        if (request_id != kUnknownRequestId &&
+            status.error().code() == ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH &&
+            IsOpInLog(yb::OpId::FromPB(status.last_received()))) {
+          // Pipelined requests could be reordered on the way to the peer. Then a request that
+          // arrived before an earlier one is rejected, while the earlier request is still in
+          // flight and fills the gap. Keep the earlier requests, drop the rejected one and the
+          // ones sent after it, since they depend on its ops, and resend after the earlier ones.
+          // A rejection of a request that was already dropped is stale and ignored.
+          auto& in_flight_requests = peer->in_flight_requests;
+          const bool earlier_in_flight =
+              !in_flight_requests.empty() && in_flight_requests.front().id < request_id;
+          if (!request_found || earlier_in_flight) {
+            in_flight_requests.erase(
+                std::remove_if(
+                    in_flight_requests.begin(), in_flight_requests.end(),
+                    [request_id](const InFlightRequest& request) {
+                      return request.id > request_id;
+                    }),
+                in_flight_requests.end());
+            VLOG_WITH_PREFIX_UNLOCKED(1)
+                << "Request " << request_id << " was reordered on the way to peer "
+                << peer->ToString() << ", requests in flight: " << in_flight_requests.size();
+            return request_found;
+          }
+        }
+        // The peer rejected the request, so ops of requests still in flight will be rejected as
+        // well. Resend them starting from the point the peer reports below.
+        peer->in_flight_requests.clear();
+      }
+
+      if (maybe_stale && !status.has_error()) {
+        peer->last_known_committed_idx = std::max(
+            peer->last_known_committed_idx, status.last_committed_idx());
+      } else {
+        peer->last_known_committed_idx = status.last_committed_idx();
+      }
+
+      // A stale successful response should not move the peer back.
+      auto update_last_received = [peer, &status, maybe_stale](const OpIdPB& last_received) {
+        if (maybe_stale && !status.has_error() &&
+            OpIdLessThan(last_received, peer->last_received)) {
+          return;
+        }
+        peer->last_received = last_received;
+        peer->next_index = last_received.index() + 1;
+      };
 
       // If the reported last-received op for the replica is in our local log, then resume sending
       // entries from that point onward. Otherwise, resume after the last op they received from us.
@@ -1082,15 +1189,13 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       bool peer_has_prefix_of_log = IsOpInLog(yb::OpId::FromPB(status.last_received()));
       if (peer_has_prefix_of_log) {
         // If the latest thing in their log is in our log, we are in sync.
-        peer->last_received = status.last_received();
-        peer->next_index = peer->last_received.index() + 1;
+        update_last_received(status.last_received());
 
       } else if (!OpIdEquals(status.last_received_current_leader(), MinimumOpId())) {
         // Their log may have diverged from ours, however we are in the process of replicating our
         // ops to them, so continue doing so. Eventually, we will cause the divergent entry in their
         // log to be overwritten.
-        peer->last_received = status.last_received_current_leader();
-        peer->next_index = peer->last_received.index() + 1;
+        update_last_received(status.last_received_current_leader());
       } else {
         // The peer is divergent and they have not (successfully) received anything from us yet.
         // Start sending from their last committed index.  This logic differs from the Raft spec
@@ -1106,7 +1211,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         switch (status.error().code()) {
           case ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH: {
             DCHECK(status.has_last_received());
-            if (previous.is_new) {
+            if (was_new) {
               // That's currently how we can detect that we able to connect to a peer.
               LOG_WITH_PREFIX_UNLOCKED(INFO) << "Connected to new peer: " << peer->ToString();
             } else {
@@ -1150,9 +1255,16 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     }
 
     // If our log has the next request for the peer or if the peer's committed index is lower than
-    // our own, set 'more_pending' to true.
-    result = log_cache_.HasOpBeenWritten(peer->next_index) ||
-        (peer->last_known_committed_idx < queue_state_.committed_op_id.index());
+    // our own, set 'more_pending' to true. Ops and committed index that are already in flight to
+    // the peer are not pending.
+    int64_t next_index_to_send = peer->next_index;
+    int64_t committed_index_sent = peer->last_known_committed_idx;
+    for (const auto& request : peer->in_flight_requests) {
+      next_index_to_send = std::max(next_index_to_send, request.last_op_index + 1);
+      committed_index_sent = std::max(committed_index_sent, request.committed_index);
+    }
+    result = log_cache_.HasOpBeenWritten(next_index_to_send) ||
+        (committed_index_sent < queue_state_.committed_op_id.index());
 
     mode_copy = queue_state_.mode;
     if (mode_copy == Mode::LEADER) {
@@ -1165,8 +1277,16 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         }
       }
 
-      peer->leader_lease_expiration.OnReplyFromFollower();
-      peer->leader_ht_lease_expiration.OnReplyFromFollower();
+      if (request_id == kUnknownRequestId) {
+        peer->leader_lease_expiration.OnReplyFromFollower();
+        peer->leader_ht_lease_expiration.OnReplyFromFollower();
+      } else if (request_found) {
+        // Only the leases sent in the answered request are confirmed by the peer.
+        peer->leader_lease_expiration.OnReplyFromFollower(
+            in_flight_request.leader_lease_expiration);
+        peer->leader_ht_lease_expiration.OnReplyFromFollower(
+            in_flight_request.leader_ht_lease_expiration);
+      }
 
       majority_replicated.op_id = queue_state_.majority_replicated_op_id;
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
@@ -1510,6 +1630,25 @@ size_t PeerMessageQueue::EvictLogCache(size_t bytes_to_evict) {
   return log_cache_.EvictThroughOp(std::numeric_limits<int64_t>::max(), bytes_to_evict);
 }
 
+size_t PeerMessageQueue::EvictReplicatedToAllLogCache(size_t bytes_to_evict) {
+  int64_t all_replicated_index;
+  {
+    LockGuard lock(queue_lock_);
+    all_replicated_index = queue_state_.all_replicated_op_id.index();
+  }
+  return log_cache_.EvictThroughOp(all_replicated_index, bytes_to_evict);
+}
+
+CoarseTimePoint PeerMessageQueue::LogCacheOldestEntryTime(LogCacheFreeMode mode) {
+  return log_cache_.OldestEntryTime(mode);
+}
+
+size_t PeerMessageQueue::FreeLogCache(
+    LogCacheFreeMode mode, CoarseTimePoint added_before, size_t bytes_to_free,
+    int64_t* compress_budget) {
+  return log_cache_.FreeMemory(mode, added_before, bytes_to_free, compress_budget);
+}
+
 Status PeerMessageQueue::FlushLogIndex() {
   return log_cache_.FlushIndex();
 }
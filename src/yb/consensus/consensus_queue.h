@@ -33,6 +33,7 @@
 #ifndef YB_CONSENSUS_CONSENSUS_QUEUE_H_
 #define YB_CONSENSUS_CONSENSUS_QUEUE_H_
 
+#include <algorithm>
 #include <iosfwd>
 #include <map>
 #include <string>
@@ -98,6 +99,12 @@ struct FollowerWatermark {
     last_received = last_sent;
   }
 
+  // Used when several requests could be in flight, so the reply is not necessarily for the request
+  // that carried last_sent.
+  void OnReplyFromFollower(const Value& sent) {
+    last_received = std::max(last_received, sent);
+  }
+
   std::string ToString() const {
     return Format("{ last_sent: $0 last_received: $1 }", last_sent, last_received);
   }
@@ -112,10 +119,30 @@ struct FollowerWatermark {
 //
 // This class is used only on the LEADER side.
 //
-// TODO Currently this class is able to track one outstanding operation per peer. If we want to have
-// more than one outstanding RPC we need to modify it.
+// Several requests could be outstanding to the same peer when requests are pipelined, in this case
+// the peer should register every request it sends with RegisterInFlightRequest() and pass the
+// returned id to ResponseFromPeer().
 class PeerMessageQueue {
  public:
+  // Used as request id when the response is not matched with a registered in-flight request.
+  static constexpr int64_t kUnknownRequestId = -1;
+
+  // Request that was sent to a peer and was not answered yet.
+  struct InFlightRequest {
+    // Id assigned to the request by RegisterInFlightRequest().
+    int64_t id;
+
+    // Index of the last op sent in the request, or of the preceding op if the request has no ops.
+    int64_t last_op_index;
+
+    // Committed op index sent in the request.
+    int64_t committed_index;
+
+    // Leader leases sent in the request.
+    CoarseTimePoint leader_lease_expiration;
+    MicrosTime leader_ht_lease_expiration;
+  };
+
   struct TrackedPeer {
     explicit TrackedPeer(std::string uuid)
         : uuid(std::move(uuid)),
@@ -181,6 +208,13 @@ class PeerMessageQueue {
 
     uint64_t num_sst_files = 0;
 
+    // Requests sent to this peer that were not answered yet, in the order they were sent. There
+    // could be more than one such request only when requests to the peer are pipelined.
+    std::vector<InFlightRequest> in_flight_requests;
+
+    // Id of the next request registered with RegisterInFlightRequest().
+    int64_t next_request_id = 0;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -286,10 +320,21 @@ class PeerMessageQueue {
   // is alive, even if it may not be fully up and running or able to accept updates.
   void NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid);
 
+  // Registers a request built by RequestForPeer() that is about to be sent to the peer. The next
+  // request for this peer will continue after the ops of this one until it is answered or
+  // AbortInFlightRequests() is called. Returns the id of the request that should be passed to
+  // ResponseFromPeer(), or kUnknownRequestId if the peer is not tracked.
+  int64_t RegisterInFlightRequest(const std::string& uuid, const ConsensusRequestPB& request);
+
+  // Forgets all requests in flight to the peer after a failure, so the next request is sent
+  // starting right after the last op acked by the peer.
+  void AbortInFlightRequests(const std::string& uuid);
+
   // Updates the request queue with the latest response of a peer, returns whether this peer has
-  // more requests pending.
+  // more requests pending. 'request_id' identifies the registered request that the response is for.
   virtual bool ResponseFromPeer(const std::string& peer_uuid,
-                                const ConsensusResponsePB& response);
+                                const ConsensusResponsePB& response,
+                                int64_t request_id = kUnknownRequestId);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -358,6 +403,14 @@ class PeerMessageQueue {
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
 
+  // Evicts operations that were replicated to all peers from the log cache. Such operations could
+  // still be retained in the cache for CDC consumers.
+  size_t EvictReplicatedToAllLogCache(size_t bytes_to_evict);
+
+  CoarseTimePoint LogCacheOldestEntryTime(LogCacheFreeMode mode);
+  size_t FreeLogCache(LogCacheFreeMode mode, CoarseTimePoint added_before, size_t bytes_to_free,
+                      int64_t* compress_budget);
+
   CHECKED_STATUS FlushLogIndex();
 
   CHECKED_STATUS CopyLogTo(const std::string& dest_dir);
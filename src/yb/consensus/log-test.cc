@@ -51,6 +51,7 @@
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_string(log_compression_type);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
@@ -151,6 +152,8 @@ class LogTest : public LogTestBase {
   void DoCorruptionTest(CorruptionType type, CorruptionPosition place,
                         Status expected_status, int expected_entries);
 
+  void TestCompressedSegment(const std::string& compression_type,
+                             LogCompressionTypePB expected_type);
 };
 
 // If we write more than one entry in a batch, we should be able to
@@ -207,6 +210,46 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+void LogTest::TestCompressedSegment(
+    const std::string& compression_type, LogCompressionTypePB expected_type) {
+  FLAGS_log_compression_type = compression_type;
+  BuildLog();
+
+  const int kNumBatches = 20;
+  const std::string kValue(1024, 'x');
+  for (int i = 1; i <= kNumBatches; ++i) {
+    AppendReplicateBatch(MakeOpId(1, i), MakeOpId(1, i), {TupleForAppend(i, i, kValue)});
+  }
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(expected_type, segments[0]->header().compression_type());
+  // Each batch contains a highly compressible value.
+  ASSERT_LT(segments[0]->file_size(), static_cast<int64_t>(kNumBatches * kValue.size() / 2));
+
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(kNumBatches, read_entries.entries.size());
+  for (int i = 0; i < kNumBatches; ++i) {
+    ASSERT_EQ(yb::OpId(1, i + 1), yb::OpId::FromPB(read_entries.entries[i]->replicate().id()));
+  }
+
+  // Read single entry using the index.
+  auto loaded_op = ASSERT_RESULT(log_->GetLogReader()->LookupOpId(kNumBatches / 2));
+  ASSERT_EQ(yb::OpId(1, kNumBatches / 2), loaded_op);
+
+  ASSERT_OK(log_->Close());
+}
+
+TEST_F(LogTest, TestSnappyCompressedSegment) {
+  TestCompressedSegment("snappy", LOG_COMPRESSION_SNAPPY);
+}
+
+TEST_F(LogTest, TestLZ4CompressedSegment) {
+  TestCompressedSegment("lz4", LOG_COMPRESSION_LZ4);
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
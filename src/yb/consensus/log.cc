@@ -162,6 +162,23 @@ static bool ValidateLogsToRetain(const char* flagname, int value) {
 static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
+DEFINE_string(log_compression_type, "none",
+              "Compression of entry batches in newly created log segments: none, snappy or lz4. "
+              "Compressed segments cannot be read by versions that do not support compression.");
+TAG_FLAG(log_compression_type, advanced);
+
+static bool ValidateLogCompressionType(const char* flagname, const std::string& value) {
+  yb::log::LogCompressionTypePB compression_type;
+  if (yb::log::ParseLogCompressionType(value, &compression_type)) {
+    return true;
+  }
+  LOG(ERROR) << strings::Substitute("$0 must be one of none, snappy or lz4, value $1 is invalid",
+                                    flagname, value);
+  return false;
+}
+static bool log_compression_type_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_compression_type, &ValidateLogCompressionType);
+
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
 
 namespace yb {
@@ -1380,6 +1397,11 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  LogCompressionTypePB compression_type = LOG_COMPRESSION_NONE;
+  if (ParseLogCompressionType(FLAGS_log_compression_type, &compression_type) &&
+      compression_type != LOG_COMPRESSION_NONE) {
+    header.set_compression_type(compression_type);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -60,6 +60,7 @@ using std::thread;
 
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
+DECLARE_string(log_cache_compression_type);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -345,6 +346,65 @@ TEST_F(LogCacheTest, TestReplaceMessages) {
             cache_->ToString());
 }
 
+// Test that compressed messages are still served from the cache, and that messages are freed
+// according to the time they were added to the cache.
+TEST_F(LogCacheTest, TestCompressMessages) {
+  FLAGS_log_cache_compression_type = "snappy";
+  const int kNumOps = 5;
+  const int kPayloadSize = 64_KB;
+
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumOps, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  const auto bytes_before = cache_->BytesUsed();
+
+  // Compress only the first op, since it was added earlier than the second one.
+  auto second_op_time = cache_->cache_.find(2)->second.added_time;
+  int64_t compress_budget = std::numeric_limits<int64_t>::max();
+  ASSERT_GT(cache_->FreeMemory(
+      LogCacheFreeMode::kCompress, second_op_time - 1ms, std::numeric_limits<int64_t>::max(),
+      &compress_budget), 0);
+  ASSERT_TRUE(cache_->cache_.find(1)->second.compressed);
+  ASSERT_FALSE(cache_->cache_.find(2)->second.compressed);
+  ASSERT_EQ(second_op_time, cache_->OldestEntryTime(LogCacheFreeMode::kCompress));
+
+  // The budget stops compression after the first op that uses it up.
+  compress_budget = 1;
+  ASSERT_GT(cache_->FreeMemory(
+      LogCacheFreeMode::kCompress, CoarseTimePoint::max(), std::numeric_limits<int64_t>::max(),
+      &compress_budget), 0);
+  ASSERT_LE(compress_budget, 0);
+  ASSERT_TRUE(cache_->cache_.find(2)->second.compressed);
+  ASSERT_FALSE(cache_->cache_.find(3)->second.compressed);
+  ASSERT_EQ(0, cache_->FreeMemory(
+      LogCacheFreeMode::kCompress, CoarseTimePoint::max(), std::numeric_limits<int64_t>::max(),
+      &compress_budget));
+
+  compress_budget = std::numeric_limits<int64_t>::max();
+  ASSERT_GT(cache_->FreeMemory(
+      LogCacheFreeMode::kCompress, CoarseTimePoint::max(), std::numeric_limits<int64_t>::max(),
+      &compress_budget), 0);
+  ASSERT_EQ(CoarseTimePoint::max(), cache_->OldestEntryTime(LogCacheFreeMode::kCompress));
+  ASSERT_EQ(kNumOps, cache_->num_cached_ops());
+  ASSERT_LT(cache_->BytesUsed(), bytes_before / 10);
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumOps, read_result.messages.size());
+  ASSERT_EQ(0, cache_->metrics_.disk_reads->value());
+  for (int i = 0; i != kNumOps; ++i) {
+    const auto& msg = read_result.messages[i];
+    ASSERT_EQ(OpIdStrForIndex(i + 1), OpIdToString(msg->id()));
+    ASSERT_EQ(kPayloadSize, msg->noop_request().payload_for_tests().size());
+  }
+
+  // Evict operations that were added before the third one.
+  auto third_op_time = cache_->cache_.find(3)->second.added_time;
+  ASSERT_GT(cache_->FreeMemory(
+      LogCacheFreeMode::kEvict, third_op_time - 1ms, std::numeric_limits<int64_t>::max(),
+      &compress_budget), 0);
+  ASSERT_EQ(kNumOps - 2, cache_->num_cached_ops());
+  ASSERT_EQ(third_op_time, cache_->OldestEntryTime(LogCacheFreeMode::kEvict));
+}
+
 TEST_F(LogCacheTest, TestMTReadAndWrite) {
   atomic<bool> stop { false };
   bool stopped = false;
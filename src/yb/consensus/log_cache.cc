@@ -43,6 +43,7 @@
 
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_util.h"
 #include "yb/consensus/consensus_util.h"
 
 #include "yb/gutil/bind.h"
@@ -56,6 +57,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
 
 using namespace std::literals;
@@ -72,6 +74,25 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_string(log_cache_compression_type, "none",
+              "Compression used for log cache entries when the server-wide log cache limit is "
+              "reached: none, snappy or lz4. Compressed entries are kept in memory instead of being "
+              "evicted, and are decompressed when sent to followers.");
+TAG_FLAG(log_cache_compression_type, advanced);
+TAG_FLAG(log_cache_compression_type, runtime);
+
+static bool ValidateLogCacheCompressionType(const char* flagname, const std::string& value) {
+  yb::log::LogCompressionTypePB compression_type;
+  if (yb::log::ParseLogCompressionType(value, &compression_type)) {
+    return true;
+  }
+  LOG(ERROR) << strings::Substitute("$0 must be one of none, snappy or lz4, value $1 is invalid",
+                                    flagname, value);
+  return false;
+}
+static bool log_cache_compression_type_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_cache_compression_type, &ValidateLogCacheCompressionType);
+
 DEFINE_test_flag(bool, log_cache_skip_eviction, false,
                  "Don't evict log entries in tests.");
 
@@ -94,6 +115,26 @@ namespace {
 
 const std::string kParentMemTrackerId = "log_cache"s;
 
+log::LogCompressionTypePB LogCacheCompressionType() {
+  log::LogCompressionTypePB result = log::LOG_COMPRESSION_NONE;
+  if (!log::ParseLogCompressionType(FLAGS_log_cache_compression_type, &result)) {
+    return log::LOG_COMPRESSION_NONE;
+  }
+  return result;
+}
+
+}
+
+yb::OpId LogCache::CacheEntry::op_id() const {
+  return msg ? yb::OpId::FromPB(msg->id()) : compressed->op_id;
+}
+
+OperationType LogCache::CacheEntry::op_type() const {
+  return msg ? msg->op_type() : compressed->op_type;
+}
+
+int64_t LogCache::CacheEntry::byte_size() const {
+  return msg ? msg->ByteSize() : compressed->byte_size;
 }
 
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
@@ -153,8 +194,9 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
   PrepareAppendResult result;
   std::vector<CacheEntry> entries_to_insert;
   entries_to_insert.reserve(msgs.size());
+  const auto now = CoarseMonoClock::Now();
   for (const auto& msg : msgs) {
-    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()) };
+    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()), false, now };
     result.mem_required += e.mem_usage;
     entries_to_insert.emplace_back(std::move(e));
   }
@@ -253,7 +295,7 @@ Result<yb::OpId> LogCache::LookupOpId(int64_t op_index) const {
     }
     auto iter = cache_.find(op_index);
     if (iter != cache_.end()) {
-      return yb::OpId::FromPB(iter->second.msg->id());
+      return iter->second.op_id();
     }
   }
 
@@ -263,15 +305,19 @@ Result<yb::OpId> LogCache::LookupOpId(int64_t op_index) const {
 
 namespace {
 
-// Calculate the total byte size that will be used on the wire to replicate this message as part of
-// a consensus update request. This accounts for the length delimiting and tagging of the message.
-int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
-  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
-    msg.ByteSize());
+// Calculate the total byte size that will be used on the wire to replicate a message with the
+// given serialized size as part of a consensus update request. This accounts for the length
+// delimiting and tagging of the message.
+int64_t TotalByteSizeForMessage(int64_t byte_size) {
+  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(byte_size);
   msg_size += 1; // for the type tag
   return msg_size;
 }
 
+int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+  return TotalByteSizeForMessage(msg.ByteSize());
+}
+
 } // anonymous namespace
 
 Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
@@ -291,6 +337,10 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
   ReadOpsResult result;
   result.preceding_op = VERIFY_RESULT(LookupOpId(after_op_index));
 
+  // Compressed messages found in the cache, with their positions in result.messages. They are
+  // decompressed after the lock is released.
+  std::vector<std::pair<size_t, CompressedMsgPtr>> compressed_messages;
+
   std::unique_lock<simple_spinlock> l(lock_);
   int64_t next_index = after_op_index + 1;
   int64_t to_index = to_op_index > 0
@@ -344,24 +394,39 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
         if (to_op_index > 0 && next_index > to_op_index) {
           break;
         }
-        const ReplicateMsgPtr& msg = iter->second.msg;
-        int64_t index = msg->id().index();
+        const CacheEntry& entry = iter->second;
+        int64_t index = iter->first;
         if (index != next_index) {
           continue;
         }
 
-        auto current_message_size = TotalByteSizeForMessage(*msg);
+        auto current_message_size = TotalByteSizeForMessage(entry.byte_size());
         remaining_space -= current_message_size;
         if (remaining_space < 0 && !result.messages.empty()) {
           result.have_more_messages = true;
           break;
         }
 
-        result.messages.push_back(msg);
+        if (entry.compressed) {
+          compressed_messages.emplace_back(result.messages.size(), entry.compressed);
+        }
+        result.messages.push_back(entry.msg);
         next_index++;
       }
     }
   }
+  l.unlock();
+
+  faststring buffer;
+  for (const auto& p : compressed_messages) {
+    const CompressedMsg& compressed = *p.second;
+    RETURN_NOT_OK_PREPEND(
+        log::UncompressEntryBatch(compressed.compression_type, compressed.data, &buffer),
+        Format("Failed to decompress cached op $0", compressed.op_id));
+    auto msg = std::make_shared<ReplicateMsg>();
+    RETURN_NOT_OK(pb_util::ParseFromArray(msg.get(), buffer.data(), buffer.size()));
+    result.messages[p.first] = std::move(msg);
+  }
 
   return result;
 }
@@ -371,7 +436,119 @@ size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
   return EvictSomeUnlocked(index, bytes_to_evict);
 }
 
-size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+CoarseTimePoint LogCache::OldestEntryTime(LogCacheFreeMode mode) const {
+  if (mode == LogCacheFreeMode::kCompress &&
+      LogCacheCompressionType() == log::LOG_COMPRESSION_NONE) {
+    return CoarseTimePoint::max();
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  auto it = NextUnpinnedEntryUnlocked(0, mode == LogCacheFreeMode::kCompress);
+  return it != cache_.end() ? it->second.added_time : CoarseTimePoint::max();
+}
+
+size_t LogCache::FreeMemory(
+    LogCacheFreeMode mode, CoarseTimePoint added_before, int64_t bytes_to_free,
+    int64_t* compress_budget) {
+  switch (mode) {
+    case LogCacheFreeMode::kCompress:
+      return CompressSome(added_before, bytes_to_free, compress_budget);
+    case LogCacheFreeMode::kEvict: {
+      std::lock_guard<simple_spinlock> lock(lock_);
+      return EvictSomeUnlocked(std::numeric_limits<int64_t>::max(), bytes_to_free, added_before);
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(LogCacheFreeMode, mode);
+}
+
+LogCache::MessageCache::const_iterator LogCache::NextUnpinnedEntryUnlocked(
+    int64_t after_index, bool skip_compressed) const {
+  DCHECK(lock_.is_locked());
+  for (auto it = cache_.upper_bound(std::max<int64_t>(after_index, 0)); it != cache_.end(); ++it) {
+    if (static_cast<int64_t>(it->first) >= min_pinned_op_index_) {
+      break;
+    }
+    if (!skip_compressed || !it->second.compressed) {
+      return it;
+    }
+  }
+  return cache_.end();
+}
+
+size_t LogCache::CompressSome(
+    CoarseTimePoint added_before, int64_t bytes_to_free, int64_t* compress_budget) {
+  const auto compression_type = LogCacheCompressionType();
+  if (compression_type == log::LOG_COMPRESSION_NONE) {
+    return 0;
+  }
+
+  int64_t bytes_freed = 0;
+  int64_t last_index = 0;
+  std::string serialized;
+  faststring buffer;
+  while (bytes_freed < bytes_to_free && *compress_budget > 0) {
+    // Pick the next entry under the lock, but compress it without holding the lock.
+    ReplicateMsgPtr msg;
+    int64_t mem_usage;
+    {
+      std::lock_guard<simple_spinlock> lock(lock_);
+      auto it = NextUnpinnedEntryUnlocked(last_index, true /* skip_compressed */);
+      if (it == cache_.end() || it->second.added_time > added_before) {
+        break;
+      }
+      last_index = it->first;
+      msg = it->second.msg;
+      mem_usage = it->second.mem_usage;
+    }
+
+    serialized.clear();
+    if (!msg->AppendToString(&serialized)) {
+      LOG_WITH_PREFIX_UNLOCKED(DFATAL) << "Failed to serialize " << msg->id();
+      break;
+    }
+    *compress_budget -= serialized.size();
+    auto status = log::CompressEntryBatch(compression_type, serialized, &buffer);
+    if (!status.ok()) {
+      LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to compress " << msg->id() << ": " << status;
+      break;
+    }
+    auto compressed = std::make_shared<CompressedMsg>();
+    compressed->op_id = yb::OpId::FromPB(msg->id());
+    compressed->op_type = msg->op_type();
+    compressed->byte_size = serialized.size();
+    compressed->compression_type = compression_type;
+    compressed->data = buffer.ToString();
+    const int64_t compressed_mem_usage = sizeof(CompressedMsg) + compressed->data.capacity();
+    if (compressed_mem_usage >= mem_usage) {
+      // Not worth keeping the compressed version, i.e. the payload is already compressed.
+      continue;
+    }
+
+    std::lock_guard<simple_spinlock> lock(lock_);
+    auto it = cache_.find(last_index);
+    // The entry could have been evicted or replaced while we were not holding the lock.
+    if (it == cache_.end() || it->second.msg != msg) {
+      continue;
+    }
+    CacheEntry& entry = it->second;
+    const int64_t freed = entry.mem_usage - compressed_mem_usage;
+    if (entry.tracked) {
+      tracker_->Release(freed);
+    }
+    metrics_.size->DecrementBy(freed);
+    entry.msg = nullptr;
+    entry.compressed = std::move(compressed);
+    entry.mem_usage = compressed_mem_usage;
+    bytes_freed += freed;
+  }
+
+  VLOG_WITH_PREFIX_UNLOCKED(1) << "Compressed log cache entries, freed "
+                               << HumanReadableNumBytes::ToString(bytes_freed);
+  return bytes_freed;
+}
+
+size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict,
+                                   CoarseTimePoint added_before) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -385,20 +562,20 @@ size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_ev
   int64_t bytes_evicted = 0;
   for (auto iter = cache_.begin(); iter != cache_.end();) {
     const CacheEntry& entry = iter->second;
-    const ReplicateMsgPtr& msg = entry.msg;
-    VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << msg->id();
-    int64_t msg_index = msg->id().index();
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "considering for eviction: " << entry.op_id();
+    int64_t msg_index = iter->first;
     if (msg_index == 0) {
       // Always keep our special '0' op.
       ++iter;
       continue;
     }
 
-    if (msg_index > stop_after_index || msg_index >= min_pinned_op_index_) {
+    if (msg_index > stop_after_index || msg_index >= min_pinned_op_index_ ||
+        entry.added_time > added_before) {
       break;
     }
 
-    VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << entry.op_id();
     AccountForMessageRemovalUnlocked(entry);
     bytes_evicted += entry.mem_usage;
     cache_.erase(iter++);
@@ -473,12 +650,13 @@ void LogCache::DumpToStrings(vector<string>* lines) const {
   lines->push_back(ToStringUnlocked());
   lines->push_back("Messages:");
   for (const auto& entry : cache_) {
-    const ReplicateMsgPtr msg = entry.second.msg;
+    const auto op_id = entry.second.op_id();
     lines->push_back(
-      Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4",
-                 counter++, msg->id().term(), msg->id().index(),
-                 OperationType_Name(msg->op_type()),
-                 msg->ByteSize()));
+      Substitute("Message[$0] $1.$2 : REPLICATE. Type: $3, Size: $4$5",
+                 counter++, op_id.term, op_id.index,
+                 OperationType_Name(entry.second.op_type()),
+                 entry.second.byte_size(),
+                 entry.second.compressed ? ", compressed" : ""));
   }
 }
 
@@ -492,12 +670,14 @@ void LogCache::DumpToHtml(std::ostream& out) const {
 
   int counter = 0;
   for (const auto& entry : cache_) {
-    const ReplicateMsgPtr msg = entry.second.msg;
+    const auto op_id = entry.second.op_id();
     out << Substitute("<tr><th>$0</th><th>$1.$2</th><td>REPLICATE $3</td>"
                       "<td>$4</td><td>$5</td></tr>",
-                      counter++, msg->id().term(), msg->id().index(),
-                      OperationType_Name(msg->op_type()),
-                      msg->ByteSize(), msg->id().ShortDebugString()) << endl;
+                      counter++, op_id.term, op_id.index,
+                      OperationType_Name(entry.second.op_type()),
+                      entry.second.byte_size(),
+                      entry.second.msg ? entry.second.msg->id().ShortDebugString()
+                                       : "compressed") << endl;
   }
   out << "</table>";
 }
@@ -507,25 +687,50 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
     return;
   }
 
-  std::lock_guard<simple_spinlock> lock(lock_);
+  int64_t mem_required = 0;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (const auto& op_id : op_ids) {
+      auto it = cache_.find(op_id.index);
+      if (it != cache_.end() && it->second.op_id().term == op_id.term) {
+        mem_required += it->second.mem_usage;
+      }
+    }
+  }
 
-  int mem_required = 0;
+  if (mem_required == 0) {
+    return;
+  }
+
+  // Try to consume the memory. If it can't be consumed, we may need to evict.
+  // lock_ should not be held here, because exceeding the server-wide limit runs the log cache
+  // garbage collector, which evicts operations from all tablets, including this one.
+  bool consumed = tracker_->TryConsume(mem_required);
+  int64_t spare = 0;
+  if (!consumed) {
+    spare = tracker_->SpareCapacity();
+    tracker_->Consume(mem_required);
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  int64_t mem_tracked = 0;
   for (const auto& op_id : op_ids) {
     auto it = cache_.find(op_id.index);
-    if (it != cache_.end() && it->second.msg->id().term() == op_id.term) {
-      mem_required += it->second.mem_usage;
+    if (it != cache_.end() && it->second.op_id().term == op_id.term) {
+      mem_tracked += it->second.mem_usage;
       it->second.tracked = true;
     }
   }
 
-  if (mem_required == 0) {
-    return;
+  // Operations could be evicted, compressed or replaced while the lock was released.
+  if (mem_tracked < mem_required) {
+    tracker_->Release(mem_required - mem_tracked);
+  } else if (mem_tracked > mem_required) {
+    tracker_->Consume(mem_tracked - mem_required);
   }
 
-  // Try to consume the memory. If it can't be consumed, we may need to evict.
-  if (!tracker_->TryConsume(mem_required)) {
-    int spare = tracker_->SpareCapacity();
-    int need_to_free = mem_required - spare;
+  if (!consumed) {
+    int64_t need_to_free = mem_tracked - spare;
     VLOG_WITH_PREFIX_UNLOCKED(1)
         << "Memory limit would be exceeded trying to append "
         << HumanReadableNumBytes::ToString(mem_required)
@@ -533,10 +738,6 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
         << HumanReadableNumBytes::ToString(spare)
         << "): attempting to evict some operations...";
 
-    tracker_->Consume(mem_required);
-
-    // TODO: we should also try to evict from other tablets - probably better to evict really old
-    // ops from another tablet than evict recent ops from this one.
     EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
   }
 }
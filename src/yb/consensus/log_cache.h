@@ -39,13 +39,16 @@
 
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/log.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/macros.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/enums.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/result.h"
@@ -64,6 +67,13 @@ namespace consensus {
 
 class ReplicateMsg;
 
+// How LogCache::FreeMemory releases memory used by operations.
+YB_DEFINE_ENUM(LogCacheFreeMode,
+    // Keep operations in memory, but store them compressed with log_cache_compression_type.
+    (kCompress)
+    // Remove operations from the cache, so they will be read from disk when needed.
+    (kEvict));
+
 struct ReadOpsResult {
   ReplicateMsgs messages;
   yb::OpId preceding_op;
@@ -138,6 +148,19 @@ class LogCache {
   size_t EvictThroughOp(
       int64_t index, int64_t bytes_to_evict = std::numeric_limits<int64_t>::max());
 
+  // Returns the time when the oldest operation that FreeMemory could release in the given mode was
+  // added to the cache, or CoarseTimePoint::max() if there is no such operation.
+  CoarseTimePoint OldestEntryTime(LogCacheFreeMode mode) const;
+
+  // Compress or evict, depending on 'mode', the oldest operations that were added to the cache not
+  // later than 'added_before', stopping when 'bytes_to_free' bytes have been released.
+  // Operations that are not appended to the log yet are never released.
+  // In kCompress mode, compression also stops when '*compress_budget' is used up. The size of every
+  // compressed operation is subtracted from it, including operations that did not shrink.
+  // Returns the number of released bytes.
+  size_t FreeMemory(LogCacheFreeMode mode, CoarseTimePoint added_before, int64_t bytes_to_free,
+                    int64_t* compress_budget);
+
   // Return the number of bytes of memory currently in use by the cache.
   int64_t BytesUsed() const;
 
@@ -178,10 +201,24 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestCompressMessages);
   friend class LogCacheTest;
 
+  // Serialized and compressed ReplicateMsg, with the fields required without decompressing it.
+  struct CompressedMsg {
+    yb::OpId op_id;
+    OperationType op_type;
+    // Size of the serialized uncompressed message.
+    int64_t byte_size;
+    log::LogCompressionTypePB compression_type;
+    std::string data;
+  };
+
+  typedef std::shared_ptr<const CompressedMsg> CompressedMsgPtr;
+
   // An entry in the cache.
   struct CacheEntry {
+    // Null after the entry was compressed.
     ReplicateMsgPtr msg;
     // The cached value of msg->SpaceUsedLong(). This method is expensive
     // to compute, so we compute it only once upon insertion.
@@ -189,12 +226,34 @@ class LogCache {
 
     // Did we start memory tracking for this entry.
     bool tracked = false;
+
+    // When the entry was added to the cache.
+    CoarseTimePoint added_time;
+
+    // Replaces msg when the entry was compressed.
+    CompressedMsgPtr compressed;
+
+    yb::OpId op_id() const;
+    OperationType op_type() const;
+    int64_t byte_size() const;
   };
 
+  typedef std::map<uint64_t, CacheEntry> MessageCache;
+
   // Try to evict the oldest operations from the queue, stopping either when
-  // 'bytes_to_evict' bytes have been evicted, or the op with index
-  // 'stop_after_index' has been evicted, whichever comes first.
-  size_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // 'bytes_to_evict' bytes have been evicted, the op with index
+  // 'stop_after_index' has been evicted, or the next op was added to the cache
+  // after 'added_before', whichever comes first.
+  size_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict,
+                           CoarseTimePoint added_before = CoarseTimePoint::max());
+
+  size_t CompressSome(
+      CoarseTimePoint added_before, int64_t bytes_to_free, int64_t* compress_budget);
+
+  // Returns the first entry after 'after_index' that is already appended to the log, skipping
+  // compressed entries when 'skip_compressed' is true.
+  MessageCache::const_iterator NextUnpinnedEntryUnlocked(
+      int64_t after_index, bool skip_compressed) const;
 
   // Update metrics and MemTracker to account for the removal of the
   // given message.
@@ -234,7 +293,6 @@ class LogCache {
   // Maps from log index -> ReplicateMsg
   // An ordered map that serves as the buffer for the cached messages.  Maps from log index ->
   // CacheEntry
-  typedef std::map<uint64_t, CacheEntry> MessageCache;
   MessageCache cache_;
 
   // The next log index to append. Each append operation must either start with this log index, or
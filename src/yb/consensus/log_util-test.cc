@@ -14,6 +14,8 @@
 #include <gtest/gtest.h>
 
 #include "yb/consensus/log_util.h"
+#include "yb/util/coding.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/test_macros.h"
 
 namespace yb {
@@ -47,4 +49,25 @@ TEST(TestLogUtil, TestModifyDurableWriteFlagIfNotODirectPositive) {
   FLAGS_durable_wal_write = false;
   ASSERT_OK(log::ModifyDurableWriteFlagIfNotODirect());
 }
+
+TEST(TestLogUtil, TestUncompressEntryBatch) {
+  const std::string data(10000, 'X');
+  for (auto type : {log::LOG_COMPRESSION_SNAPPY, log::LOG_COMPRESSION_LZ4}) {
+    faststring compressed;
+    ASSERT_OK(log::CompressEntryBatch(type, data, &compressed));
+    faststring uncompressed;
+    ASSERT_OK(log::UncompressEntryBatch(
+        type, Slice(compressed.data(), compressed.size()), &uncompressed));
+    ASSERT_EQ(data, uncompressed.ToString());
+
+    // Uncompressed size that could not be parsed is rejected without allocating memory for it.
+    faststring corrupted;
+    PutVarint32(&corrupted, pb_util::kParseFromArrayMaxSize + 1);
+    corrupted.append(compressed.data() + compressed.size() - 10, 10);
+    auto status = log::UncompressEntryBatch(
+        type, Slice(corrupted.data(), corrupted.size()), &uncompressed);
+    ASSERT_TRUE(status.IsCorruption()) << status;
+  }
+}
+
 } // namespace yb
@@ -39,6 +39,8 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
+#include <snappy.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
@@ -48,6 +50,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
+#include "yb/util/cast.h"
 #include "yb/util/coding-inl.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
@@ -693,6 +696,124 @@ Status ReadableLogSegment::MakeCorruptionStatus(
   return status.CloneAndAppend(err);
 }
 
+bool ParseLogCompressionType(const std::string& value, LogCompressionTypePB* compression_type) {
+  if (value == "none") {
+    *compression_type = LOG_COMPRESSION_NONE;
+  } else if (value == "snappy") {
+    *compression_type = LOG_COMPRESSION_SNAPPY;
+  } else if (value == "lz4") {
+    *compression_type = LOG_COMPRESSION_LZ4;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+Status CompressEntryBatch(
+    LogCompressionTypePB compression_type, const Slice& data, faststring* out) {
+  out->clear();
+  PutVarint32(out, data.size());
+  const size_t prefix_size = out->size();
+  switch (compression_type) {
+    case LOG_COMPRESSION_SNAPPY: {
+      out->resize(prefix_size + snappy::MaxCompressedLength(data.size()));
+      size_t compressed_size = 0;
+      snappy::RawCompress(
+          data.cdata(), data.size(), util::to_char_ptr(out->data() + prefix_size),
+          &compressed_size);
+      out->resize(prefix_size + compressed_size);
+      return Status::OK();
+    }
+    case LOG_COMPRESSION_LZ4: {
+      const int bound = LZ4_compressBound(static_cast<int>(data.size()));
+      out->resize(prefix_size + bound);
+      const int compressed_size = LZ4_compress_default(
+          data.cdata(), util::to_char_ptr(out->data() + prefix_size), static_cast<int>(data.size()),
+          bound);
+      if (compressed_size <= 0) {
+        return STATUS_FORMAT(RuntimeError, "LZ4 compression of $0 bytes failed", data.size());
+      }
+      out->resize(prefix_size + compressed_size);
+      return Status::OK();
+    }
+    case LOG_COMPRESSION_NONE:
+      break;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unexpected log compression type: $0", compression_type);
+}
+
+namespace {
+
+// Decodes the uncompressed size prefix of data produced by CompressEntryBatch and removes it from
+// data. Uncompressed entry batches are parsed with pb_util::ParseFromArray, so bigger size could
+// only be read from a corrupted entry, and is rejected before memory is allocated for it.
+Result<uint32_t> DecodeUncompressedSize(Slice* data) {
+  uint32_t uncompressed_size = 0;
+  if (!GetVarint32(data, &uncompressed_size)) {
+    return STATUS(Corruption, "Could not decode uncompressed size of entry batch");
+  }
+  if (uncompressed_size > pb_util::kParseFromArrayMaxSize) {
+    return STATUS_FORMAT(Corruption, "Too big uncompressed size of entry batch: $0",
+                         uncompressed_size);
+  }
+  return uncompressed_size;
+}
+
+// Uncompresses data without the size prefix to uncompressed_size bytes at out.
+Status UncompressEntryBatchData(
+    LogCompressionTypePB compression_type, const Slice& data, uint32_t uncompressed_size,
+    uint8_t* out) {
+  switch (compression_type) {
+    case LOG_COMPRESSION_SNAPPY: {
+      size_t size = 0;
+      if (!snappy::GetUncompressedLength(data.cdata(), data.size(), &size) ||
+          size != uncompressed_size ||
+          !snappy::RawUncompress(data.cdata(), data.size(), util::to_char_ptr(out))) {
+        return STATUS_FORMAT(
+            Corruption, "Snappy decompression of $0 bytes failed", data.size());
+      }
+      return Status::OK();
+    }
+    case LOG_COMPRESSION_LZ4: {
+      const int size = LZ4_decompress_safe(
+          data.cdata(), util::to_char_ptr(out), static_cast<int>(data.size()),
+          static_cast<int>(uncompressed_size));
+      if (size < 0 || static_cast<uint32_t>(size) != uncompressed_size) {
+        return STATUS_FORMAT(Corruption, "LZ4 decompression of $0 bytes failed", data.size());
+      }
+      return Status::OK();
+    }
+    case LOG_COMPRESSION_NONE:
+      break;
+  }
+  return STATUS_FORMAT(Corruption, "Unexpected log compression type: $0", compression_type);
+}
+
+// Uncompresses data stored in buffer by CompressEntryBatch, and appends the result to buffer.
+// Returns the appended data.
+Result<Slice> UncompressEntryBatchAppend(
+    LogCompressionTypePB compression_type, faststring* buffer) {
+  const size_t compressed_size = buffer->size();
+  Slice compressed(buffer->data(), compressed_size);
+  const uint32_t uncompressed_size = VERIFY_RESULT(DecodeUncompressedSize(&compressed));
+  const size_t prefix_size = compressed_size - compressed.size();
+  buffer->resize(compressed_size + uncompressed_size);
+  RETURN_NOT_OK(UncompressEntryBatchData(
+      compression_type, Slice(buffer->data() + prefix_size, compressed_size - prefix_size),
+      uncompressed_size, buffer->data() + compressed_size));
+  return Slice(buffer->data() + compressed_size, uncompressed_size);
+}
+
+} // namespace
+
+Status UncompressEntryBatch(
+    LogCompressionTypePB compression_type, Slice data, faststring* out) {
+  const uint32_t uncompressed_size = VERIFY_RESULT(DecodeUncompressedSize(&data));
+  out->clear();
+  out->resize(uncompressed_size);
+  return UncompressEntryBatchData(compression_type, data, uncompressed_size, out->data());
+}
+
 Status ReadableLogSegment::ReadEntryHeaderAndBatch(int64_t* offset, faststring* tmp_buf,
                                                    LogEntryBatchPB* batch) {
   EntryHeader header;
@@ -774,15 +895,31 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  const int64_t next_offset = *offset + entry_batch_slice.size();
+
+  if (header_.compression_type() != LOG_COMPRESSION_NONE) {
+    // The entry is uncompressed into tmp_buf after the compressed data, so the buffer that the
+    // caller reuses for all entries it reads holds both.
+    if (entry_batch_slice.data() != tmp_buf->data()) {
+      memcpy(tmp_buf->data(), entry_batch_slice.data(), entry_batch_slice.size());
+    }
+    tmp_buf->resize(entry_batch_slice.size());
+    auto uncompressed = UncompressEntryBatchAppend(header_.compression_type(), tmp_buf);
+    RETURN_NOT_OK_PREPEND(
+        uncompressed,
+        Format("Could not uncompress entry in byte range $0-$1", *offset, next_offset));
+    entry_batch_slice = *uncompressed;
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
                               entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_slice.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
 
-  *offset += entry_batch_slice.size();
+  *offset = next_offset;
   entry_batch->Swap(&read_entry_batch);
   return Status::OK();
 }
@@ -848,11 +985,17 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  Slice data = entry_batch_data;
+  if (header_.compression_type() != LOG_COMPRESSION_NONE) {
+    RETURN_NOT_OK(CompressEntryBatch(header_.compression_type(), data, &compression_buffer_));
+    data = Slice(compression_buffer_.data(), compression_buffer_.size());
+  }
+
   // First encode the length of the message.
   uint32_t len = data.size();
   InlineEncodeFixed32(&header_buf[0], len);
@@ -48,6 +48,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
@@ -459,6 +460,9 @@ class WritableLogSegment {
 
   bool is_footer_written_;
 
+  // Buffer for the compressed entry batch, reused between writes.
+  faststring compression_buffer_;
+
   LogSegmentHeaderPB header_;
 
   LogSegmentFooterPB footer_;
@@ -489,6 +493,19 @@ CHECKED_STATUS CheckRelevantPathsAreODirectWritable();
 // Modify durable wal write flag depending on the value of FLAGS_require_durable_wal_write.
 CHECKED_STATUS ModifyDurableWriteFlagIfNotODirect();
 
+// Parses compression type name (none, snappy or lz4) as used by compression related flags.
+// Returns false if the name is unknown.
+bool ParseLogCompressionType(const std::string& value, LogCompressionTypePB* compression_type);
+
+// Stores 'data' compressed with 'compression_type' to 'out', prefixed with the varint-encoded
+// size of the uncompressed data.
+CHECKED_STATUS CompressEntryBatch(
+    LogCompressionTypePB compression_type, const Slice& data, faststring* out);
+
+// Reverses CompressEntryBatch.
+CHECKED_STATUS UncompressEntryBatch(
+    LogCompressionTypePB compression_type, Slice data, faststring* out);
+
 }  // namespace log
 }  // namespace yb
 
@@ -0,0 +1,194 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+
+using namespace std::literals;
+
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "Whether heartbeats that Raft leaders send to the same tablet server should be sent "
+            "as a single RPC. Should only be enabled when all tablet servers support "
+            "MultiRaftUpdateConsensus.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+
+DEFINE_int32(multi_raft_heartbeat_batch_window_ms, 50,
+             "Maximum amount of time a heartbeat waits for other heartbeats to the same tablet "
+             "server before the batch is sent.");
+TAG_FLAG(multi_raft_heartbeat_batch_window_ms, advanced);
+
+DEFINE_int32(multi_raft_batch_size, 512,
+             "Maximum number of heartbeats sent to a tablet server in a single RPC.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+
+DEFINE_test_flag(bool, multi_raft_batch_skip_last_request, false,
+                 "Omit the last request of a heartbeat batch from the RPC, so the response does "
+                 "not match the batch.");
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+struct MultiRaftHeartbeatBatcher::Batch {
+  struct Entry {
+    ConsensusResponsePB* response;
+    StdStatusCallback callback;
+  };
+
+  MultiRaftConsensusRequestPB request;
+  MultiRaftConsensusResponsePB response;
+  std::vector<Entry> entries;
+  rpc::RpcController controller;
+};
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    rpc::Messenger* messenger, ConsensusServiceProxyPtr proxy)
+    : messenger_(messenger), proxy_(std::move(proxy)) {}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  BatchPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch = std::move(current_batch_);
+  }
+  if (batch) {
+    auto status = STATUS(Aborted, "Heartbeat batcher destroyed");
+    for (auto& entry : batch->entries) {
+      entry.callback(status);
+    }
+  }
+}
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(
+    const ConsensusRequestPB& request, ConsensusResponsePB* response,
+    StdStatusCallback callback) {
+  BatchPtr full_batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<Batch>();
+      std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+      std::weak_ptr<Batch> weak_batch = current_batch_;
+      messenger_->scheduler().Schedule(
+          [weak_self, weak_batch](const Status& status) {
+            if (auto self = weak_self.lock()) {
+              self->FlushBatch(weak_batch, status);
+            }
+          },
+          FLAGS_multi_raft_heartbeat_batch_window_ms * 1ms);
+    }
+    current_batch_->request.add_consensus_request()->CopyFrom(request);
+    current_batch_->entries.push_back({response, std::move(callback)});
+    if (current_batch_->entries.size() >= static_cast<size_t>(FLAGS_multi_raft_batch_size)) {
+      full_batch = std::move(current_batch_);
+    }
+  }
+  if (full_batch) {
+    SendBatch(full_batch);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FlushBatch(
+    const std::weak_ptr<Batch>& weak_batch, const Status& status) {
+  BatchPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The batch could have been already sent because it became full.
+    if (!current_batch_ || current_batch_ != weak_batch.lock()) {
+      return;
+    }
+    batch = std::move(current_batch_);
+  }
+  if (!status.ok()) {
+    for (auto& entry : batch->entries) {
+      entry.callback(status);
+    }
+    return;
+  }
+  SendBatch(batch);
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(const BatchPtr& batch) {
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  batch->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  if (PREDICT_FALSE(FLAGS_TEST_multi_raft_batch_skip_last_request)) {
+    batch->request.mutable_consensus_request()->RemoveLast();
+  }
+  proxy_->MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller, [batch] {
+    ProcessBatchResponse(batch);
+  });
+}
+
+void MultiRaftHeartbeatBatcher::ProcessBatchResponse(const BatchPtr& batch) {
+  auto status = batch->controller.status();
+  if (status.ok() &&
+      static_cast<size_t>(batch->response.consensus_response_size()) != batch->entries.size()) {
+    status = STATUS_FORMAT(
+        IllegalState, "Wrong number of responses in heartbeat batch: $0, expected: $1",
+        batch->response.consensus_response_size(), batch->entries.size());
+  }
+  for (size_t i = 0; i != batch->entries.size(); ++i) {
+    auto& entry = batch->entries[i];
+    if (status.ok()) {
+      entry.response->Swap(batch->response.mutable_consensus_response(i));
+    }
+    entry.callback(status);
+  }
+}
+
+MultiRaftManager::MultiRaftManager(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache)
+    : messenger_(messenger), proxy_cache_(proxy_cache) {}
+
+MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const HostPort& hostport) {
+  if (!FLAGS_enable_multi_raft_heartbeat_batcher) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = batchers_.find(hostport);
+  if (it != batchers_.end()) {
+    auto batcher = it->second.lock();
+    if (batcher) {
+      return batcher;
+    }
+  }
+
+  // Drop entries of servers that this server does not send heartbeats to anymore, so the map does
+  // not grow with every server ever seen.
+  for (auto i = batchers_.begin(); i != batchers_.end();) {
+    if (i->second.expired()) {
+      i = batchers_.erase(i);
+    } else {
+      ++i;
+    }
+  }
+
+  auto batcher = std::make_shared<MultiRaftHeartbeatBatcher>(
+      messenger_, std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport));
+  batchers_[hostport] = batcher;
+  return batcher;
+}
+
+} // namespace consensus
+} // namespace yb
@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/consensus.pb.h"
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/net/net_util.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+namespace consensus {
+
+// Collects heartbeats, i.e. consensus requests without ops, that leaders of different tablets send
+// to the same tablet server, and sends them as a single MultiRaftUpdateConsensus RPC.
+//
+// The first heartbeat added to an empty batch schedules sending of the batch after
+// multi_raft_heartbeat_batch_window_ms. The batch is sent right away when it reaches
+// multi_raft_batch_size heartbeats.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(rpc::Messenger* messenger, ConsensusServiceProxyPtr proxy);
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds a copy of request to the current batch. When the batch RPC completes, the response for
+  // this request is stored to response and callback is invoked with the status of the RPC.
+  void AddRequestToBatch(
+      const ConsensusRequestPB& request, ConsensusResponsePB* response,
+      StdStatusCallback callback);
+
+ private:
+  struct Batch;
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  void FlushBatch(const std::weak_ptr<Batch>& weak_batch, const Status& status);
+
+  void SendBatch(const BatchPtr& batch);
+
+  static void ProcessBatchResponse(const BatchPtr& batch);
+
+  rpc::Messenger* const messenger_;
+  const ConsensusServiceProxyPtr proxy_;
+
+  std::mutex mutex_;
+  BatchPtr current_batch_;
+};
+
+// Keeps heartbeat batchers for all tablet servers that this server sends heartbeats to.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache);
+
+  // Returns the batcher for heartbeats sent to the given host port, creating it if necessary.
+  // Returns nullptr when heartbeat batching is disabled.
+  MultiRaftHeartbeatBatcherPtr AddOrGetBatcher(const HostPort& hostport);
+
+ private:
+  rpc::Messenger* const messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  std::mutex mutex_;
+  // Batchers are owned by the peer proxies that use them. Expired entries are removed when a new
+  // batcher is created.
+  std::unordered_map<HostPort, std::weak_ptr<MultiRaftHeartbeatBatcher>, HostPortHash> batchers_;
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
@@ -109,8 +109,9 @@ class MockQueue : public PeerMessageQueue {
                                       bool* needs_remote_bootstrap,
                                       RaftPeerPB::MemberType* member_type,
                                       bool* last_exchange_successful));
-  MOCK_METHOD2(ResponseFromPeer, bool(const std::string& peer_uuid,
-                                      const ConsensusResponsePB& response));
+  MOCK_METHOD3(ResponseFromPeer, bool(const std::string& peer_uuid,
+                                      const ConsensusResponsePB& response,
+                                      int64_t request_id));
   MOCK_METHOD0(Close, void());
 };
 
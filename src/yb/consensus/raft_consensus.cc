@@ -255,9 +255,10 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     TableType table_type,
     ThreadPool* raft_pool,
     RetryableRequests* retryable_requests,
-    const yb::OpId& split_op_id) {
+    const yb::OpId& split_op_id,
+    MultiRaftManager* multi_raft_manager) {
   auto rpc_factory = std::make_unique<RpcPeerProxyFactory>(
-      messenger, proxy_cache, local_peer_pb.cloud_info());
+      messenger, proxy_cache, local_peer_pb.cloud_info(), multi_raft_manager);
 
   // The message queue that keeps track of which operations need to be replicated
   // where.
@@ -3098,6 +3099,20 @@ size_t RaftConsensus::EvictLogCache(size_t bytes_to_evict) {
   return queue_->EvictLogCache(bytes_to_evict);
 }
 
+size_t RaftConsensus::EvictReplicatedToAllLogCache(size_t bytes_to_evict) {
+  return queue_->EvictReplicatedToAllLogCache(bytes_to_evict);
+}
+
+CoarseTimePoint RaftConsensus::LogCacheOldestEntryTime(LogCacheFreeMode mode) {
+  return queue_->LogCacheOldestEntryTime(mode);
+}
+
+size_t RaftConsensus::FreeLogCache(
+    LogCacheFreeMode mode, CoarseTimePoint added_before, size_t bytes_to_free,
+    int64_t* compress_budget) {
+  return queue_->FreeLogCache(mode, added_before, bytes_to_free, compress_budget);
+}
+
 Status RaftConsensus::CopyLogTo(const std::string& dest_dir) {
   return queue_->CopyLogTo(dest_dir);
 }
@@ -112,7 +112,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     TableType table_type,
     ThreadPool* raft_pool,
     RetryableRequests* retryable_requests,
-    const yb::OpId& split_op_id);
+    const yb::OpId& split_op_id,
+    MultiRaftManager* multi_raft_manager = nullptr);
 
   // Creates RaftConsensus.
   // split_op_id is the ID of split tablet Raft operation requesting split of this tablet or unset.
@@ -231,6 +232,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   size_t LogCacheSize();
   size_t EvictLogCache(size_t bytes_to_evict);
+  size_t EvictReplicatedToAllLogCache(size_t bytes_to_evict);
+  CoarseTimePoint LogCacheOldestEntryTime(LogCacheFreeMode mode);
+  size_t FreeLogCache(LogCacheFreeMode mode, CoarseTimePoint added_before, size_t bytes_to_free,
+                      int64_t* compress_budget);
 
   CHECKED_STATUS FlushLogIndex();
 
@@ -922,6 +922,11 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         if (update_indexes_) {
           RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
         }
+      } else if (IsRangeOperation(request_, *schema_) && CanUsePartitionTombstone()) {
+        // The whole hash partition is deleted, so a single tombstone covers all its rows.
+        RETURN_NOT_OK(data.doc_write_batch->DeleteHashPartition(
+            encoded_hashed_doc_key_.as_slice(), data.read_time, data.deadline,
+            request_.query_id()));
       } else if (IsRangeOperation(request_, *schema_)) {
         // If the range columns are not specified, we read everything and delete all rows for
         // which the where condition matches.
@@ -994,6 +999,21 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
   return Status::OK();
 }
 
+bool QLWriteOperation::CanUsePartitionTombstone() const {
+  // Static columns are not deleted by range deletes, while partition tombstone would delete them.
+  // Transactional writes, secondary indexes and user timestamps require to handle rows one by one.
+  // Writing them is a table property rather than a tserver flag, so that every replica agrees on
+  // it. Reads always check partition tombstones, see DocRowwiseIterator.
+  return schema_->table_properties().use_partition_tombstones() &&
+         schema_->num_hash_key_columns() > 0 &&
+         !schema_->has_statics() &&
+         !request_.has_where_expr() &&
+         !request_.has_user_timestamp_usec() &&
+         !update_indexes_ &&
+         !txn_op_context_ &&
+         encoded_hashed_doc_key_;
+}
+
 Status QLWriteOperation::DeleteRow(const DocPath& row_path, DocWriteBatch* doc_write_batch,
                                    const ReadHybridTime& read_ht, const CoarseTimePoint deadline) {
   if (request_.has_user_timestamp_usec()) {
@@ -129,6 +129,9 @@ class QLWriteOperation :
       IntentAwareIterator* iter, const SubDocKey& sub_doc_key,
       HybridTime min_hybrid_time);
 
+  // Whether a range delete could delete the whole hash partition with a partition tombstone.
+  bool CanUsePartitionTombstone() const;
+
   CHECKED_STATUS DeleteRow(const DocPath& row_path, DocWriteBatch* doc_write_batch,
                            const ReadHybridTime& read_ht, CoarseTimePoint deadline);
 
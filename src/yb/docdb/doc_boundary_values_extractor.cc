@@ -17,6 +17,11 @@
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+
+#include "yb/gutil/endian.h"
+
+#include "yb/server/hybrid_clock.h"
 
 namespace yb {
 namespace docdb {
@@ -27,9 +32,12 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
                          size_t index,
                          PrimitiveValue* out);
 
+Status GetMaxValueExpiration(const rocksdb::UserBoundaryValues& values, HybridTime* out);
+
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+constexpr rocksdb::UserBoundaryTag kValueExpirationTag = 2;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +88,65 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores the time when an entry expires according to its own
+// TTL. It is HybridTime::kMin for entries that use the table TTL, and HybridTime::kMax for
+// entries that never expire, including tombstones, since they hide older entries.
+class ValueExpirationValue : public rocksdb::UserBoundaryValue {
+ public:
+  explicit ValueExpirationValue(HybridTime expiration) {
+    BigEndian::Store64(buffer_, expiration.ToUint64());
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_FORMAT(Corruption, "Wrong size of encoded expiration: $0", data.size());
+    }
+
+    *value = std::make_shared<ValueExpirationValue>(HybridTime(BigEndian::Load64(data.data())));
+    return Status::OK();
+  }
+
+  // Computes expiration of the entry with the specified hybrid time and encoded value.
+  static HybridTime EntryExpiration(const DocHybridTime& doc_ht, Slice value_slice) {
+    Value value;
+    if (!value.DecodeControlFields(&value_slice).ok() ||
+        value_slice.FirstByteOr(ValueTypeAsChar::kInvalid) == ValueTypeAsChar::kTombstone) {
+      return HybridTime::kMax;
+    }
+    const auto& ttl = value.ttl();
+    if (ttl.Equals(Value::kMaxTtl)) {
+      return HybridTime::kMin;
+    }
+    if (ttl.Equals(Value::kResetTtl) || ttl.IsNegative()) {
+      return HybridTime::kMax;
+    }
+    return server::HybridClock::AddPhysicalTimeToHybridTime(doc_ht.hybrid_time(), ttl);
+  }
+
+  virtual ~ValueExpirationValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kValueExpirationTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ValueExpirationValue*>(&pre_rhs);
+    return value().CompareTo(rhs->value());
+  }
+
+  HybridTime value() const {
+    return HybridTime(BigEndian::Load64(buffer_));
+  }
+
+ private:
+  uint8_t buffer_[sizeof(uint64_t)];
+};
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -138,6 +205,11 @@ class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
 
 class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
  public:
+  // Value expiration is extracted only when track_value_expiration is set, since versions that
+  // don't know kValueExpirationTag could not load a MANIFEST that refers to files with it.
+  explicit DocBoundaryValuesExtractor(bool track_value_expiration)
+      : track_value_expiration_(track_value_expiration) {}
+
   virtual ~DocBoundaryValuesExtractor() {}
 
   Status Decode(rocksdb::UserBoundaryTag tag,
@@ -147,6 +219,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kValueExpirationTag) {
+      return ValueExpirationValue::Create(data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -177,6 +252,13 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
 
+    if (track_value_expiration_) {
+      DocHybridTime doc_ht;
+      RETURN_NOT_OK(doc_ht.FullyDecodeFrom(slices.back()));
+      values->push_back(std::make_shared<ValueExpirationValue>(
+          ValueExpirationValue::EntryExpiration(doc_ht, value)));
+    }
+
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
       values->push_back(std::move(temp));
@@ -221,14 +303,20 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
 #endif
     return true;
   }
+
+ private:
+  const bool track_value_expiration_;
 };
 
 } // namespace
 
-std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance() {
+std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance(
+    bool track_value_expiration) {
   static std::shared_ptr<rocksdb::BoundaryValuesExtractor> instance =
-      std::make_shared<DocBoundaryValuesExtractor>();
-  return instance;
+      std::make_shared<DocBoundaryValuesExtractor>(/* track_value_expiration= */ false);
+  static std::shared_ptr<rocksdb::BoundaryValuesExtractor> tracking_instance =
+      std::make_shared<DocBoundaryValuesExtractor>(/* track_value_expiration= */ true);
+  return track_value_expiration ? tracking_instance : instance;
 }
 
 // Used in tests
@@ -252,6 +340,15 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+Status GetMaxValueExpiration(const rocksdb::UserBoundaryValues& values, HybridTime* out) {
+  auto value = rocksdb::UserValueWithTag(values, kValueExpirationTag);
+  if (!value) {
+    return STATUS(NotFound, "Not found value for expiration");
+  }
+  *out = down_cast<ValueExpirationValue*>(value.get())->value();
+  return Status::OK();
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
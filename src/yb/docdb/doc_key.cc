@@ -1075,6 +1075,24 @@ DocDbAwareV2FilterPolicy::GetKeyTransformer() const {
   return &DocKeyComponentsExtractor<DocKeyPart::kUpToHashOrFirstRange>::GetInstance();
 }
 
+rocksdb::Slice DocKeyPrefixExtractor::Transform(const rocksdb::Slice& src) const {
+  auto size_result = DocKey::EncodedSize(src, DocKeyPart::kWholeDocKey);
+  return size_result.ok() ? rocksdb::Slice(src.data(), *size_result) : rocksdb::Slice();
+}
+
+bool DocKeyPrefixExtractor::InDomain(const rocksdb::Slice& src) const {
+  return DocKey::EncodedSize(src, DocKeyPart::kWholeDocKey).ok();
+}
+
+bool DocKeyPrefixExtractor::InRange(const rocksdb::Slice& dst) const {
+  auto size_result = DocKey::EncodedSize(dst, DocKeyPart::kWholeDocKey);
+  return size_result.ok() && *size_result == dst.size();
+}
+
+bool DocKeyPrefixExtractor::SameResultWhenAppended(const rocksdb::Slice& prefix) const {
+  return InRange(prefix);
+}
+
 DocKeyEncoderAfterTableIdStep DocKeyEncoder::CotableId(const Uuid& cotable_id) {
   if (!cotable_id.IsNil()) {
     std::string bytes;
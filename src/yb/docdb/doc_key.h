@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/filter_policy.h"
+#include "yb/rocksdb/slice_transform.h"
 
 #include "yb/common/schema.h"
 
@@ -876,6 +877,22 @@ class DocDbAwareV2FilterPolicy : public DocDbAwareFilterPolicyBase {
   const KeyTransformer* GetKeyTransformer() const override;
 };
 
+// Extracts the encoded DocKey from RocksDB keys, returns empty prefix for keys that do not start
+// with a DocKey. Used as the key prefix of the hash index of data blocks, so seeks to a document
+// within a data block do not binary search all restart points of the block.
+class DocKeyPrefixExtractor : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "DocKeyPrefixExtractor"; }
+
+  rocksdb::Slice Transform(const rocksdb::Slice& src) const override;
+
+  bool InDomain(const rocksdb::Slice& src) const override;
+
+  bool InRange(const rocksdb::Slice& dst) const override;
+
+  bool SameResultWhenAppended(const rocksdb::Slice& prefix) const override;
+};
+
 // Optional inclusive lower bound and exclusive upper bound for keys served by DocDB.
 // Could be used to split tablet without doing actual splitting of RocksDB files.
 // DocDBCompactionFilter also respects these bounds, so it will filter out non-relevant keys
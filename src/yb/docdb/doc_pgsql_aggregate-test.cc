@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <cmath>
+
+#include "yb/common/ql_value.h"
+
+#include "yb/docdb/doc_expr.h"
+#include "yb/docdb/doc_pgsql_aggregate.h"
+
+#include "yb/util/bfpg/tserver_opcodes.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr ColumnIdRep kIntColumn = 10;
+constexpr ColumnIdRep kDoubleColumn = 11;
+constexpr ColumnIdRep kFloatColumn = 12;
+
+void AddAggregate(bfpg::TSOpcode opcode, ColumnIdRep column_id,
+                  google::protobuf::RepeatedPtrField<PgsqlExpressionPB>* targets) {
+  auto* tscall = targets->Add()->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(opcode));
+  tscall->add_operands()->set_column_id(column_id);
+}
+
+void AddCountStar(google::protobuf::RepeatedPtrField<PgsqlExpressionPB>* targets) {
+  auto* tscall = targets->Add()->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(bfpg::TSOpcode::kCount));
+  tscall->add_operands()->mutable_value()->set_int64_value(0);
+}
+
+class PgsqlVectorAggregatorTest : public YBTest {
+ protected:
+  // Aggregate the given rows with both the generic expression executor and the vectorized
+  // aggregator, and check that results are the same.
+  void CheckSameResults(const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& targets,
+                        const std::vector<QLTableRow>& rows) {
+    DocExprExecutor executor;
+    std::vector<QLExprResult> expected(targets.size());
+    for (const auto& row : rows) {
+      for (int i = 0; i != targets.size(); ++i) {
+        ASSERT_OK(executor.EvalExpr(targets.Get(i), row, expected[i].Writer()));
+      }
+    }
+
+    PgsqlVectorAggregator aggregator;
+    ASSERT_TRUE(aggregator.Prepare(targets));
+    for (const auto& row : rows) {
+      ASSERT_OK(aggregator.AddRow(row));
+    }
+    std::vector<QLExprResult> actual;
+    ASSERT_OK(aggregator.GetResults(&actual));
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i != expected.size(); ++i) {
+      const QLValuePB& expected_value = expected[i].Value();
+      const QLValuePB& actual_value = actual[i].Value();
+      // Floating point sums are accumulated in a different order.
+      if (expected_value.has_double_value() && actual_value.has_double_value()) {
+        ASSERT_NEAR(expected_value.double_value(), actual_value.double_value(),
+                    std::abs(expected_value.double_value()) * 1e-12) << "Target " << i;
+        continue;
+      }
+      if (expected_value.has_float_value() && actual_value.has_float_value()) {
+        ASSERT_NEAR(expected_value.float_value(), actual_value.float_value(),
+                    std::abs(expected_value.float_value()) * 1e-4) << "Target " << i;
+        continue;
+      }
+      ASSERT_EQ(expected_value.ShortDebugString(), actual_value.ShortDebugString())
+          << "Target " << i;
+    }
+  }
+};
+
+} // namespace
+
+TEST_F(PgsqlVectorAggregatorTest, SameAsExpressionExecutor) {
+  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> targets;
+  AddCountStar(&targets);
+  AddAggregate(bfpg::TSOpcode::kCount, kIntColumn, &targets);
+  AddAggregate(bfpg::TSOpcode::kSumInt32, kIntColumn, &targets);
+  AddAggregate(bfpg::TSOpcode::kSumDouble, kDoubleColumn, &targets);
+  AddAggregate(bfpg::TSOpcode::kSumFloat, kFloatColumn, &targets);
+  AddAggregate(bfpg::TSOpcode::kMin, kIntColumn, &targets);
+  AddAggregate(bfpg::TSOpcode::kMax, kDoubleColumn, &targets);
+
+  // No rows at all.
+  ASSERT_NO_FATALS(CheckSameResults(targets, {}));
+
+  // Span several batches, with NULLs and missing columns.
+  const size_t kNumRows = PgsqlVectorAggregator::kPgsqlAggregateBatchSize * 3 + 17;
+  std::vector<QLTableRow> rows(kNumRows);
+  for (auto& row : rows) {
+    if (!RandomWithChance(5)) {
+      QLValuePB value;
+      value.set_int32_value(RandomUniformInt(-1000000, 1000000));
+      row.AllocColumn(kIntColumn, value);
+    } else if (RandomUniformBool()) {
+      row.AllocColumn(kIntColumn, QLValuePB());
+    }
+    if (!RandomWithChance(7)) {
+      QLValuePB value;
+      value.set_double_value(RandomUniformInt(-1000000, 1000000) / 7.0);
+      row.AllocColumn(kDoubleColumn, value);
+    }
+    if (!RandomWithChance(3)) {
+      QLValuePB value;
+      value.set_float_value(RandomUniformInt(1, 1000) / 8.0f);
+      row.AllocColumn(kFloatColumn, value);
+    }
+  }
+  ASSERT_NO_FATALS(CheckSameResults(targets, rows));
+}
+
+TEST_F(PgsqlVectorAggregatorTest, UnsupportedTargets) {
+  PgsqlVectorAggregator aggregator;
+
+  // Plain column reference is not an aggregate.
+  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> targets;
+  targets.Add()->set_column_id(kIntColumn);
+  ASSERT_FALSE(aggregator.Prepare(targets));
+  ASSERT_FALSE(aggregator.prepared());
+
+  // SUM of a constant.
+  targets.Clear();
+  auto* tscall = targets.Add()->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(bfpg::TSOpcode::kSumInt64));
+  tscall->add_operands()->mutable_value()->set_int64_value(1);
+  ASSERT_FALSE(aggregator.Prepare(targets));
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,275 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_pgsql_aggregate.h"
+
+#include "yb/common/ql_value.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/bfpg/tserver_opcodes.h"
+#include "yb/util/enums.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Reduction kernels. They are kept free of branches and side effects so that the loops can be
+// unrolled and vectorized.
+int64_t SumKernel(const std::vector<int64_t>& values) {
+  int64_t sum = 0;
+  for (int64_t value : values) {
+    sum += value;
+  }
+  return sum;
+}
+
+// Floating point addition is not associative, so the compiler would not vectorize a single running
+// sum. Independent partial sums per lane let it do so. The rounding differs from summing in row
+// order, but postgres already combines partial sums of tablets and pages in arbitrary order.
+constexpr size_t kSumLanes = 8;
+
+template <class T>
+T SumKernel(const std::vector<T>& values) {
+  T lanes[kSumLanes] = {};
+  const T* data = values.data();
+  const size_t size = values.size();
+  const size_t lanes_end = size - size % kSumLanes;
+  for (size_t i = 0; i != lanes_end; i += kSumLanes) {
+    for (size_t lane = 0; lane != kSumLanes; ++lane) {
+      lanes[lane] += data[i + lane];
+    }
+  }
+  T sum = 0;
+  for (size_t i = lanes_end; i != size; ++i) {
+    sum += data[i];
+  }
+  for (T lane : lanes) {
+    sum += lane;
+  }
+  return sum;
+}
+
+Result<int64_t> ExtractInt(const QLValuePB& value) {
+  switch (value.value_case()) {
+    case QLValuePB::kInt8Value:
+      return value.int8_value();
+    case QLValuePB::kInt16Value:
+      return value.int16_value();
+    case QLValuePB::kInt32Value:
+      return value.int32_value();
+    case QLValuePB::kInt64Value:
+      return value.int64_value();
+    default:
+      return STATUS_FORMAT(RuntimeError, "Cannot find SUM of value of type $0",
+                           value.value_case());
+  }
+}
+
+} // namespace
+
+bool PgsqlVectorAggregator::Prepare(
+    const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& targets) {
+  aggregates_.clear();
+  batch_rows_ = 0;
+  prepared_ = false;
+
+  for (const PgsqlExpressionPB& target : targets) {
+    if (!target.has_tscall() || target.tscall().operands_size() != 1) {
+      return false;
+    }
+    const PgsqlExpressionPB& operand = target.tscall().operands(0);
+
+    Aggregate aggregate;
+    switch (static_cast<bfpg::TSOpcode>(target.tscall().opcode())) {
+      case bfpg::TSOpcode::kCount:
+        aggregate.kind = Kind::kCount;
+        if (operand.has_value()) {
+          aggregate.null_operand = QLValue::IsNull(operand.value());
+        } else if (!operand.has_column_id()) {
+          return false;
+        }
+        break;
+      case bfpg::TSOpcode::kSumInt8: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt16: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt32: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt64:
+        aggregate.kind = Kind::kSumInt;
+        break;
+      case bfpg::TSOpcode::kSumFloat:
+        aggregate.kind = Kind::kSumFloat;
+        break;
+      case bfpg::TSOpcode::kSumDouble:
+        aggregate.kind = Kind::kSumDouble;
+        break;
+      case bfpg::TSOpcode::kMin:
+        aggregate.kind = Kind::kMin;
+        break;
+      case bfpg::TSOpcode::kMax:
+        aggregate.kind = Kind::kMax;
+        break;
+      default:
+        return false;
+    }
+
+    if (operand.has_column_id()) {
+      // System columns such as ybctid are not stored in the row.
+      if (operand.column_id() < 0) {
+        return false;
+      }
+      aggregate.column_id = operand.column_id();
+    } else if (aggregate.kind != Kind::kCount) {
+      return false;
+    }
+    aggregates_.push_back(std::move(aggregate));
+  }
+
+  for (Aggregate& aggregate : aggregates_) {
+    switch (aggregate.kind) {
+      case Kind::kSumInt:
+        aggregate.int_values.reserve(kPgsqlAggregateBatchSize);
+        break;
+      case Kind::kSumFloat:
+        aggregate.float_values.reserve(kPgsqlAggregateBatchSize);
+        break;
+      case Kind::kSumDouble:
+        aggregate.double_values.reserve(kPgsqlAggregateBatchSize);
+        break;
+      case Kind::kCount: FALLTHROUGH_INTENDED;
+      case Kind::kMin: FALLTHROUGH_INTENDED;
+      case Kind::kMax:
+        break;
+    }
+  }
+
+  prepared_ = true;
+  return true;
+}
+
+Status PgsqlVectorAggregator::AddRow(const QLTableRow& table_row) {
+  DCHECK(prepared_);
+  for (Aggregate& aggregate : aggregates_) {
+    RETURN_NOT_OK(Accumulate(table_row, &aggregate));
+  }
+  if (++batch_rows_ >= kPgsqlAggregateBatchSize) {
+    FlushBatch();
+  }
+  return Status::OK();
+}
+
+Status PgsqlVectorAggregator::Accumulate(const QLTableRow& table_row, Aggregate* aggregate) {
+  if (aggregate->null_operand) {
+    return Status::OK();
+  }
+  if (aggregate->column_id < 0) {
+    // COUNT of a non-NULL constant, e.g. COUNT(*).
+    ++aggregate->count;
+    return Status::OK();
+  }
+
+  const QLValuePB* value = table_row.GetColumn(aggregate->column_id);
+  if (value == nullptr || QLValue::IsNull(*value)) {
+    return Status::OK();
+  }
+
+  switch (aggregate->kind) {
+    case Kind::kCount:
+      ++aggregate->count;
+      return Status::OK();
+    case Kind::kSumInt:
+      aggregate->int_values.push_back(VERIFY_RESULT(ExtractInt(*value)));
+      return Status::OK();
+    case Kind::kSumFloat:
+      aggregate->float_values.push_back(value->float_value());
+      return Status::OK();
+    case Kind::kSumDouble:
+      aggregate->double_values.push_back(value->double_value());
+      return Status::OK();
+    case Kind::kMin:
+      if (aggregate->extreme.IsNull() || aggregate->extreme.value() > *value) {
+        aggregate->extreme = *value;
+      }
+      return Status::OK();
+    case Kind::kMax:
+      if (aggregate->extreme.IsNull() || aggregate->extreme.value() < *value) {
+        aggregate->extreme = *value;
+      }
+      return Status::OK();
+  }
+  FATAL_INVALID_ENUM_VALUE(Kind, aggregate->kind);
+}
+
+void PgsqlVectorAggregator::FlushBatch() {
+  for (Aggregate& aggregate : aggregates_) {
+    switch (aggregate.kind) {
+      case Kind::kSumInt:
+        aggregate.int_sum += SumKernel(aggregate.int_values);
+        aggregate.count += aggregate.int_values.size();
+        aggregate.int_values.clear();
+        break;
+      case Kind::kSumFloat:
+        aggregate.float_sum += SumKernel(aggregate.float_values);
+        aggregate.count += aggregate.float_values.size();
+        aggregate.float_values.clear();
+        break;
+      case Kind::kSumDouble:
+        aggregate.double_sum += SumKernel(aggregate.double_values);
+        aggregate.count += aggregate.double_values.size();
+        aggregate.double_values.clear();
+        break;
+      case Kind::kCount: FALLTHROUGH_INTENDED;
+      case Kind::kMin: FALLTHROUGH_INTENDED;
+      case Kind::kMax:
+        break;
+    }
+  }
+  batch_rows_ = 0;
+}
+
+Status PgsqlVectorAggregator::GetResults(std::vector<QLExprResult>* results) {
+  DCHECK(prepared_);
+  FlushBatch();
+
+  results->resize(aggregates_.size());
+  for (size_t i = 0; i != aggregates_.size(); ++i) {
+    const Aggregate& aggregate = aggregates_[i];
+    QLExprResultWriter writer = (*results)[i].Writer();
+    // Same as the row-at-a-time path, aggregates over no values are NULL.
+    if (aggregate.count == 0 && aggregate.kind != Kind::kMin && aggregate.kind != Kind::kMax) {
+      writer.SetNull();
+      continue;
+    }
+    switch (aggregate.kind) {
+      case Kind::kCount: FALLTHROUGH_INTENDED;
+      case Kind::kSumInt:
+        writer.NewValue().set_int64_value(
+            aggregate.kind == Kind::kCount ? aggregate.count : aggregate.int_sum);
+        break;
+      case Kind::kSumFloat:
+        writer.NewValue().set_float_value(aggregate.float_sum);
+        break;
+      case Kind::kSumDouble:
+        writer.NewValue().set_double_value(aggregate.double_sum);
+        break;
+      case Kind::kMin: FALLTHROUGH_INTENDED;
+      case Kind::kMax:
+        writer.NewValue() = aggregate.extreme;
+        break;
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace docdb
+} // namespace yb
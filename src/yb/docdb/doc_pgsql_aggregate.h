@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_PGSQL_AGGREGATE_H
+#define YB_DOCDB_DOC_PGSQL_AGGREGATE_H
+
+#include <vector>
+
+#include <google/protobuf/repeated_field.h>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/pgsql_protocol.pb.h"
+
+namespace yb {
+namespace docdb {
+
+// Evaluates aggregates pushed down by YSQL without going through the generic expression executor.
+// Supported targets are COUNT, SUM, MIN and MAX whose operand is a column reference or a constant.
+//
+// Values of the aggregated columns are copied out of each row into typed vectors, and every
+// kPgsqlAggregateBatchSize rows the vectors are reduced by kernels that the compiler can unroll
+// and vectorize. COUNT, MIN and MAX keep plain counters or the current extreme value instead.
+// Floating point sums are accumulated in several lanes, so their rounding could differ from the
+// generic path.
+class PgsqlVectorAggregator {
+ public:
+  static constexpr size_t kPgsqlAggregateBatchSize = 1024;
+
+  PgsqlVectorAggregator() = default;
+
+  PgsqlVectorAggregator(const PgsqlVectorAggregator&) = delete;
+  void operator=(const PgsqlVectorAggregator&) = delete;
+
+  // Prepare kernels for the given targets. Returns false when any target cannot be evaluated by
+  // this aggregator, in which case the caller should use the generic expression executor.
+  bool Prepare(const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& targets);
+
+  bool prepared() const {
+    return prepared_;
+  }
+
+  // Accumulate the aggregated columns of the given row.
+  CHECKED_STATUS AddRow(const QLTableRow& table_row);
+
+  // Reduce the pending batch and write the current aggregate values, one per target. Rows added
+  // afterwards continue to accumulate on top of these values.
+  CHECKED_STATUS GetResults(std::vector<QLExprResult>* results);
+
+ private:
+  enum class Kind {
+    kCount,
+    kSumInt,
+    kSumFloat,
+    kSumDouble,
+    kMin,
+    kMax,
+  };
+
+  struct Aggregate {
+    Kind kind;
+
+    // Column to aggregate, or -1 when the operand is a constant.
+    ColumnIdRep column_id = -1;
+
+    // True when the operand is a NULL constant, so nothing is ever accumulated.
+    bool null_operand = false;
+
+    // Number of accumulated non-NULL values.
+    int64_t count = 0;
+
+    // Running totals.
+    int64_t int_sum = 0;
+    float float_sum = 0;
+    double double_sum = 0;
+
+    // Column values of the pending batch, only non-NULL values are kept.
+    std::vector<int64_t> int_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+
+    // Current minimum or maximum.
+    QLValue extreme;
+  };
+
+  // Extract the aggregated value of one row into the pending batch of the aggregate.
+  CHECKED_STATUS Accumulate(const QLTableRow& table_row, Aggregate* aggregate);
+
+  // Run the reduction kernels over the pending batch.
+  void FlushBatch();
+
+  std::vector<Aggregate> aggregates_;
+  size_t batch_rows_ = 0;
+  bool prepared_ = false;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOC_PGSQL_AGGREGATE_H
@@ -387,6 +387,44 @@ yb::Status GetSubDocument(
   return GetSubDocument(iter.get(), data, nullptr /* projection */, SeekFwdSuffices::kFalse);
 }
 
+Status CheckPartitionTombstone(
+    IntentAwareIterator* db_iter, const Slice& doc_key, PartitionTombstoneCache* cache,
+    DocHybridTime* max_overwrite_ht) {
+  if (!cache->hashed_part.empty() && cache->hashed_part.IsPrefixOf(doc_key)) {
+    // Rows without range components are not covered by the partition tombstone, since it is their
+    // own tombstone.
+    if (doc_key[cache->hashed_part.size()] != ValueTypeAsChar::kGroupEnd) {
+      *max_overwrite_ht = std::max(*max_overwrite_ht, cache->time);
+    }
+    return Status::OK();
+  }
+
+  size_t id_size = 0;
+  if (doc_key[0] == ValueTypeAsChar::kPgTableOid || doc_key[0] == ValueTypeAsChar::kTableId) {
+    id_size = VERIFY_RESULT(DocKey::EncodedSize(doc_key, DocKeyPart::kUpToId));
+  }
+  if (doc_key.size() <= id_size || doc_key[id_size] != ValueTypeAsChar::kUInt16Hash) {
+    return Status::OK();
+  }
+  const auto sizes = VERIFY_RESULT(DocKey::EncodedHashPartAndDocKeySizes(doc_key));
+  if (sizes.first + 1 >= sizes.second) {
+    return Status::OK();
+  }
+
+  cache->hashed_part.Reset(Slice(doc_key.data(), sizes.first));
+  KeyBytes partition_key = cache->hashed_part;
+  partition_key.AppendValueType(ValueType::kGroupEnd);
+  db_iter->Seek(partition_key.AsSlice());
+  DocHybridTime partition_ht = DocHybridTime::kMin;
+  Expiration exp;
+  Value doc_value = Value(PrimitiveValue(ValueType::kInvalid));
+  RETURN_NOT_OK(FindLastWriteTime(
+      db_iter, partition_key.AsSlice(), &partition_ht, &exp, &doc_value));
+  cache->time = doc_value.value_type() == ValueType::kTombstone ? partition_ht : DocHybridTime::kMin;
+  *max_overwrite_ht = std::max(*max_overwrite_ht, cache->time);
+  return Status::OK();
+}
+
 yb::Status GetSubDocument(
     IntentAwareIterator *db_iter,
     const GetSubDocumentData& data,
@@ -454,6 +492,10 @@ yb::Status GetSubDocument(
     // Use the cached result.  Don't worry about exp as YSQL does not support TTL, yet.
     max_overwrite_ht = *data.table_tombstone_time;
   }
+  if (data.partition_tombstone_cache) {
+    RETURN_NOT_OK(CheckPartitionTombstone(
+        db_iter, key_slice, data.partition_tombstone_cache, &max_overwrite_ht));
+  }
   // Second, check the descendants of the ID level.
   IntentAwareIteratorPrefixScope prefix_scope(key_slice, db_iter);
   if (seek_fwd_suffices) {
@@ -27,6 +27,7 @@
 #include "yb/docdb/docdb_types.h"
 #include "yb/docdb/expiration.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/key_bytes.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/subdocument.h"
@@ -110,6 +111,22 @@ class IndexBound {
   bool is_lower_bound_;
 };
 
+// Caches the latest partition tombstone found for a hash partition, i.e. for rows that have the same
+// hashed components. A partition tombstone is a tombstone of the document with the hashed components
+// and no range components, it covers all rows of the partition that are older than it.
+struct PartitionTombstoneCache {
+  // Encoded hashed part of the DocKey of the partition, empty if nothing is cached.
+  KeyBytes hashed_part;
+  DocHybridTime time = DocHybridTime::kMin;
+};
+
+// Updates max_overwrite_ht with the time of the partition tombstone of the row with the specified
+// encoded DocKey, if there is one. doc_key could be followed by subkeys. Seeks db_iter unless the
+// partition of doc_key is already in cache.
+CHECKED_STATUS CheckPartitionTombstone(
+    IntentAwareIterator* db_iter, const Slice& doc_key, PartitionTombstoneCache* cache,
+    DocHybridTime* max_overwrite_ht);
+
 // Pass data to GetSubDocument function.
 struct GetSubDocumentData {
   GetSubDocumentData(
@@ -151,6 +168,9 @@ struct GetSubDocumentData {
   // Hybrid time of latest table tombstone.  Used by colocated tables to compare with the write
   // times of records belonging to the table.
   DocHybridTime* table_tombstone_time;
+  // If set, partition tombstones are checked for rows of hash partitioned tables. Since the check
+  // requires an extra seek, its result is cached for the lifetime of the cache.
+  PartitionTombstoneCache* partition_tombstone_cache = nullptr;
 
   GetSubDocumentData Adjusted(
       const Slice& subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -19,6 +19,8 @@
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/ql_value.h"
 
+#include <algorithm>
+
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_reader.h"
@@ -478,7 +480,17 @@ DocRowwiseIterator::DocRowwiseIterator(
 DocRowwiseIterator::~DocRowwiseIterator() {
 }
 
+bool DocRowwiseIterator::ShouldCheckPartitionTombstones() const {
+  // Partition tombstones are written only for YCQL tables that have both hash and range columns.
+  // They are checked regardless of the use_partition_tombstones table property, because turning
+  // the property off must not bring back rows that were already deleted with a tombstone.
+  return schema_.num_hash_key_columns() > 0 && schema_.num_range_key_columns() > 0;
+}
+
 Status DocRowwiseIterator::Init() {
+  // This is used by backfill and checksum scans, which must not see rows covered by a partition
+  // tombstone either.
+  check_partition_tombstones_ = ShouldCheckPartitionTombstones();
   db_iter_ = CreateIntentAwareIterator(
       doc_db_,
       BloomFilterMode::DONT_USE_BLOOM_FILTER,
@@ -499,6 +511,42 @@ Status DocRowwiseIterator::Init() {
   return Status::OK();
 }
 
+Status DocRowwiseIterator::InitForTupleIds(const std::vector<Slice>& tuple_ids) {
+  DCHECK(std::is_sorted(tuple_ids.begin(), tuple_ids.end(),
+                        [](const Slice& lhs, const Slice& rhs) { return lhs.compare(rhs) < 0; }));
+  // Tuple ids are only used by YSQL, which does not write partition tombstones.
+  check_partition_tombstones_ = false;
+
+  // Bloom filters are built on the full keys, so the table prefix has to be part of them.
+  std::vector<KeyBytes> filter_keys(tuple_ids.size());
+  std::vector<Slice> filter_key_slices;
+  filter_key_slices.reserve(tuple_ids.size());
+  for (size_t i = 0; i != tuple_ids.size(); ++i) {
+    AppendTupleKeyPrefix(&filter_keys[i]);
+    filter_keys[i].AppendRawBytes(tuple_ids[i]);
+    filter_key_slices.push_back(filter_keys[i].AsSlice());
+  }
+  db_iter_ = CreateIntentAwareIterator(
+      doc_db_,
+      filter_key_slices,
+      rocksdb::kDefaultQueryId,
+      txn_op_context_,
+      deadline_,
+      read_time_);
+
+  // Seek straight to the first tuple instead of the start of the table, later tuples are reached
+  // with SeekTupleForward.
+  if (!filter_keys.empty()) {
+    VLOG(3) << __PRETTY_FUNCTION__ << " Seeking to " << filter_keys.front().ToString();
+    db_iter_->Seek(filter_keys.front());
+  }
+  iter_key_.Clear();
+  row_ready_ = false;
+  has_bound_key_ = false;
+
+  return Status::OK();
+}
+
 Result<bool> DocRowwiseIterator::InitScanChoices(
     const DocQLScanSpec& doc_spec, const KeyBytes& lower_doc_key, const KeyBytes& upper_doc_key) {
   if (doc_spec.range_options()) {
@@ -587,10 +635,13 @@ Status DocRowwiseIterator::DoInit(const T& doc_spec) {
 }
 
 Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
+  check_partition_tombstones_ = ShouldCheckPartitionTombstones();
   return DoInit(dynamic_cast<const DocQLScanSpec&>(spec));
 }
 
 Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
+  // YSQL never writes partition tombstones.
+  check_partition_tombstones_ = false;
   return DoInit(dynamic_cast<const DocPgsqlScanSpec&>(spec));
 }
 
@@ -700,6 +751,9 @@ Result<bool> DocRowwiseIterator::HasNext() const {
       &table_tombstone_time_,
     };
     data.deadline_info = deadline_info_.get_ptr();
+    if (check_partition_tombstones_) {
+      data.partition_tombstone_cache = &partition_tombstone_cache_;
+    }
     has_next_status_ = GetSubDocument(db_iter_.get(), data, &projection_subkeys_);
     RETURN_NOT_OK(has_next_status_);
     // After this, the iter should be positioned right after the subdocument.
@@ -859,6 +913,26 @@ Result<Slice> DocRowwiseIterator::GetTupleId() const {
 }
 
 Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
+  return DoSeekTuple(tuple_id, /* forward = */ false);
+}
+
+Result<bool> DocRowwiseIterator::SeekTupleForward(const Slice& tuple_id) {
+  return DoSeekTuple(tuple_id, /* forward = */ true);
+}
+
+void DocRowwiseIterator::AppendTupleKeyPrefix(KeyBytes* key) const {
+  if (schema_.has_cotable_id()) {
+    std::string bytes;
+    schema_.cotable_id().EncodeToComparable(&bytes);
+    key->AppendValueType(ValueType::kTableId);
+    key->AppendRawBytes(bytes);
+  } else if (schema_.has_pgtable_id()) {
+    key->AppendValueType(ValueType::kPgTableOid);
+    key->AppendUInt32(schema_.pgtable_id());
+  }
+}
+
+Result<bool> DocRowwiseIterator::DoSeekTuple(const Slice& tuple_id, bool forward) {
   // If cotable id / pgtable id is present in the table schema, then
   // we need to prepend it in the tuple key to seek.
   if (schema_.has_cotable_id() || schema_.has_pgtable_id()) {
@@ -866,21 +940,18 @@ Result<bool> DocRowwiseIterator::SeekTuple(const Slice& tuple_id) {
     if (!tuple_key_) {
       tuple_key_.emplace();
       tuple_key_->Reserve(1 + size + tuple_id.size());
-
-      if (schema_.has_cotable_id()) {
-        std::string bytes;
-        schema_.cotable_id().EncodeToComparable(&bytes);
-        tuple_key_->AppendValueType(ValueType::kTableId);
-        tuple_key_->AppendRawBytes(bytes);
-      } else {
-        tuple_key_->AppendValueType(ValueType::kPgTableOid);
-        tuple_key_->AppendUInt32(schema_.pgtable_id());
-      }
+      AppendTupleKeyPrefix(tuple_key_.get_ptr());
     } else {
       tuple_key_->Truncate(1 + size);
     }
     tuple_key_->AppendRawBytes(tuple_id);
-    db_iter_->Seek(*tuple_key_);
+    if (forward) {
+      db_iter_->SeekForward(tuple_key_.get_ptr());
+    } else {
+      db_iter_->Seek(*tuple_key_);
+    }
+  } else if (forward) {
+    db_iter_->SeekForward(tuple_id);
   } else {
     db_iter_->Seek(tuple_id);
   }
@@ -24,6 +24,7 @@
 #include "yb/common/ql_scanspec.h"
 #include "yb/common/read_hybrid_time.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_reader.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_pgsql_scanspec.h"
@@ -71,6 +72,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   CHECKED_STATUS Init(const common::QLScanSpec& spec);
   CHECKED_STATUS Init(const common::PgsqlScanSpec& spec);
 
+  // Init iterator for reading rows by a sorted batch of tuple ids. SST files whose bloom filter
+  // excludes all of the tuples are skipped, and the iterator is positioned at the first tuple.
+  CHECKED_STATUS InitForTupleIds(const std::vector<Slice>& tuple_ids);
+
   // This must always be called before NextRow. The implementation actually finds the
   // first row to scan, and NextRow expects the RocksDB iterator to already be properly
   // positioned.
@@ -107,6 +112,11 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // the cotable id.
   Result<bool> SeekTuple(const Slice& tuple_id) override;
 
+  // Same as SeekTuple, but the given tuple must not precede the tuple sought last. The iterator
+  // only moves forward, so keys that are close to the current position are reached by Next
+  // instead of a full Seek of the regular and intents iterators.
+  Result<bool> SeekTupleForward(const Slice& tuple_id) override;
+
   // Retrieves the next key to read after the iterator finishes for the given page.
   CHECKED_STATUS GetNextReadSubDocKey(SubDocKey* sub_doc_key) const override;
 
@@ -114,6 +124,13 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   template <class T>
   CHECKED_STATUS DoInit(const T& spec);
 
+  bool ShouldCheckPartitionTombstones() const;
+
+  Result<bool> DoSeekTuple(const Slice& tuple_id, bool forward);
+
+  // Appends the cotable id / pgtable id of the table, if any, which precedes the tuple id in keys.
+  void AppendTupleKeyPrefix(KeyBytes* key) const;
+
   Result<bool> InitScanChoices(
       const DocQLScanSpec& doc_spec, const KeyBytes& lower_doc_key, const KeyBytes& upper_doc_key);
 
@@ -222,6 +239,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   // Hybrid time of the table tombstone, if found.
   mutable DocHybridTime table_tombstone_time_ = DocHybridTime::kInvalid;
+
+  // Partition tombstone of the last read hash partition.
+  bool check_partition_tombstones_ = false;
+  mutable PartitionTombstoneCache partition_tombstone_cache_;
 };
 
 }  // namespace docdb
@@ -170,6 +170,17 @@ Result<bool> DocWriteBatch::SetPrimitiveInternalHandleUserTimestamp(
         }
       }
     }
+    if (should_apply && optional_init_markers()) {
+      // A partition tombstone works like a tombstone of every row of the partition, so the write
+      // should not be applied if it is older than the partition tombstone.
+      DocHybridTime partition_ht = DocHybridTime::kMin;
+      RETURN_NOT_OK(CheckPartitionTombstone(
+          iter->Iterator(), key_prefix_.AsSlice(), &partition_tombstone_cache_, &partition_ht));
+      if (partition_ht != DocHybridTime::kMin) {
+        should_apply = value.user_timestamp() >=
+            partition_ht.hybrid_time().GetPhysicalValueMicros();
+      }
+    }
   }
   return should_apply;
 }
@@ -488,6 +499,14 @@ Status DocWriteBatch::ReplaceInList(
       deadline,
       read_ht);
 
+  // List elements that are older than the partition tombstone of the row were deleted with it.
+  DocHybridTime partition_ht = DocHybridTime::kMin;
+  if (is_cql) {
+    RETURN_NOT_OK(CheckPartitionTombstone(
+        iter.get(), doc_path.encoded_doc_key().AsSlice(), &partition_tombstone_cache_,
+        &partition_ht));
+  }
+
   Slice value_slice;
   SubDocKey found_key;
   int current_index = start_index;
@@ -528,7 +547,7 @@ Status DocWriteBatch::ReplaceInList(
     value_slice = iter->value();
     RETURN_NOT_OK(Value::DecodePrimitiveValueType(value_slice, &value_type, nullptr, &entry_ttl));
 
-    bool has_expired = value_type == ValueType::kTombstone;
+    bool has_expired = value_type == ValueType::kTombstone || key_data.write_time <= partition_ht;
     // Redis lists do not have element-level TTL.
     if (!has_expired && is_cql) {
       entry_ttl = ComputeTTL(entry_ttl, default_ttl);
@@ -583,9 +602,27 @@ Status DocWriteBatch::ReplaceInList(
   }
 }
 
+Status DocWriteBatch::DeleteHashPartition(
+    const Slice& encoded_hashed_doc_key,
+    const ReadHybridTime& read_ht,
+    const CoarseTimePoint deadline,
+    rocksdb::QueryId query_id) {
+  const auto id_size =
+      VERIFY_RESULT(DocKey::EncodedSize(encoded_hashed_doc_key, DocKeyPart::kUpToId));
+  const auto sizes = VERIFY_RESULT(DocKey::EncodedHashPartAndDocKeySizes(encoded_hashed_doc_key));
+  if (sizes.first == id_size || sizes.first + 1 != sizes.second ||
+      sizes.second != encoded_hashed_doc_key.size()) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Hashed DocKey without range components expected: $0",
+        SubDocKey::DebugSliceToString(encoded_hashed_doc_key));
+  }
+  return DeleteSubDoc(DocPath(encoded_hashed_doc_key), read_ht, deadline, query_id);
+}
+
 void DocWriteBatch::Clear() {
   put_batch_.clear();
   cache_.Clear();
+  partition_tombstone_cache_ = PartitionTombstoneCache();
 }
 
 void DocWriteBatch::MoveToWriteBatchPB(KeyValueWriteBatchPB *kv_pb) {
@@ -22,6 +22,7 @@
 
 #include "yb/docdb/docdb_types.h"
 #include "yb/docdb/doc_path.h"
+#include "yb/docdb/doc_reader.h"
 #include "yb/docdb/doc_write_batch_cache.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/subdocument.h"
@@ -188,6 +189,17 @@ class DocWriteBatch {
                         read_ht, deadline, query_id, user_timestamp);
   }
 
+  // Deletes all rows of a hash partition with a single partition tombstone. The partition is
+  // identified by encoded DocKey with its hashed components and no range components. The document
+  // with this DocKey itself (e.g. static columns of CQL table) is also deleted.
+  // Partition tombstones are taken into account by readers that check them, see
+  // PartitionTombstoneCache, and by ReplaceInList and user timestamp checks of CQL writes.
+  CHECKED_STATUS DeleteHashPartition(
+      const Slice& encoded_hashed_doc_key,
+      const ReadHybridTime& read_ht = ReadHybridTime::Max(),
+      const CoarseTimePoint deadline = CoarseTimePoint::max(),
+      rocksdb::QueryId query_id = rocksdb::kDefaultQueryId);
+
   void Clear();
   bool IsEmpty() const { return put_batch_.empty(); }
 
@@ -249,6 +261,9 @@ class DocWriteBatch {
   KeyBytes key_prefix_;
   bool subdoc_exists_ = true;
   DocWriteBatchCache::Entry current_entry_;
+
+  // Partition tombstone of the last CQL row that was read by this batch.
+  PartitionTombstoneCache partition_tombstone_cache_;
 };
 
 // Converts a RocksDB WriteBatch to a string.
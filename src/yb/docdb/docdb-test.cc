@@ -20,6 +20,7 @@
 #include "yb/rocksdb/db/db_impl.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/db/writebuffer.h"
+#include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
@@ -68,6 +69,9 @@ using namespace std::chrono_literals;
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
 DECLARE_bool(TEST_docdb_sort_weak_intents_in_tests);
+DECLARE_bool(docdb_drop_expired_sst_files);
+DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
+DECLARE_bool(rocksdb_compact_flush_rate_limit_per_data_dir);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -78,6 +82,7 @@ CHECKED_STATUS GetPrimitiveValue(const rocksdb::UserBoundaryValues &values,
     size_t index,
     PrimitiveValue *out);
 CHECKED_STATUS GetDocHybridTime(const rocksdb::UserBoundaryValues &values, DocHybridTime *out);
+CHECKED_STATUS GetMaxValueExpiration(const rocksdb::UserBoundaryValues &values, HybridTime *out);
 
 YB_STRONGLY_TYPED_BOOL(InitMarkerExpired);
 YB_STRONGLY_TYPED_BOOL(UseIntermediateFlushes);
@@ -2043,6 +2048,104 @@ SubDocKey(DocKey(PgTableId=16385, [], ["r1"]), [SystemColumnId(0); HT{ physical:
       )#");
 }
 
+TEST_F(DocDBTest, PartitionTombstone) {
+  const std::vector<PrimitiveValue> hashed_components = { PrimitiveValue("h1") };
+  const KeyBytes encoded_partition_key = DocKey(0, hashed_components).Encode();
+  auto row_key = [&hashed_components](int i) {
+    return DocKey(0, hashed_components, { PrimitiveValue(Format("r$0", i)) }).Encode();
+  };
+
+  // Simulate CQL:
+  //   INSERT INTO t (h, r, v) VALUES ("h1", "r1", "v1"), ("h1", "r2", "v2");
+  //   DELETE FROM t WHERE h = "h1";
+  //   INSERT INTO t (h, r, v) VALUES ("h1", "r3", "v3");
+  for (int i = 1; i <= 2; ++i) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(row_key(i), PrimitiveValue(ColumnId(10))),
+        Value(PrimitiveValue(Format("v$0", i))), HybridTime::FromMicros(i * 1000)));
+  }
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.DeleteHashPartition(encoded_partition_key.AsSlice()));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(row_key(3), PrimitiveValue(ColumnId(10))), Value(PrimitiveValue("v3")),
+      4000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  // Only a hashed DocKey without range components identifies a partition.
+  ASSERT_NOK(dwb.DeleteHashPartition(row_key(1).AsSlice()));
+
+  auto row_found = [this, &row_key](int i, HybridTime read_ht) -> Result<bool> {
+    SubDocument doc;
+    bool found = false;
+    PartitionTombstoneCache cache;
+    auto encoded_key = row_key(i);
+    GetSubDocumentData data = { encoded_key, &doc, &found };
+    data.partition_tombstone_cache = &cache;
+    RETURN_NOT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, kNonTransactionalOperationContext,
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::SingleTime(read_ht)));
+    return found;
+  };
+  ASSERT_TRUE(ASSERT_RESULT(row_found(1, 2500_usec_ht)));
+  ASSERT_FALSE(ASSERT_RESULT(row_found(1, 5000_usec_ht)));
+  ASSERT_FALSE(ASSERT_RESULT(row_found(2, 5000_usec_ht)));
+  ASSERT_TRUE(ASSERT_RESULT(row_found(3, 5000_usec_ht)));
+
+  // Rows covered by the partition tombstone are removed by compaction.
+  FullyCompactHistoryBefore(10000_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey(0x0000, ["h1"], ["r3"]), [ColumnId(10); HT{ physical: 4000 }]) -> "v3"
+      )#");
+}
+
+TEST_F(DocDBTest, DropExpiredFiles) {
+  FLAGS_docdb_drop_expired_sst_files = true;
+  FLAGS_rocksdb_level0_file_num_compaction_trigger = 3;
+  ASSERT_OK(ReinitDBOptions());
+  SetTableTTL(1);
+  SetHistoryCutoffHybridTime(5000_usec_ht);
+
+  // The first two files expire at 2000 and 3000 because of the table TTL. The third one is not
+  // expired yet.
+  for (int i : {1, 2, 10}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(DocKey(PrimitiveValues(Format("k$0", i))).Encode(), PrimitiveValue("s")),
+        Value(PrimitiveValue(Format("v$0", i))), HybridTime::FromMicros(i * 1000)));
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+  ASSERT_OK(down_cast<rocksdb::DBImpl*>(rocksdb())->TEST_WaitForCompact());
+
+  ASSERT_EQ(1, rocksdb()->GetCurrentVersionNumSSTFiles());
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey([], ["k10"]), ["s"; HT{ physical: 10000 }]) -> "v10"
+      )#");
+}
+
+TEST_F(DocDBTest, ValueExpirationBoundary) {
+  // Value expiration is not written to SST file metadata unless expired files could be dropped,
+  // since older versions could not read it.
+  for (bool drop_expired_files : {false, true}) {
+    FLAGS_docdb_drop_expired_sst_files = drop_expired_files;
+    ASSERT_OK(ReinitDBOptions());
+    ASSERT_OK(SetPrimitive(
+        DocPath(DocKey(PrimitiveValues("k")).Encode(), PrimitiveValue("s")),
+        Value(PrimitiveValue("v")), 1000_usec_ht));
+    ASSERT_OK(FlushRocksDbAndWait());
+
+    std::vector<rocksdb::LiveFileMetaData> files;
+    rocksdb()->GetLiveFilesMetaData(&files);
+    ASSERT_FALSE(files.empty());
+    auto newest = std::max_element(
+        files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+          return lhs.name < rhs.name;
+        });
+    HybridTime value_expiration;
+    ASSERT_EQ(drop_expired_files,
+              GetMaxValueExpiration(newest->largest.user_values, &value_expiration).ok());
+  }
+}
+
 TEST_F(DocDBTest, MinorCompactionNoDeletions) {
   ASSERT_OK(DisableCompactions());
   const DocKey doc_key(PrimitiveValues("k"));
@@ -2651,6 +2754,40 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
 }
 
+TEST_F(DocDBTest, BloomFilterKeySet) {
+  if (!FLAGS_use_docdb_aware_bloom_filter) {
+    return;
+  }
+  // Each file contains a single key: file1: k1, file2: k2, file3: k3.
+  std::vector<KeyBytes> keys;
+  for (int i = 1; i <= 3; ++i) {
+    keys.push_back(DocKey(0, PrimitiveValues(Format("key$0", i)), PrimitiveValues()).Encode());
+    ASSERT_OK(SetPrimitive(
+        DocPath(keys.back()), PrimitiveValue("value"), HybridTime::FromMicros(i * 1000)));
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  auto* statistics = regular_db_options().statistics.get();
+  auto filter_fetches = [statistics] {
+    return statistics->getTickerCount(rocksdb::BLOCK_CACHE_FILTER_HIT) +
+           statistics->getTickerCount(rocksdb::BLOCK_CACHE_FILTER_MISS);
+  };
+  const auto useful_before = statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+  const auto iterators_before = statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+  const auto fetches_before = filter_fetches();
+
+  const std::vector<Slice> user_keys = { keys[0].AsSlice(), keys[2].AsSlice() };
+  auto iter = CreateIntentAwareIterator(
+      doc_db(), user_keys, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */,
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::Max());
+
+  // Only file2 has none of the keys.
+  ASSERT_EQ(useful_before + 1, statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL));
+  ASSERT_EQ(iterators_before + 2, statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS));
+  // Each file has a single filter block, which is fetched once for both keys.
+  ASSERT_EQ(fetches_before + 3, filter_fetches());
+}
+
 TEST_F(DocDBTest, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -3365,6 +3502,41 @@ TEST_F(DocDBTest, ForceFlushedFrontier) {
 }
 
 // Handy code to analyze some DB.
+TEST_F(DocDBTest, DataDirRateLimiter) {
+  const std::string kDataDir1 = GetTestPath("data_dir_1");
+  const std::string kDataDir2 = GetTestPath("data_dir_2");
+  auto make_options = [] {
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    options.rate_limiter.reset(rocksdb::NewGenericRateLimiter(1_MB));
+    return options;
+  };
+
+  // Each RocksDB instance keeps its own rate limiter by default.
+  FLAGS_rocksdb_compact_flush_rate_limit_per_data_dir = false;
+  auto own_options = make_options();
+  auto own_rate_limiter = own_options.rate_limiter;
+  SetDataDirRateLimiter(&own_options, kDataDir1);
+  ASSERT_EQ(own_rate_limiter, own_options.rate_limiter);
+
+  FLAGS_rocksdb_compact_flush_rate_limit_per_data_dir = true;
+  std::vector<std::unique_ptr<rocksdb::DB>> dbs;
+  std::vector<std::shared_ptr<rocksdb::RateLimiter>> rate_limiters;
+  for (const auto& data_dir : {kDataDir1, kDataDir1, kDataDir2}) {
+    auto options = make_options();
+    SetDataDirRateLimiter(&options, data_dir);
+    rocksdb::DB* db = nullptr;
+    ASSERT_OK(rocksdb::DB::Open(options, Format("$0_db_$1", data_dir, dbs.size()), &db));
+    dbs.emplace_back(db);
+    rate_limiters.push_back(db->GetDBOptions().rate_limiter);
+  }
+
+  // DBs stored in the same data directory share the rate limiter.
+  ASSERT_EQ(rate_limiters[0], rate_limiters[1]);
+  ASSERT_NE(rate_limiters[0], rate_limiters[2]);
+  ASSERT_NE(own_rate_limiter, rate_limiters[0]);
+}
+
 TEST_F(DocDBTest, DISABLED_DumpDB) {
   tablet::TabletOptions tablet_options;
   rocksdb::Options options;
@@ -18,6 +18,7 @@
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/string_util.h"
 
 #include "yb/docdb/doc_key.h"
@@ -34,9 +35,19 @@ using rocksdb::CompactionFilter;
 using rocksdb::VectorToString;
 using rocksdb::FilterDecision;
 
+DEFINE_bool(docdb_drop_expired_sst_files, false,
+            "Delete the oldest SST files of tables with default TTL without compacting them, when "
+            "all their entries have expired before the history cutoff. SST files written with "
+            "this flag track the expiration of their entries in a way that older versions cannot "
+            "read, so it should be set only after all tservers are upgraded.");
+TAG_FLAG(docdb_drop_expired_sst_files, advanced);
+
 namespace yb {
 namespace docdb {
 
+Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime* out);
+Status GetMaxValueExpiration(const rocksdb::UserBoundaryValues& values, HybridTime* out);
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(
@@ -129,8 +140,11 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // k1 col2 T9   Truncating the stack to [T10], setting prev_overwrite_ht to 10, and therefore
   //              deciding to remove this entry because 9 < 10.
   //
-  const DocHybridTime prev_overwrite_ht =
+  DocHybridTime prev_overwrite_ht =
       overwrite_.empty() ? DocHybridTime::kMin : overwrite_.back().doc_ht;
+  if (!partition_hashed_part_.empty() && partition_hashed_part_.IsPrefixOf(key)) {
+    prev_overwrite_ht = std::max(prev_overwrite_ht, partition_tombstone_ht_);
+  }
   const Expiration prev_exp =
       overwrite_.empty() ? Expiration() : overwrite_.back().expiration;
 
@@ -211,6 +225,10 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
       value_slice.FirstByteOr(ValueTypeAsChar::kInvalid));
   const Expiration curr_exp(ht.hybrid_time(), value.ttl());
 
+  if (value_type == ValueType::kTombstone && new_stack_size == 2) {
+    RETURN_NOT_OK(UpdatePartitionTombstone(key, ht));
+  }
+
   // If within the merge block.
   //     If the row is a TTL row, delete it.
   //     Otherwise, replace it with the cached TTL (i.e., apply merge).
@@ -316,6 +334,27 @@ void DocDBCompactionFilter::AssignPrevSubDocKey(
 }
 
 
+Status DocDBCompactionFilter::UpdatePartitionTombstone(const Slice& key, DocHybridTime ht) {
+  // sub_key_ends_ contains ends of ID and DocKey for the key of the document itself.
+  const auto id_size = sub_key_ends_[0];
+  if (key[id_size] != ValueTypeAsChar::kUInt16Hash) {
+    return Status::OK();
+  }
+  const auto sizes = VERIFY_RESULT(DocKey::EncodedHashPartAndDocKeySizes(key));
+  // Range group of the DocKey should be empty.
+  if (sizes.first + 1 != sizes.second) {
+    return Status::OK();
+  }
+  const Slice hashed_part(key.data(), sizes.first);
+  if (partition_hashed_part_.AsSlice() == hashed_part) {
+    partition_tombstone_ht_ = std::max(partition_tombstone_ht_, ht);
+  } else {
+    partition_hashed_part_.Reset(hashed_part);
+    partition_tombstone_ht_ = ht;
+  }
+  return Status::OK();
+}
+
 rocksdb::UserFrontierPtr DocDBCompactionFilter::GetLargestUserFrontier() const {
   auto* consensus_frontier = new ConsensusFrontier();
   consensus_frontier->set_history_cutoff(retention_.history_cutoff);
@@ -344,6 +383,70 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
       key_bounds_);
 }
 
+namespace {
+
+class ExpiredFilesChecker : public rocksdb::DroppableFilesChecker {
+ public:
+  explicit ExpiredFilesChecker(const HistoryRetentionDirective& retention)
+      : retention_(retention) {}
+
+  bool AddFile(
+      const rocksdb::FileBoundaryValuesBase& largest,
+      const rocksdb::FileBoundaryValuesBase& remaining_smallest) override {
+    // Once some file could not be dropped, newer files could not be dropped either.
+    if (!all_expired_ || !IsExpired(largest)) {
+      all_expired_ = false;
+      return false;
+    }
+
+    // Expired entries still hide older versions of the same keys, so the remaining files should
+    // contain only newer entries.
+    DocHybridTime remaining_min_ht;
+    return !GetDocHybridTime(remaining_smallest.user_values, &remaining_min_ht).ok() ||
+           remaining_min_ht > max_ht_;
+  }
+
+ private:
+  bool IsExpired(const rocksdb::FileBoundaryValuesBase& largest) {
+    DocHybridTime doc_ht;
+    HybridTime value_expiration;
+    // Files written before the expiration was tracked don't have it.
+    if (!GetDocHybridTime(largest.user_values, &doc_ht).ok() ||
+        !GetMaxValueExpiration(largest.user_values, &value_expiration).ok()) {
+      return false;
+    }
+    if (value_expiration >= retention_.history_cutoff) {
+      return false;
+    }
+    bool has_expired = false;
+    if (!HasExpiredTTL(doc_ht.hybrid_time(), retention_.table_ttl, retention_.history_cutoff,
+                       &has_expired).ok() || !has_expired) {
+      return false;
+    }
+    max_ht_ = std::max(max_ht_, doc_ht);
+    return true;
+  }
+
+  const HistoryRetentionDirective retention_;
+  DocHybridTime max_ht_ = DocHybridTime::kMin;
+  bool all_expired_ = true;
+};
+
+}  // namespace
+
+std::unique_ptr<rocksdb::DroppableFilesChecker>
+    DocDBCompactionFilterFactory::NewDroppableFilesChecker() {
+  if (!FLAGS_docdb_drop_expired_sst_files) {
+    return nullptr;
+  }
+  auto retention = retention_policy_->GetRetentionDirective();
+  // Without table TTL, entries that don't have their own TTL never expire.
+  if (!retention.history_cutoff.is_valid() || retention.table_ttl.Equals(Value::kMaxTtl)) {
+    return nullptr;
+  }
+  return std::make_unique<ExpiredFilesChecker>(retention);
+}
+
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
@@ -90,6 +90,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
       int level, const Slice& key, const Slice& existing_value, std::string* new_value,
       bool* value_changed);
 
+  // Remembers the partition tombstone, if key is the key of a tombstone of a document with hashed
+  // components only.
+  CHECKED_STATUS UpdatePartitionTombstone(const Slice& key, DocHybridTime ht);
+
   const HistoryRetentionDirective retention_;
   const KeyBounds* key_bounds_;
   const IsMajorCompaction is_major_compaction_;
@@ -142,6 +146,12 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
 
   std::vector<OverwriteData> overwrite_;
 
+  // Hashed part of the DocKey and hybrid time of the last partition tombstone at or below
+  // history_cutoff_. Since a partition tombstone sorts before all rows of its partition, it is
+  // applied to the following keys that have the same hashed part, see PartitionTombstoneCache.
+  KeyBytes partition_hashed_part_;
+  DocHybridTime partition_tombstone_ht_ = DocHybridTime::kMin;
+
   // We use this to only log a message that the filter is being used once on the first call to
   // the Filter function.
   bool filter_usage_logged_ = false;
@@ -163,6 +173,11 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
+
+  // Files could be dropped when all their entries have expired, according to the table TTL and
+  // their own TTL, before the history cutoff. Files containing tombstones are never dropped.
+  std::unique_ptr<rocksdb::DroppableFilesChecker> NewDroppableFilesChecker() override;
+
   const char* Name() const override;
 
  private:
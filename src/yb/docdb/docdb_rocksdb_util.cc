@@ -13,8 +13,10 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
-#include <thread>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "yb/common/transaction.h"
 
@@ -46,6 +48,13 @@ using namespace std::literals;
 DEFINE_int32(rocksdb_max_background_flushes, -1, "Number threads to do background flushes.");
 DEFINE_bool(rocksdb_disable_compactions, false, "Disable background compactions.");
 DEFINE_bool(rocksdb_compaction_measure_io_stats, false, "Measure stats for rocksdb compactions.");
+DEFINE_bool(rocksdb_use_direct_reads, false,
+            "Read SST files with O_DIRECT, so that their blocks are cached only in the block cache "
+            "and not in the OS page cache as well. Applies to compaction inputs too.");
+DEFINE_uint64(rocksdb_direct_reads_compaction_readahead_bytes, 2_MB,
+              "Readahead size for compaction inputs when rocksdb_use_direct_reads is set. Direct "
+              "reads bypass the OS readahead, so without it compactions read SST files one block "
+              "at a time.");
 DEFINE_int32(rocksdb_base_background_compactions, -1,
              "Number threads to do background compactions.");
 DEFINE_int32(rocksdb_max_background_compactions, -1,
@@ -67,10 +76,17 @@ DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 256_MB,
              "Use to control write rate of flush and compaction.");
+DEFINE_bool(rocksdb_compact_flush_rate_limit_per_data_dir, false,
+            "Apply rocksdb_compact_flush_rate_limit_bytes_per_sec to all tablets stored in the "
+            "same data directory together, instead of to each RocksDB instance separately.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, false,
+            "Let the leader of a RocksDB write group and its followers insert their write batches "
+            "into the memtable in parallel. Single deletes of intents are then always written to "
+            "the memtable instead of erasing the intent from it.");
 DEFINE_int32(rocksdb_max_write_buffer_number, 2,
              "Maximum number of write buffers that are built up in memory.");
 
@@ -92,6 +108,10 @@ DEFINE_int64(db_write_buffer_size, -1,
 DEFINE_int32(memstore_size_mb, 128,
              "Max size (in mb) of the memstore, before needing to flush.");
 
+DEFINE_bool(use_docdb_aware_data_block_hash_index, false,
+            "Add a hash index keyed by DocKey to data blocks of new SST files, so point reads do "
+            "not binary search all restart points of a data block. Such files could not be read "
+            "by versions that do not support this index.");
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
 // Empirically 2 is a minimal value that provides best performance on sequential scan.
@@ -113,6 +133,8 @@ DEFINE_int32(priority_thread_pool_size, -1,
              "If -1 and max_background_compactions is specified - use max_background_compactions. "
              "If -1 and max_background_compactions is not specified - use sqrt(num_cpus).");
 
+DECLARE_bool(docdb_drop_expired_sst_files);
+
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -121,7 +143,8 @@ using strings::Substitute;
 namespace yb {
 namespace docdb {
 
-std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
+std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance(
+    bool track_value_expiration);
 
 void SeekForward(const rocksdb::Slice& slice, rocksdb::Iterator *iter) {
   if (!iter->Valid() || iter->key().compare(slice) >= 0) {
@@ -262,6 +285,23 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
       doc_db, read_opts, deadline, read_time, txn_op_context);
 }
 
+unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
+    const DocDB& doc_db,
+    const std::vector<Slice>& user_keys_for_filter,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& txn_op_context,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time) {
+  rocksdb::ReadOptions read_opts;
+  read_opts.query_id = query_id;
+  if (FLAGS_use_docdb_aware_bloom_filter) {
+    read_opts.table_aware_file_filter = doc_db.regular->GetOptions().table_factory->
+        NewTableAwareReadFileFilter(read_opts, user_keys_for_filter);
+  }
+  return std::make_unique<IntentAwareIterator>(
+      doc_db, read_opts, deadline, read_time, txn_op_context);
+}
+
 namespace {
 
 std::mutex rocksdb_flags_mutex;
@@ -381,6 +421,31 @@ rocksdb::InternalIterator* WrapIterator(
 
 } // namespace
 
+PriorityThreadPool* GetPriorityThreadPoolForCompactionsAndFlushes() {
+  static PriorityThreadPool priority_thread_pool_for_compactions_and_flushes([] {
+    // Pool size is auto initialized along with other RocksDB flags.
+    rocksdb::Options options;
+    AutoInitRocksDBFlags(&options);
+    return FLAGS_priority_thread_pool_size;
+  }());
+  return &priority_thread_pool_for_compactions_and_flushes;
+}
+
+void SetDataDirRateLimiter(rocksdb::Options* options, const std::string& data_dir) {
+  if (!FLAGS_rocksdb_compact_flush_rate_limit_per_data_dir || !options->rate_limiter ||
+      data_dir.empty()) {
+    return;
+  }
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::shared_ptr<rocksdb::RateLimiter>> rate_limiters;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& rate_limiter = rate_limiters[data_dir];
+  if (!rate_limiter) {
+    rate_limiter = options->rate_limiter;
+  }
+  options->rate_limiter = rate_limiter;
+}
+
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& log_prefix,
     const shared_ptr<rocksdb::Statistics>& statistics,
@@ -392,8 +457,13 @@ void InitRocksDBOptions(
   options->statistics = statistics;
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
-  options->boundary_extractor = DocBoundaryValuesExtractorInstance();
+  options->boundary_extractor =
+      DocBoundaryValuesExtractorInstance(FLAGS_docdb_drop_expired_sst_files);
   options->compaction_measure_io_stats = FLAGS_rocksdb_compaction_measure_io_stats;
+  options->use_direct_reads = FLAGS_rocksdb_use_direct_reads;
+  if (FLAGS_rocksdb_use_direct_reads) {
+    options->compaction_readahead_size = FLAGS_rocksdb_direct_reads_compaction_readahead_bytes;
+  }
   options->memory_monitor = tablet_options.memory_monitor;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
@@ -402,10 +472,8 @@ void InitRocksDBOptions(
   }
   options->env = tablet_options.rocksdb_env;
   options->checkpoint_env = rocksdb::Env::Default();
-  static PriorityThreadPool priority_thread_pool_for_compactions_and_flushes(
-      FLAGS_priority_thread_pool_size);
   options->priority_thread_pool_for_compactions_and_flushes =
-      &priority_thread_pool_for_compactions_and_flushes;
+      GetPriorityThreadPoolForCompactionsAndFlushes();
 
   if (FLAGS_num_reserved_small_compaction_threads != -1) {
     options->num_reserved_small_compaction_threads = FLAGS_num_reserved_small_compaction_threads;
@@ -445,6 +513,10 @@ void InitRocksDBOptions(
     table_options.supported_filter_policies->emplace(supported_policy->Name(), supported_policy);
   }
 
+  if (FLAGS_use_docdb_aware_data_block_hash_index) {
+    table_options.data_block_key_prefix_extractor = std::make_shared<DocKeyPrefixExtractor>();
+  }
+
   if (FLAGS_use_multi_level_index) {
     table_options.index_type = rocksdb::IndexType::kMultiLevelBinarySearch;
   } else {
@@ -496,8 +568,11 @@ void InitRocksDBOptions(
 
   options->max_write_buffer_number = FLAGS_rocksdb_max_write_buffer_number;
 
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+  options->enable_write_thread_adaptive_yield = FLAGS_rocksdb_allow_concurrent_memtable_write;
   options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
-      0 /* lookahead */, rocksdb::ConcurrentWrites::kFalse);
+      0 /* lookahead */,
+      rocksdb::ConcurrentWrites(FLAGS_rocksdb_allow_concurrent_memtable_write));
 
   options->iterator_replacer = std::make_shared<rocksdb::IteratorReplacer>(&WrapIterator);
 }
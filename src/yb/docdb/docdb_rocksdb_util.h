@@ -32,6 +32,9 @@
 #include "yb/util/slice.h"
 
 namespace yb {
+
+class PriorityThreadPool;
+
 namespace docdb {
 
 class IntentAwareIterator;
@@ -102,6 +105,16 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
     const Slice* iterate_upper_bound = nullptr);
 
+// Creates an iterator for reading several keys that could have different hashed components.
+// SST files are excluded using bloom filters only if they have none of user_keys_for_filter.
+std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
+    const DocDB& doc_db,
+    const std::vector<Slice>& user_keys_for_filter,
+    const rocksdb::QueryId query_id,
+    const TransactionOperationContextOpt& transaction_context,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time);
+
 // Request RocksDB compaction and wait until it completes.
 void ForceRocksDBCompact(rocksdb::DB* db);
 
@@ -113,6 +126,13 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Makes flushes and compactions share the rate limit with other RocksDB instances whose files are
+// stored in the same data directory, when rocksdb_compact_flush_rate_limit_per_data_dir is set.
+void SetDataDirRateLimiter(rocksdb::Options* options, const std::string& data_dir);
+
+// Returns the thread pool that runs flushes and compactions of all RocksDB instances.
+PriorityThreadPool* GetPriorityThreadPoolForCompactionsAndFlushes();
+
 // Sets logs prefix for RocksDB options. This will also reinitialize options->info_log.
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix);
 
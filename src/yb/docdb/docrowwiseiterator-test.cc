@@ -26,6 +26,8 @@
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
 
+#include "yb/rocksdb/statistics.h"
+
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/util/size_literals.h"
@@ -33,6 +35,7 @@
 #include "yb/util/test_util.h"
 
 DECLARE_bool(TEST_docdb_sort_weak_intents_in_tests);
+DECLARE_bool(use_docdb_aware_bloom_filter);
 
 namespace yb {
 namespace docdb {
@@ -609,6 +612,105 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorIncompleteProjection) {
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, SeekTupleForward) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  auto dwb = MakeDocWriteBatch();
+
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000)));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(encoded_doc_key3, PrimitiveValue(40_ColId)),
+      PrimitiveValue(30000)));
+
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"d"}, &projection));
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey1.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ(10000, value.int64_value());
+
+  // Skip row2 and go straight to row3.
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTupleForward(encoded_doc_key3.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ(30000, value.int64_value());
+
+  // Key that does not exist after the last row.
+  const KeyBytes encoded_doc_key4(DocKey(PrimitiveValues("row4", 44444)).Encode());
+  ASSERT_FALSE(ASSERT_RESULT(iter.SeekTupleForward(encoded_doc_key4.AsSlice())));
+
+  // A regular seek still allows going back.
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey2.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ(20000, value.int64_value());
+}
+
+TEST_F(DocRowwiseIteratorTest, InitForTupleIds) {
+  const KeyBytes encoded_doc_key3(DocKey(PrimitiveValues("row3", 33333)).Encode());
+  const KeyBytes encoded_doc_key5(DocKey(PrimitiveValues("row5", 55555)).Encode());
+
+  // Put every row into its own SST file, so that bloom filters can exclude files.
+  for (const auto& key_and_value : {std::make_pair(&kEncodedDocKey1, 10000),
+                                    std::make_pair(&kEncodedDocKey2, 20000),
+                                    std::make_pair(&encoded_doc_key3, 30000),
+                                    std::make_pair(&encoded_doc_key5, 50000)}) {
+    auto dwb = MakeDocWriteBatch();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(*key_and_value.first, PrimitiveValue(40_ColId)),
+        PrimitiveValue(key_and_value.second)));
+    ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"d"}, &projection));
+
+  const auto bloom_useful_before =
+      regular_db_options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.InitForTupleIds({kEncodedDocKey1.AsSlice(), encoded_doc_key3.AsSlice()}));
+
+  // The iterator is positioned at the first tuple right after Init.
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_EQ(kEncodedDocKey1.AsSlice(), ASSERT_RESULT(iter.GetTupleId()));
+
+  QLTableRow row;
+  QLValue value;
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTupleForward(kEncodedDocKey1.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ(10000, value.int64_value());
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTupleForward(encoded_doc_key3.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+  ASSERT_EQ(30000, value.int64_value());
+
+  if (FLAGS_use_docdb_aware_bloom_filter) {
+    // Files holding only row2 and row5 do not match any of the requested tuples.
+    ASSERT_GT(regular_db_options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL),
+              bloom_useful_before);
+  }
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorMultipleDeletes) {
   auto dwb = MakeDocWriteBatch();
 
@@ -1224,5 +1326,74 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_EQ(intents_db_options_.statistics->getTickerCount(rocksdb::Tickers::NUMBER_DB_SEEK), 6);
 }
 
+TEST_F(DocRowwiseIteratorTest, PartitionTombstone) {
+  const Schema schema({
+          ColumnSchema("h", DataType::STRING, /* is_nullable = */ false, /* is_hash_key = */ true),
+          ColumnSchema("r", DataType::STRING, false),
+          // Non-key columns
+          ColumnSchema("v", DataType::INT64, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId
+      }, 2);
+  Schema projection;
+  ASSERT_OK(schema.CreateProjectionByNames({"v"}, &projection));
+
+  constexpr uint16_t kHash = 0x1234;
+  const std::vector<PrimitiveValue> hashed_components = { PrimitiveValue("h1") };
+  auto row_key = [&hashed_components](const char* range_value) {
+    return DocKey(kHash, hashed_components, { PrimitiveValue(range_value) }).Encode();
+  };
+
+  // Simulate CQL:
+  //   INSERT INTO t (h, r, v) VALUES ('h1', 'r1', 1), ('h1', 'r2', 2);
+  //   DELETE FROM t WHERE h = 'h1';
+  //   INSERT INTO t (h, r, v) VALUES ('h1', 'r3', 3);
+  ASSERT_OK(SetPrimitive(
+      DocPath(row_key("r1"), PrimitiveValue(30_ColId)), PrimitiveValue(1), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(row_key("r2"), PrimitiveValue(30_ColId)), PrimitiveValue(2), 2000_usec_ht));
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.DeleteHashPartition(DocKey(kHash, hashed_components).Encode().AsSlice()));
+  ASSERT_OK(WriteToRocksDBAndClear(&dwb, 3000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(row_key("r3"), PrimitiveValue(30_ColId)), PrimitiveValue(3), 4000_usec_ht));
+
+  // Plain Init is used by backfill and checksum scans, the QL scan spec by regular reads. All of
+  // them must skip the rows covered by the partition tombstone.
+  auto read_values = [&](HybridTime read_ht, bool use_scan_spec) -> Result<std::vector<int64_t>> {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::SingleTime(read_ht));
+    // The scan spec reads the partition, as SELECT * FROM t WHERE h = 'h1' does.
+    DocQLScanSpec spec(
+        schema, kHash, kHash, hashed_components, /* req */ nullptr, /* if_req */ nullptr,
+        rocksdb::kDefaultQueryId);
+    if (use_scan_spec) {
+      RETURN_NOT_OK(iter.Init(spec));
+    } else {
+      RETURN_NOT_OK(iter.Init());
+    }
+    std::vector<int64_t> result;
+    QLTableRow row;
+    QLValue value;
+    while (VERIFY_RESULT(iter.HasNext())) {
+      RETURN_NOT_OK(iter.NextRow(&row));
+      RETURN_NOT_OK(row.GetValue(projection.column_id(0), &value));
+      result.push_back(value.int64_value());
+    }
+    return result;
+  };
+
+  for (bool use_scan_spec : {false, true}) {
+    SCOPED_TRACE(Format("use_scan_spec: $0", use_scan_spec));
+    auto values = ASSERT_RESULT(read_values(2500_usec_ht, use_scan_spec));
+    ASSERT_EQ(std::vector<int64_t>({1, 2}), values);
+    values = ASSERT_RESULT(read_values(5000_usec_ht, use_scan_spec));
+    ASSERT_EQ(std::vector<int64_t>({3}), values);
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/pgsql_operation.h"
 
+#include <numeric>
+
 #include <boost/optional/optional_io.hpp>
 
 #include "yb/common/partition.h"
@@ -36,6 +38,18 @@ DECLARE_bool(ysql_disable_index_backfill);
 DEFINE_double(ysql_scan_timeout_multiplier, 0.5,
               "YSQL read scan timeout multipler of retryable_rpc_single_call_timeout_ms.");
 
+DEFINE_bool(ysql_enable_vectorized_aggregates, true,
+            "Evaluate pushed down COUNT, SUM, MIN and MAX over columns a batch of rows at a time "
+            "instead of through the generic expression executor.");
+TAG_FLAG(ysql_enable_vectorized_aggregates, advanced);
+TAG_FLAG(ysql_enable_vectorized_aggregates, runtime);
+
+DEFINE_bool(ysql_enable_ybctid_batch_forward_seek, true,
+            "Read a batch of ybctids with a single iterator that visits them in key order, instead "
+            "of creating and seeking a new iterator for every ybctid.");
+TAG_FLAG(ysql_enable_ybctid_batch_forward_seek, advanced);
+TAG_FLAG(ysql_enable_ybctid_batch_forward_seek, runtime);
+
 DEFINE_test_flag(int32, slowdown_pgsql_aggregate_read_ms, 0,
                  "If set > 0, slows down the response to pgsql aggregate read by this amount.");
 
@@ -430,6 +444,10 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
   });
   VLOG(4) << "Read, read time: " << read_time << ", txn: " << txn_op_context_;
 
+  if (request_.rows_data_format() == PGSQL_ROWS_DATA_COLUMNAR) {
+    columnar_writer_.emplace(request_.targets_size());
+  }
+
   // Fetching data.
   bool has_paging_state = false;
   if (request_.batch_arguments_size() > 0) {
@@ -447,6 +465,12 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
                                                result_buffer, restart_read_ht, &has_paging_state));
   }
 
+  if (columnar_writer_) {
+    DCHECK_EQ(columnar_writer_->row_count(), fetched_rows);
+    columnar_writer_->Serialize(result_buffer);
+    response_.set_rows_data_format(PGSQL_ROWS_DATA_COLUMNAR);
+  }
+
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows. $1 paging state", fetched_rows, (has_paging_state ? "No" : "Has"));
   }
@@ -611,19 +635,81 @@ Result<size_t> PgsqlReadOperation::ExecuteBatchYbctid(const common::YQLStorageIf
 
   QLTableRow row;
   size_t row_count = 0;
-  for (const PgsqlBatchArgumentPB& batch_argument : request_.batch_arguments()) {
-    // Get the row.
-    RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
-                                         deadline, read_time, batch_argument.ybctid().value(),
-                                         &table_iter_));
-    row.Clear();
+  if (!FLAGS_ysql_enable_ybctid_batch_forward_seek) {
+    for (const PgsqlBatchArgumentPB& batch_argument : request_.batch_arguments()) {
+      // Get the row.
+      RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
+                                           deadline, read_time, batch_argument.ybctid().value(),
+                                           &table_iter_));
+      row.Clear();
+
+      SCHECK(VERIFY_RESULT(table_iter_->HasNext()), Corruption,
+             "Given ybctid is not associated with any row in table");
+      RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
 
-    SCHECK(VERIFY_RESULT(table_iter_->HasNext()), Corruption,
-           "Given ybctid is not associated with any row in table");
-    RETURN_NOT_OK(table_iter_->NextRow(projection, &row));
+      // Populate result set.
+      RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
+      row_count++;
+    }
 
-    // Populate result set.
-    RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
+    // Set status for this batch.
+    response_.set_batch_arg_count(row_count);
+    return row_count;
+  }
+
+  // Visit ybctids in key order, so that the iterator only moves forward and nearby rows are
+  // reached by Next instead of Seek.
+  const auto& batch_arguments = request_.batch_arguments();
+  auto ybctid_at = [&batch_arguments](int index) {
+    return Slice(batch_arguments.Get(index).ybctid().value().binary_value());
+  };
+  std::vector<int> seek_order(batch_arguments.size());
+  std::iota(seek_order.begin(), seek_order.end(), 0);
+  auto ybctid_less = [&ybctid_at](int lhs, int rhs) {
+    return ybctid_at(lhs).compare(ybctid_at(rhs)) < 0;
+  };
+  // Rows have to be returned in the order of batch arguments. When ybctids arrive unsorted, rows
+  // are buffered and populated after all of them are read.
+  const bool sorted = std::is_sorted(seek_order.begin(), seek_order.end(), ybctid_less);
+  std::vector<QLTableRow> rows;
+  if (!sorted) {
+    std::sort(seek_order.begin(), seek_order.end(), ybctid_less);
+    rows.resize(seek_order.size());
+  }
+
+  std::vector<Slice> sorted_ybctids;
+  sorted_ybctids.reserve(seek_order.size());
+  for (int index : seek_order) {
+    sorted_ybctids.push_back(ybctid_at(index));
+  }
+  RETURN_NOT_OK(ql_storage.GetIteratorForYbctidBatch(projection, schema, txn_op_context_,
+                                                     deadline, read_time, sorted_ybctids,
+                                                     &table_iter_));
+
+  for (size_t i = 0; i != seek_order.size(); ++i) {
+    const Slice ybctid = sorted_ybctids[i];
+    QLTableRow* current_row = sorted ? &row : &rows[seek_order[i]];
+    if (i > 0 && ybctid == sorted_ybctids[i - 1]) {
+      // The iterator has already moved past this row, reuse the one read for the same ybctid.
+      if (!sorted) {
+        *current_row = rows[seek_order[i - 1]];
+      }
+    } else {
+      current_row->Clear();
+      // The iterator is already positioned at the first ybctid, so it only has to move forward.
+      const bool found = VERIFY_RESULT(table_iter_->SeekTupleForward(ybctid));
+      SCHECK(found, Corruption, "Given ybctid is not associated with any row in table");
+      RETURN_NOT_OK(table_iter_->NextRow(projection, current_row));
+    }
+
+    if (sorted) {
+      RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
+      row_count++;
+    }
+  }
+
+  for (const QLTableRow& buffered_row : rows) {
+    RETURN_NOT_OK(PopulateResultSet(buffered_row, result_buffer));
     row_count++;
   }
 
@@ -674,13 +760,26 @@ Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIte
 Status PgsqlReadOperation::PopulateResultSet(const QLTableRow& table_row,
                                              faststring *result_buffer) {
   QLExprResult result;
+  size_t column_index = 0;
   for (const PgsqlExpressionPB& expr : request_.targets()) {
     RETURN_NOT_OK(EvalExpr(expr, table_row, result.Writer()));
-    RETURN_NOT_OK(pggate::WriteColumn(result.Value(), result_buffer));
+    RETURN_NOT_OK(WriteResultColumn(column_index++, result.Value(), result_buffer));
+  }
+  if (columnar_writer_) {
+    columnar_writer_->FinishRow();
   }
   return Status::OK();
 }
 
+Status PgsqlReadOperation::WriteResultColumn(size_t column_index,
+                                             const QLValuePB& value,
+                                             faststring *result_buffer) {
+  if (columnar_writer_) {
+    return columnar_writer_->WriteColumn(column_index, value);
+  }
+  return pggate::WriteColumn(value, result_buffer);
+}
+
 Status PgsqlReadOperation::GetTupleId(QLValue *result) const {
   // Get row key and save to QLValue.
   // TODO(neil) Check if we need to append a table_id and other info to TupleID. For example, we
@@ -695,6 +794,13 @@ Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
   if (aggr_result_.empty()) {
     int column_count = request_.targets().size();
     aggr_result_.resize(column_count);
+    if (FLAGS_ysql_enable_vectorized_aggregates) {
+      vector_aggregator_.Prepare(request_.targets());
+    }
+  }
+
+  if (vector_aggregator_.prepared()) {
+    return vector_aggregator_.AddRow(table_row);
   }
 
   int aggr_index = 0;
@@ -706,9 +812,17 @@ Status PgsqlReadOperation::EvalAggregate(const QLTableRow& table_row) {
 
 Status PgsqlReadOperation::PopulateAggregate(const QLTableRow& table_row,
                                              faststring *result_buffer) {
+  if (vector_aggregator_.prepared()) {
+    RETURN_NOT_OK(vector_aggregator_.GetResults(&aggr_result_));
+  }
+
   int column_count = request_.targets().size();
   for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
-    RETURN_NOT_OK(pggate::WriteColumn(aggr_result_[rscol_index].Value(), result_buffer));
+    RETURN_NOT_OK(WriteResultColumn(rscol_index, aggr_result_[rscol_index].Value(),
+                                    result_buffer));
+  }
+  if (columnar_writer_) {
+    columnar_writer_->FinishRow();
   }
   return Status::OK();
 }
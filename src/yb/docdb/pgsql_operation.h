@@ -19,6 +19,9 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_pgsql_aggregate.h"
+
+#include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
 
@@ -186,6 +189,12 @@ class PgsqlReadOperation : public DocExprExecutor {
   CHECKED_STATUS PopulateResultSet(const QLTableRow& table_row,
                                    faststring *result_buffer);
 
+  // Write one column of the current result row, either to the row-wise result buffer or to the
+  // columnar writer when columnar format is requested.
+  CHECKED_STATUS WriteResultColumn(size_t column_index,
+                                   const QLValuePB& value,
+                                   faststring *result_buffer);
+
   CHECKED_STATUS EvalAggregate(const QLTableRow& table_row);
 
   CHECKED_STATUS PopulateAggregate(const QLTableRow& table_row,
@@ -207,6 +216,12 @@ class PgsqlReadOperation : public DocExprExecutor {
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+
+  // Evaluates aggregate targets a batch of rows at a time when they are simple enough.
+  PgsqlVectorAggregator vector_aggregator_;
+
+  // Collects result rows when the request asks for columnar rows data.
+  boost::optional<pggate::PgDocColumnarWriter> columnar_writer_;
 };
 
 }  // namespace docdb
@@ -145,6 +145,21 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
   return Status::OK();
 }
 
+Status QLRocksDBStorage::GetIteratorForYbctidBatch(
+    const Schema& projection,
+    const Schema& schema,
+    const TransactionOperationContextOpt& txn_op_context,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const std::vector<Slice>& ybctids,
+    common::YQLRowwiseIteratorIf::UniPtr* iter) const {
+  auto doc_iter = std::make_unique<DocRowwiseIterator>(
+      projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  RETURN_NOT_OK(doc_iter->InitForTupleIds(ybctids));
+  *iter = std::move(doc_iter);
+  return Status::OK();
+}
+
 Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
                                      int64_t batch_arg_index,
                                      const Schema& projection,
@@ -82,6 +82,15 @@ class QLRocksDBStorage : public common::YQLStorageIf {
                              const QLValuePB& ybctid,
                              common::YQLRowwiseIteratorIf::UniPtr* iter) const override;
 
+  CHECKED_STATUS GetIteratorForYbctidBatch(
+      const Schema& projection,
+      const Schema& schema,
+      const TransactionOperationContextOpt& txn_op_context,
+      CoarseTimePoint deadline,
+      const ReadHybridTime& read_time,
+      const std::vector<Slice>& ybctids,
+      common::YQLRowwiseIteratorIf::UniPtr* iter) const override;
+
  private:
   const DocDB doc_db_;
 };
@@ -22,6 +22,7 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
@@ -33,6 +34,12 @@ using std::vector;
 using std::stack;
 using std::thread;
 
+METRIC_DEFINE_entity(test_entity);
+METRIC_DEFINE_counter(test_entity, test_contended_locks, "Contended locks",
+                      yb::MetricUnit::kRequests, "Contended locks");
+METRIC_DEFINE_counter(test_entity, test_lock_timeouts, "Lock timeouts",
+                      yb::MetricUnit::kRequests, "Lock timeouts");
+
 namespace yb {
 namespace docdb {
 
@@ -184,5 +191,41 @@ TEST_F(SharedLockManagerTest, LockConflicts) {
   tp.Shutdown();
 }
 
+TEST_F(SharedLockManagerTest, ContentionMetrics) {
+  MetricRegistry registry;
+  auto entity = METRIC_ENTITY_test_entity.Instantiate(&registry, "shared_lock_manager");
+  SharedLockManagerMetrics metrics{
+      METRIC_test_contended_locks.Instantiate(entity),
+      METRIC_test_lock_timeouts.Instantiate(entity)};
+  lm_.SetMetrics(metrics);
+
+  {
+    LockBatch lb = TestLockBatch();
+    ASSERT_OK(lb.status());
+    ASSERT_EQ(0, metrics.contended_locks->value());
+
+    LockBatch lb_fail = TestLockBatch(CoarseMonoClock::now() + 10ms);
+    ASSERT_FALSE(lb_fail.status().ok());
+    ASSERT_EQ(1, metrics.contended_locks->value());
+    ASSERT_EQ(1, metrics.lock_timeouts->value());
+  }
+
+  // Many keys spread over all shards are locked and released as one batch.
+  LockBatchEntries entries;
+  for (int i = 0; i != 100; ++i) {
+    entries.push_back(LockBatchEntry{
+        RefCntPrefix(Format("key_$0", i)),
+        IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead})});
+  }
+  {
+    LockBatch lb(&lm_, LockBatchEntries(entries), CoarseTimePoint::max());
+    ASSERT_OK(lb.status());
+    ASSERT_EQ(100, lb.size());
+  }
+  LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+  ASSERT_OK(lb.status());
+  ASSERT_EQ(1, metrics.contended_locks->value());
+}
+
 } // namespace docdb
 } // namespace yb
@@ -13,14 +13,19 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <array>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <glog/logging.h>
 
+#include "yb/gutil/port.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/tostring.h"
 #include "yb/util/trace.h"
@@ -107,8 +112,8 @@ struct LockedBatchEntry {
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
+  // Refcounting for garbage collection. Can only be used while the mutex of the lock shard that
+  // owns this entry is locked.
   size_t ref_count = 0;
 
   // Number of holders for each type
@@ -116,7 +121,8 @@ struct LockedBatchEntry {
 
   std::atomic<size_t> num_waiters{0};
 
-  MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline);
+  // Increments contended_locks, when specified, if the lock had to wait for conflicting holders.
+  MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline, Counter* contended_locks);
 
   void Unlock(IntentTypeSet lock);
 
@@ -133,29 +139,54 @@ class SharedLockManager::Impl {
   MUST_USE_RESULT bool Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline);
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  void SetMetrics(const SharedLockManagerMetrics& metrics) {
+    metrics_ = metrics;
+  }
+
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty()) << "Locks not empty in dtor: "
+                                           << yb::ToString(shard.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Keys are spread over independent shards, so that batches touching different keys do not
+  // contend on a single mutex while reserving and releasing lock entries.
+  static constexpr size_t kNumShards = 16;
+
+  struct CACHELINE_ALIGNED LockShard {
+    // Taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  };
+
+  static size_t ShardIndex(const RefCntPrefix& key) {
+    return RefCntPrefixHash()(key) % kNumShards;
+  }
+
+  // Invokes action(shard, entry) for each entry of the batch, holding the mutex of the entry's
+  // shard. Each shard touched by the batch is locked only once.
+  template <class Entries, class Action>
+  void ForEachEntryInShards(Entries* key_to_intent_type, const Action& action);
+
+  // Make sure the entries exist in the locks maps and store pointers into the batch, so we can
+  // access them without holding the shard locks.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  std::array<LockShard, kNumShards> shards_;
 
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  SharedLockManagerMetrics metrics_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -180,11 +211,13 @@ std::string SharedLockManager::ToString(const LockState& state) {
   return result;
 }
 
-bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
+bool LockedBatchEntry::Lock(
+    IntentTypeSet lock_type, CoarseTimePoint deadline, Counter* contended_locks) {
   size_t type_idx = lock_type.ToUIntPtr();
   auto& num_holding = this->num_holding;
   auto old_value = num_holding.load(std::memory_order_acquire);
   auto add = kIntentTypeSetAdd[type_idx];
+  bool contended = false;
   for (;;) {
     if ((old_value & kIntentTypeSetConflicts[type_idx]) == 0) {
       auto new_value = old_value + add;
@@ -193,6 +226,12 @@ bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
       }
       continue;
     }
+    if (!contended) {
+      contended = true;
+      if (contended_locks) {
+        contended_locks->Increment();
+      }
+    }
     num_waiters.fetch_add(1, std::memory_order_release);
     auto se = ScopeExit([this] {
       num_waiters.fetch_sub(1, std::memory_order_release);
@@ -259,12 +298,16 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
     const auto intent_types = key_and_intent_type.intent_types;
     VLOG(4) << "Locking " << yb::ToString(intent_types) << ": "
             << key_and_intent_type.key.as_slice().ToDebugHexString();
-    if (!key_and_intent_type.locked->Lock(intent_types, deadline)) {
+    if (!key_and_intent_type.locked->Lock(
+            intent_types, deadline, metrics_.contended_locks.get())) {
       while (it != key_to_intent_type->begin()) {
         --it;
         it->locked->Unlock(it->intent_types);
       }
       Cleanup(*key_to_intent_type);
+      if (metrics_.lock_timeouts) {
+        metrics_.lock_timeouts->Increment();
+      }
       return false;
     }
   }
@@ -273,22 +316,60 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
   return true;
 }
 
+template <class Entries, class Action>
+void SharedLockManager::Impl::ForEachEntryInShards(
+    Entries* key_to_intent_type, const Action& action) {
+  // Bucket entries by shard with a counting sort, so each shard is locked once and entries of a
+  // shard keep their original order.
+  boost::container::small_vector<uint8_t, 16> shard_indexes;
+  shard_indexes.reserve(key_to_intent_type->size());
+  std::array<size_t, kNumShards + 1> shard_begin = {};
+  for (const auto& key_and_intent_type : *key_to_intent_type) {
+    auto shard_index = ShardIndex(key_and_intent_type.key);
+    shard_indexes.push_back(shard_index);
+    ++shard_begin[shard_index + 1];
+  }
+  for (size_t shard_index = 0; shard_index != kNumShards; ++shard_index) {
+    shard_begin[shard_index + 1] += shard_begin[shard_index];
+  }
+
+  boost::container::small_vector<size_t, 16> entry_indexes(key_to_intent_type->size());
+  auto next_position = shard_begin;
+  for (size_t entry_index = 0; entry_index != shard_indexes.size(); ++entry_index) {
+    entry_indexes[next_position[shard_indexes[entry_index]]++] = entry_index;
+  }
+
+  for (size_t shard_index = 0; shard_index != kNumShards; ++shard_index) {
+    auto begin = shard_begin[shard_index];
+    auto end = shard_begin[shard_index + 1];
+    if (begin == end) {
+      continue;
+    }
+    auto& shard = shards_[shard_index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto i = begin; i != end; ++i) {
+      action(&shard, &(*key_to_intent_type)[entry_indexes[i]]);
+    }
+  }
+}
+
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
-  for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
+  ForEachEntryInShards(
+      key_to_intent_type,
+      [](LockShard* shard, LockBatchEntry* key_and_intent_type) NO_THREAD_SAFETY_ANALYSIS {
+    auto& value = shard->locks[key_and_intent_type->key];
     if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
+      if (!shard->free_lock_entries.empty()) {
+        value = shard->free_lock_entries.back();
+        shard->free_lock_entries.pop_back();
       } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+        shard->lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+        value = shard->lock_entries.back().get();
       }
     }
     value->ref_count++;
-    key_and_intent_type.locked = value;
-  }
+    key_and_intent_type->locked = value;
+  });
 }
 
 void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type) {
@@ -302,13 +383,14 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
-  for (const auto& item : key_to_intent_type) {
-    if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+  ForEachEntryInShards(
+      &key_to_intent_type,
+      [](LockShard* shard, const LockBatchEntry* item) NO_THREAD_SAFETY_ANALYSIS {
+    if (--(item->locked->ref_count) == 0) {
+      shard->locks.erase(item->key);
+      shard->free_lock_entries.push_back(item->locked);
     }
-  }
+  });
 }
 
 SharedLockManager::SharedLockManager() : impl_(new Impl) {
@@ -324,5 +406,9 @@ void SharedLockManager::Unlock(const LockBatchEntries& key_to_intent_type) {
   impl_->Unlock(key_to_intent_type);
 }
 
+void SharedLockManager::SetMetrics(const SharedLockManagerMetrics& metrics) {
+  impl_->SetMetrics(metrics);
+}
+
 }  // namespace docdb
 }  // namespace yb
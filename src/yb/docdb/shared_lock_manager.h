@@ -23,11 +23,23 @@
 #include "yb/docdb/shared_lock_manager_fwd.h"
 #include "yb/docdb/lock_batch.h"
 #include "yb/gutil/spinlock.h"
+#include "yb/gutil/ref_counted.h"
 #include "yb/util/cross_thread_mutex.h"
 
 namespace yb {
+
+class Counter;
+
 namespace docdb {
 
+struct SharedLockManagerMetrics {
+  // Number of key locks that found a conflicting holder and had to wait.
+  scoped_refptr<Counter> contended_locks;
+
+  // Number of lock batches that could not be acquired before the deadline.
+  scoped_refptr<Counter> lock_timeouts;
+};
+
 // This class manages six types of locks on string keys. On each key, the possibilities are:
 // - No locks
 // - A single kStrongSnapshotWrite
@@ -49,6 +61,10 @@ class SharedLockManager {
   // Release the batch of locks. Requires that the locks are held.
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  // Start reporting lock contention to the given metrics. Should be called before the lock
+  // manager is used.
+  void SetMetrics(const SharedLockManagerMetrics& metrics);
+
   // Whether or not the state is possible
   static std::string ToString(const LockState& state);
 
@@ -11,6 +11,8 @@
 // under the License.
 //
 
+#include <algorithm>
+
 #include "yb/integration-tests/cql_test_base.h"
 
 #include "yb/util/random_util.h"
@@ -19,6 +21,9 @@
 using namespace std::literals;
 
 DECLARE_int64(cql_processors_limit);
+DECLARE_bool(disable_index_backfill);
+DECLARE_bool(disable_index_backfill_for_non_txn_tables);
+DECLARE_uint64(index_backfill_upperbound_for_user_enforced_txn_duration_ms);
 
 namespace yb {
 
@@ -47,4 +52,77 @@ TEST_F(CqlTest, ProcessorsLimit) {
   ASSERT_TRUE(has_failures);
 }
 
+namespace {
+
+Result<std::vector<int32_t>> ReadValues(CassandraSession* session, const std::string& query) {
+  auto result = VERIFY_RESULT(session->ExecuteWithResult(query));
+  auto iter = result.CreateIterator();
+  std::vector<int32_t> values;
+  while (iter.Next()) {
+    values.push_back(iter.Row().Value(0).As<cass_int32_t>());
+  }
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+} // namespace
+
+TEST_F(CqlTest, PartitionTombstone) {
+  FLAGS_disable_index_backfill = false;
+  FLAGS_disable_index_backfill_for_non_txn_tables = false;
+  FLAGS_index_backfill_upperbound_for_user_enforced_txn_duration_ms = 100;
+
+  auto session = ASSERT_RESULT(EstablishSession(driver_.get()));
+  ASSERT_OK(session.ExecuteQuery(
+      "CREATE TABLE t (h INT, r INT, v INT, l LIST<INT>, PRIMARY KEY ((h), r)) "
+      "WITH partition_tombstones = true"));
+  for (int r = 1; r <= 3; ++r) {
+    ASSERT_OK(session.ExecuteQuery(
+        Format("INSERT INTO t (h, r, v, l) VALUES (1, $0, $0, [$0])", r)));
+    ASSERT_OK(session.ExecuteQuery(
+        Format("INSERT INTO t (h, r, v) VALUES (2, $0, $1)", r, r + 10)));
+  }
+
+  // Deletes the whole partition with a single partition tombstone, then reinserts one row.
+  ASSERT_OK(session.ExecuteQuery("DELETE FROM t WHERE h = 1"));
+  ASSERT_OK(session.ExecuteQuery("INSERT INTO t (h, r, v) VALUES (1, 4, 4)"));
+
+  // List elements were deleted with their rows.
+  ASSERT_NOK(session.ExecuteQuery("UPDATE t SET l[0] = 10 WHERE h = 1 AND r = 1"));
+
+  ASSERT_EQ(std::vector<int32_t>({4}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t WHERE h = 1")));
+  ASSERT_EQ(std::vector<int32_t>({4}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t WHERE h = 1 AND r >= 2")));
+  ASSERT_EQ(std::vector<int32_t>(),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t WHERE h = 1 AND r = 2")));
+  ASSERT_EQ(std::vector<int32_t>({4, 11, 12, 13}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t")));
+
+  // Reads keep honoring the partition tombstone after the table stops writing them.
+  ASSERT_OK(session.ExecuteQuery("ALTER TABLE t WITH partition_tombstones = false"));
+  ASSERT_EQ(std::vector<int32_t>({4, 11, 12, 13}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t")));
+
+  // Backfill scans the table with a plain iterator, it should not resurrect deleted rows.
+  ASSERT_OK(session.ExecuteQuery(
+      "CREATE INDEX idx ON t (v) WITH transactions = { 'enabled' : false, "
+      "'consistency_level' : 'user_enforced' }"));
+  constexpr auto kNamespace = "test";
+  const client::YBTableName table_name(YQL_DATABASE_CQL, kNamespace, "t");
+  const client::YBTableName index_table_name(YQL_DATABASE_CQL, kNamespace, "idx");
+  auto perm = ASSERT_RESULT(client_->WaitUntilIndexPermissionsAtLeast(
+      table_name, index_table_name, IndexPermissions::INDEX_PERM_READ_WRITE_AND_DELETE));
+  ASSERT_EQ(perm, IndexPermissions::INDEX_PERM_READ_WRITE_AND_DELETE);
+
+  for (int v = 1; v <= 3; ++v) {
+    ASSERT_EQ(std::vector<int32_t>(),
+              ASSERT_RESULT(ReadValues(&session, Format("SELECT v FROM t WHERE v = $0", v))));
+  }
+  ASSERT_EQ(std::vector<int32_t>({4}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t WHERE v = 4")));
+  ASSERT_EQ(std::vector<int32_t>({12}),
+            ASSERT_RESULT(ReadValues(&session, "SELECT v FROM t WHERE v = 12")));
+}
+
 } // namespace yb
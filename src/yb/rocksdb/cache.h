@@ -66,6 +66,14 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with the same parameters and scan resistance as NewLRUCache, that
+// approximates LRU with the CLOCK algorithm. Lookups do not need exclusive access to a shard,
+// so this cache scales better when many threads hit the same shards.
+extern shared_ptr<Cache> NewClockCache(size_t capacity);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
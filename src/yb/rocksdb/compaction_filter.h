@@ -146,6 +146,20 @@ class CompactionFilter {
   virtual const char* Name() const = 0;
 };
 
+// Decides whether SST files could be deleted without being compacted, i.e. all their entries
+// would be filtered out and they don't hide any entry of the remaining files.
+class DroppableFilesChecker {
+ public:
+  virtual ~DroppableFilesChecker() {}
+
+  // Adds a file to the dropped ones, files are added from the oldest to the newest.
+  // largest contains largest boundary values of the added file, remaining_smallest - smallest
+  // boundary values over all files newer than it.
+  // Returns true if all files added so far could be dropped.
+  virtual bool AddFile(
+      const FileBoundaryValuesBase& largest, const FileBoundaryValuesBase& remaining_smallest) = 0;
+};
+
 // Each compaction will create a new CompactionFilter allowing the
 // application to know about different compactions
 class CompactionFilterFactory {
@@ -155,6 +169,13 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Returns a checker used by universal compaction to drop the oldest files, see
+  // UniversalCompactionPicker::PickExpiredFilesCompaction. A new checker is created for each
+  // pick. Returns nullptr when files could not be dropped at all.
+  virtual std::unique_ptr<DroppableFilesChecker> NewDroppableFilesChecker() {
+    return nullptr;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
@@ -1151,6 +1151,81 @@ bool UniversalCompactionPicker::NeedsCompaction(
   return vstorage->CompactionScore(kLevel0) >= 1;
 }
 
+size_t UniversalCompactionPicker::NumDroppableFiles(const VersionStorageInfo& vstorage) const {
+  auto* factory = ioptions_.compaction_filter_factory;
+  // Only files of level 0 are checked, so we cannot drop them when older files are present at
+  // other levels.
+  if (factory == nullptr || vstorage.num_non_empty_levels() > 1) {
+    return 0;
+  }
+  const int kLevel0 = 0;
+  // Files are ordered from the newest to the oldest.
+  const auto& files = vstorage.LevelFiles(kLevel0);
+  if (files.empty()) {
+    return 0;
+  }
+  auto checker = factory->NewDroppableFilesChecker();
+  if (!checker) {
+    return 0;
+  }
+
+  // remaining_smallest[i] contains smallest boundary values over files newer than files[i].
+  std::vector<FileBoundaryValuesBase> remaining_smallest(files.size());
+  remaining_smallest[0].seqno = kMaxSequenceNumber;
+  for (size_t i = 1; i != files.size(); ++i) {
+    auto& current = remaining_smallest[i];
+    current = remaining_smallest[i - 1];
+    const auto& smallest = files[i - 1]->smallest;
+    current.seqno = std::min(current.seqno, smallest.seqno);
+    UserFrontier::Update(
+        smallest.user_frontier.get(), UpdateUserValueType::kSmallest, &current.user_frontier);
+    for (const auto& user_value : smallest.user_values) {
+      UpdateUserValue(&current.user_values, user_value, UpdateUserValueType::kSmallest);
+    }
+  }
+
+  size_t result = 0;
+  for (size_t i = files.size(); i-- > 0;) {
+    if (files[i]->being_compacted) {
+      break;
+    }
+    if (checker->AddFile(files[i]->largest, remaining_smallest[i])) {
+      result = files.size() - i;
+    }
+  }
+  return result;
+}
+
+std::unique_ptr<Compaction> UniversalCompactionPicker::PickExpiredFilesCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const auto num_files = NumDroppableFiles(*vstorage);
+  if (num_files == 0) {
+    return nullptr;
+  }
+
+  const int kLevel0 = 0;
+  const auto& level_files = vstorage->LevelFiles(kLevel0);
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  inputs[0].files.assign(level_files.end() - num_files, level_files.end());
+  for (auto* f : inputs[0].files) {
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking expired file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), f->fd.GetNumber(), tmp_fsize);
+  }
+  auto c = std::make_unique<Compaction>(
+      vstorage, mutable_cf_options, std::move(inputs), 0 /* output_level */,
+      0 /* target_file_size */, 0 /* max_grandparent_overlap_bytes */, 0 /* output_path_id */,
+      kNoCompression, std::vector<FileMetaData*>(), /* is manual */ false,
+      vstorage->CompactionScore(kLevel0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+  level0_compactions_in_progress_.insert(c.get());
+  return c;
+}
+
 struct UniversalCompactionPicker::SortedRun {
   SortedRun(int _level, FileMetaData* _file, uint64_t _size,
             uint64_t _compensated_file_size, bool _being_compacted)
@@ -1353,6 +1428,12 @@ std::unique_ptr<Compaction> UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  auto expired_files_compaction = PickExpiredFilesCompaction(
+      cf_name, mutable_cf_options, vstorage, log_buffer);
+  if (expired_files_compaction) {
+    return expired_files_compaction;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
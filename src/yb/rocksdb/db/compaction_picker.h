@@ -271,6 +271,16 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Picks the longest sequence of the oldest files that could be deleted without compaction,
+  // according to CompactionFilterFactory::NewDroppableFilesChecker. Returns deletion compaction
+  // for them.
+  std::unique_ptr<Compaction> PickExpiredFilesCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Returns number of the oldest level 0 files that could be deleted without compaction.
+  size_t NumDroppableFiles(const VersionStorageInfo& vstorage) const;
+
   // Pick Universal compaction to limit read amplification
   std::unique_ptr<Compaction> PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
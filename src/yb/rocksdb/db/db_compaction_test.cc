@@ -30,10 +30,16 @@
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/testutil.h"
 
+#include "yb/util/countdown_latch.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/random_util.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/test_util.h"
 
 DECLARE_bool(flush_rocksdb_on_shutdown);
+DECLARE_bool(use_priority_thread_pool_for_compactions);
+DECLARE_bool(use_priority_thread_pool_for_flushes);
+DECLARE_int32(slowdown_writes_compaction_extra_priority);
 
 using std::atomic;
 using namespace std::literals;
@@ -916,6 +922,90 @@ TEST_P(DBCompactionTestWithParam, CompactionsGenerateMultipleFiles) {
   }
 }
 
+namespace {
+
+// Occupies a worker of the priority thread pool until the latch is released.
+class BlockingPriorityTask : public yb::PriorityThreadPoolTask {
+ public:
+  explicit BlockingPriorityTask(yb::CountDownLatch* latch) : latch_(latch) {}
+
+  void Run(const Status& status, yb::PriorityThreadPoolSuspender* suspender) override {
+    if (status.ok()) {
+      latch_->Wait();
+    }
+  }
+
+  bool BelongsTo(void* key) override {
+    return false;
+  }
+
+  std::string ToString() const override {
+    return "{ blocking task }";
+  }
+
+ private:
+  yb::CountDownLatch* const latch_;
+};
+
+} // namespace
+
+TEST_F(DBCompactionTest, SlowdownWritesCompactionPriority) {
+  google::FlagSaver flag_saver;
+  FLAGS_use_priority_thread_pool_for_compactions = true;
+  FLAGS_use_priority_thread_pool_for_flushes = false;
+  FLAGS_slowdown_writes_compaction_extra_priority = 10;
+
+  // Keep compactions queued in the pool, so their priorities could be checked.
+  yb::PriorityThreadPool thread_pool(1);
+  yb::CountDownLatch latch(1);
+  std::unique_ptr<yb::PriorityThreadPoolTask> blocking_task =
+      std::make_unique<BlockingPriorityTask>(&latch);
+  ASSERT_OK(thread_pool.Submit(1000, &blocking_task));
+  auto se = yb::ScopeExit([this, &latch] {
+    latch.CountDown();
+    Close();
+  });
+
+  Options options = CurrentOptions();
+  options.priority_thread_pool_for_compactions_and_flushes = &thread_pool;
+  options.level0_file_num_compaction_trigger = 2;
+  options.level0_slowdown_writes_trigger = 4;
+  options.level0_stop_writes_trigger = 100;
+  options.soft_pending_compaction_bytes_limit = 0;
+  options.hard_pending_compaction_bytes_limit = 0;
+  DestroyAndReopen(options);
+
+  auto compaction_priority = [&thread_pool]() -> int {
+    for (const auto& info : thread_pool.TasksInfo()) {
+      if (info.task.find("compact db") != std::string::npos) {
+        return info.priority;
+      }
+    }
+    return -1;
+  };
+
+  for (int i = 0; i != options.level0_file_num_compaction_trigger; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+    ASSERT_OK(Flush());
+  }
+  int initial_priority = -1;
+  ASSERT_OK(yb::WaitFor([&] {
+    initial_priority = compaction_priority();
+    return initial_priority >= 0;
+  }, 10s, "Compaction queued"));
+
+  // Reach level0_slowdown_writes_trigger while the compaction is waiting in the queue.
+  for (int i = options.level0_file_num_compaction_trigger;
+       i != options.level0_slowdown_writes_trigger; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(yb::WaitFor([&] {
+    return compaction_priority() ==
+           initial_priority + FLAGS_slowdown_writes_compaction_extra_priority;
+  }, 10s, "Compaction priority raised"));
+}
+
 TEST_F(DBCompactionTest, MinorCompactionsHappen) {
   do {
     Options options;
@@ -156,6 +156,10 @@ DEFINE_int32(compaction_priority_step_size, 5,
 DEFINE_int32(small_compaction_extra_priority, 1,
              "Small compaction will get small_compaction_extra_priority extra priority.");
 
+DEFINE_int32(slowdown_writes_compaction_extra_priority, 2,
+             "Compaction of DB that has enough SST files to slow down writes will get "
+             "slowdown_writes_compaction_extra_priority extra priority.");
+
 DEFINE_bool(rocksdb_use_logging_iterator, false,
             "Wrap newly created RocksDB iterators in a logging wrapper");
 
@@ -250,14 +254,15 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
  public:
   CompactionTask(DBImpl* db_impl, DBImpl::ManualCompaction* manual_compaction)
       : ThreadPoolTask(db_impl), manual_compaction_(manual_compaction),
-        compaction_(manual_compaction->compaction.get()), priority_(CalcPriority()) {
+        compaction_(manual_compaction->compaction.get()), priority_(CalcPriority()),
+        input_size_(compaction_->CalculateTotalInputSize()) {
     db_impl->mutex_.AssertHeld();
   }
 
   CompactionTask(DBImpl* db_impl, std::unique_ptr<Compaction> compaction)
       : ThreadPoolTask(db_impl), manual_compaction_(nullptr),
         compaction_holder_(std::move(compaction)), compaction_(compaction_holder_.get()),
-        priority_(CalcPriority()) {
+        priority_(CalcPriority()), input_size_(compaction_->CalculateTotalInputSize()) {
     db_impl->mutex_.AssertHeld();
   }
 
@@ -284,7 +289,9 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
   }
 
   std::string ToString() const override {
-    return yb::Format("{ compact db: $0 }", db_impl_->GetName());
+    return yb::Format(
+        "{ compact db: $0 input_size: $1 manual: $2 }", db_impl_->GetName(), input_size_,
+        manual_compaction_ != nullptr);
   }
 
   bool UpdatePriority() override {
@@ -334,6 +341,10 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
       result += FLAGS_small_compaction_extra_priority;
     }
 
+    if (num_files >= compaction_->mutable_cf_options()->level0_slowdown_writes_trigger) {
+      result += FLAGS_slowdown_writes_compaction_extra_priority;
+    }
+
     return result;
   }
 
@@ -342,6 +353,7 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
   std::unique_ptr<Compaction> compaction_holder_;
   Compaction* compaction_;
   int priority_;
+  const uint64_t input_size_;
 };
 
 class DBImpl::FlushTask : public ThreadPoolTask {
@@ -3504,8 +3516,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     // file if there is alive snapshot pointing to it
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
-    assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+    assert(c->column_family_data()->ioptions()->compaction_style == kCompactionStyleFIFO ||
+           c->compaction_reason() == CompactionReason::kUniversalExpiredFiles);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -5301,6 +5301,52 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+// Writers of a parallel group insert into the memtable concurrently and keep single deletions in
+// it instead of erasing the deleted key. Check that the memtable and the WAL replayed on reopen
+// still see the keys as deleted.
+TEST_F(DBTest, ConcurrentMemtableSingleDelete) {
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  options.memtable_factory.reset(new SkipListFactory(0, ConcurrentWrites::kTrue));
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i != kNumKeys; ++i) {
+        auto key = "k" + ToString(t) + "_" + ToString(i);
+        ASSERT_OK(Put(key, "v"));
+        if (i % 2 == 0) {
+          ASSERT_OK(SingleDelete(key));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto check_keys = [this] {
+    for (int t = 0; t != kNumThreads; ++t) {
+      for (int i = 0; i != kNumKeys; ++i) {
+        ASSERT_EQ(i % 2 == 0 ? "NOT_FOUND" : "v", Get("k" + ToString(t) + "_" + ToString(i)));
+      }
+    }
+  };
+  ASSERT_NO_FATAL_FAILURE(check_keys());
+
+  // Replay the WAL.
+  Reopen(options);
+  ASSERT_NO_FATAL_FAILURE(check_keys());
+
+  ASSERT_OK(Flush());
+  ASSERT_NO_FATAL_FAILURE(check_keys());
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
@@ -33,9 +33,11 @@ int main() {
 }
 #else
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <thread>
 #include <type_traits>
 #include <vector>
@@ -51,7 +53,7 @@ int main() {
 #include "yb/rocksdb/memtablerep.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/slice_transform.h"
-#include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -64,6 +66,9 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- write N random values from num_threads "
+              "threads\n"
+              "\t                          inserting concurrently\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
@@ -124,6 +129,14 @@ DEFINE_int32(num_scans, 10,
 
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_bool(docdb_keys, false,
+            "Shape keys like DocDB keys of a table with a hash and a range column: "
+            "hash, row id, column id and hybrid time. Otherwise keys are 8-byte integers.");
+
+DEFINE_int32(docdb_columns_per_row, 4,
+             "Number of consecutive keys that belong to the same DocDB row when --docdb_keys "
+             "is set");
+
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -191,14 +204,16 @@ class KeyGenerator {
     }
   }
 
+  // Could be called from multiple threads. Keys returned in SEQUENTIAL and UNIQUE_RANDOM modes
+  // are still unique in that case.
   uint64_t Next() {
     switch (mode_) {
       case SEQUENTIAL:
-        return next_++;
+        return next_.fetch_add(1, std::memory_order_relaxed);
       case RANDOM:
         return rand_->Next() % num_;
       case UNIQUE_RANDOM:
-        return values_[next_++];
+        return values_[next_.fetch_add(1, std::memory_order_relaxed)];
     }
     assert(false);
     return std::numeric_limits<uint64_t>::max();
@@ -208,10 +223,42 @@ class KeyGenerator {
   Random64* rand_;
   WriteMode mode_;
   const uint64_t num_;
-  uint64_t next_;
+  std::atomic<uint64_t> next_;
   std::vector<uint64_t> values_;
 };
 
+// Appends the user key for key number `key` to `dst`.
+//
+// DocDB keys consist of the 16-bit hash of the hash column, the row id as a range column and the
+// column id, each prefixed with its value type, followed by the hybrid time of the write. All
+// columns of a row share a long common prefix, which is what makes DocDB key comparisons in the
+// memtable more expensive than comparisons of fixed 8-byte keys.
+void AppendUserKey(uint64_t key, std::string* dst) {
+  if (!FLAGS_docdb_keys) {
+    PutFixed64(dst, key);
+    return;
+  }
+  const uint64_t columns_per_row = std::max(FLAGS_docdb_columns_per_row, 1);
+  const uint64_t row = key / columns_per_row;
+  const uint16_t hash = static_cast<uint16_t>((row * 0x9E3779B97F4A7C15ULL) >> 48);
+  char buf[8];
+
+  dst->push_back('G');  // kUInt16Hash
+  dst->push_back(static_cast<char>(hash >> 8));
+  dst->push_back(static_cast<char>(hash));
+  dst->push_back('I');  // kInt64
+  EncodeFixed64(buf, row ^ (1ULL << 63));
+  std::reverse(buf, buf + 8);
+  dst->append(buf, 8);
+  dst->push_back('!');  // kGroupEnd after hashed components
+  dst->push_back('!');  // kGroupEnd after range components
+  dst->push_back('K');  // kColumnId
+  dst->push_back(static_cast<char>(key % columns_per_row));
+  dst->push_back('#');  // kHybridTime, encoded in descending order
+  EncodeFixed64(buf, ~key);
+  dst->append(buf, 8);
+}
+
 class BenchmarkThread {
  public:
   explicit BenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -249,24 +296,34 @@ class FillBenchmarkThread : public BenchmarkThread {
                         num_ops, read_hits) {}
 
   void FillOne() {
+    *bytes_written_ += InsertOne(++(*sequence_), /* concurrently= */ false);
+  }
+
+  // Inserts the next key with the specified sequence number, returns the number of bytes written.
+  size_t InsertOne(SequenceNumber sequence, bool concurrently) {
+    user_key_.clear();
+    AppendUserKey(key_gen_->Next(), &user_key_);
     char* buf = nullptr;
-    auto internal_key_size = 16;
+    auto internal_key_size = static_cast<uint32_t>(user_key_.size() + 8);
     auto encoded_len =
         FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
-    auto key = key_gen_->Next();
-    EncodeFixed64(p, key);
-    p += 8;
-    EncodeFixed64(p, ++(*sequence_));
+    memcpy(p, user_key_.data(), user_key_.size());
+    p += user_key_.size();
+    EncodeFixed64(p, sequence);
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
     assert(p == buf + encoded_len);
-    table_->Insert(handle);
-    *bytes_written_ += encoded_len;
+    if (concurrently) {
+      table_->InsertConcurrently(handle);
+    } else {
+      table_->Insert(handle);
+    }
+    return encoded_len;
   }
 
   void operator()() override {
@@ -274,6 +331,32 @@ class FillBenchmarkThread : public BenchmarkThread {
       FillOne();
     }
   }
+
+ private:
+  std::string user_key_;
+};
+
+// Writer that inserts into the memtable concurrently with other writers, like the leader and the
+// followers of a RocksDB write group do when allow_concurrent_memtable_write is set.
+class ParallelFillBenchmarkThread : public FillBenchmarkThread {
+ public:
+  ParallelFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                              uint64_t* bytes_written, uint64_t* bytes_read,
+                              std::atomic<uint64_t>* next_sequence, uint64_t num_ops,
+                              uint64_t* read_hits)
+      : FillBenchmarkThread(table, key_gen, bytes_written, bytes_read, nullptr,
+                            num_ops, read_hits),
+        next_sequence_(next_sequence) {}
+
+  void operator()() override {
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      *bytes_written_ += InsertOne(
+          next_sequence_->fetch_add(1, std::memory_order_relaxed), /* concurrently= */ true);
+    }
+  }
+
+ private:
+  std::atomic<uint64_t>* next_sequence_;
 };
 
 class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
@@ -325,7 +408,7 @@ class ReadBenchmarkThread : public BenchmarkThread {
   void ReadOne() {
     std::string user_key;
     auto key = key_gen_->Next();
-    PutFixed64(&user_key, key);
+    AppendUserKey(key, &user_key);
     LookupKey lookup_key(user_key, *sequence_);
     InternalKeyComparator internal_key_comp(BytewiseComparator());
     CallbackVerifyArgs verify_args;
@@ -335,7 +418,8 @@ class ReadBenchmarkThread : public BenchmarkThread {
     verify_args.comparator = &internal_key_comp;
     table_->Get(lookup_key, &verify_args, callback);
     if (verify_args.found) {
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      auto internal_key_size = static_cast<uint32_t>(user_key.size() + 8);
+      *bytes_read_ += VarintLength(internal_key_size) + internal_key_size + FLAGS_item_size;
       ++*read_hits_;
     }
   }
@@ -359,7 +443,9 @@ class SeqReadBenchmarkThread : public BenchmarkThread {
     std::unique_ptr<MemTableRep::Iterator> iter(table_->GetIterator());
     for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
       // pretend to read the value
-      *bytes_read_ += VarintLength(16) + 16 + FLAGS_item_size;
+      uint32_t internal_key_size;
+      GetVarint32Ptr(iter->key(), iter->key() + 5, &internal_key_size);
+      *bytes_read_ += VarintLength(internal_key_size) + internal_key_size + FLAGS_item_size;
     }
     ++*read_hits_;
   }
@@ -489,6 +575,34 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class ParallelFillBenchmark : public Benchmark {
+ public:
+  explicit ParallelFillBenchmark(MemTableRep* table, KeyGenerator* key_gen,
+                                 uint64_t* sequence)
+      : Benchmark(table, key_gen, sequence, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<std::thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool write,
+                  uint64_t* read_hits) override {
+    std::atomic<uint64_t> next_sequence(*sequence_ + 1);
+    std::vector<uint64_t> thread_bytes_written(FLAGS_num_threads);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(ParallelFillBenchmarkThread(
+          table_, key_gen_, &thread_bytes_written[i], bytes_read, &next_sequence,
+          num_write_ops_per_thread_, read_hits));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto thread_bytes : thread_bytes_written) {
+      *bytes_written += thread_bytes;
+    }
+    *sequence_ = next_sequence.load() - 1;
+  }
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -616,7 +730,7 @@ int main(int argc, char** argv) {
   rocksdb::InternalKeyComparator internal_key_comp(
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
-  rocksdb::Arena arena;
+  rocksdb::ConcurrentArena arena;
   rocksdb::WriteBuffer wb(FLAGS_write_buffer_size);
   rocksdb::MemTableAllocator memtable_allocator(&arena, &wb);
   uint64_t sequence;
@@ -653,6 +767,16 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomconcurrent")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        fprintf(stdout, "%s does not support concurrent inserts\n", FLAGS_memtablerep.c_str());
+        exit(1);
+      }
+      memtablerep.reset(createMemtableRep());
+      key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::UNIQUE_RANDOM,
+                                              FLAGS_num_operations));
+      benchmark.reset(new rocksdb::ParallelFillBenchmark(memtablerep.get(),
+                                                         key_gen.get(), &sequence));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
                                               FLAGS_num_operations));
@@ -704,8 +704,11 @@ class MemTableInserter : public WriteBatch::Handler {
       return seek_status;
     }
     MemTable* mem = cf_mems_->GetMemTable();
+    // In-memory erase is not supported by memtables that allow concurrent inserts, and
+    // MemTable::Erase uses a buffer shared by all inserters.
     if ((delete_type == ValueType::kTypeSingleDeletion ||
          delete_type == ValueType::kTypeColumnFamilySingleDeletion) &&
+        !insert_flags_.Test(InsertFlag::kConcurrentMemtableWrites) &&
         mem->Erase(key)) {
       return Status::OK();
     }
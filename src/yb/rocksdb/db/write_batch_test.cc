@@ -251,6 +251,56 @@ struct TestHandler : public WriteBatch::Handler {
 
 } // namespace
 
+// Concurrent inserters don't erase single deleted keys from the memtable, so the single deletion
+// is added to the memtable next to the put, and the batch written to the WAL stays the same.
+TEST_F(WriteBatchTest, SingleDeletionConcurrentMemtableWrites) {
+  InternalKeyComparator cmp(BytewiseComparator());
+  Options options;
+  options.memtable_factory = std::make_shared<SkipListFactory>(0, ConcurrentWrites::kTrue);
+  options.allow_concurrent_memtable_write = true;
+  ImmutableCFOptions ioptions(options);
+  WriteBuffer wb(options.db_write_buffer_size);
+  MemTable* mem =
+      new MemTable(cmp, ioptions, MutableCFOptions(options, ioptions), &wb,
+                   kMaxSequenceNumber);
+  mem->Ref();
+  ColumnFamilyMemTablesDefault cf_mems_default(mem);
+  InsertFlags insert_flags{InsertFlag::kConcurrentMemtableWrites};
+
+  WriteBatch put_batch;
+  WriteBatchInternal::SetSequence(&put_batch, 100);
+  put_batch.Put("a", "va");
+  put_batch.Put("b", "vb");
+  ASSERT_OK(WriteBatchInternal::InsertInto(
+      &put_batch, &cf_mems_default, nullptr, false, 0, nullptr, insert_flags));
+
+  WriteBatch delete_batch;
+  WriteBatchInternal::SetSequence(&delete_batch, 102);
+  delete_batch.SingleDelete("a");
+  ASSERT_OK(WriteBatchInternal::InsertInto(
+      &delete_batch, &cf_mems_default, nullptr, false, 0, nullptr, insert_flags));
+
+  TestHandler handler;
+  ASSERT_OK(delete_batch.Iterate(&handler));
+  ASSERT_EQ("SingleDelete(a)", handler.seen);
+  ASSERT_EQ(1, delete_batch.Count());
+
+  std::string state;
+  Arena arena;
+  ScopedArenaIterator iter(mem->NewIterator(ReadOptions(), &arena));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ParsedInternalKey ikey;
+    ASSERT_TRUE(ParseInternalKey(iter->key(), &ikey));
+    state.append(ikey.type == kTypeSingleDeletion ? "SingleDelete(" : "Put(");
+    state.append(ikey.user_key.ToString());
+    state.append(")@");
+    state.append(NumberToString(ikey.sequence));
+  }
+  ASSERT_EQ("SingleDelete(a)@102Put(a)@100Put(b)@101", state);
+  ASSERT_EQ(3, mem->num_entries());
+  delete mem->Unref();
+}
+
 TEST_F(WriteBatchTest, PutNotImplemented) {
   WriteBatch batch;
   batch.Put(Slice("k1"), Slice("v1"));
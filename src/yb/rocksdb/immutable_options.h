@@ -133,6 +133,8 @@ struct ImmutableCFOptions {
 
   std::shared_ptr<yb::MemTracker> block_based_table_mem_tracker;
 
+  std::shared_ptr<yb::MemTracker> pinned_index_and_filter_mem_tracker;
+
   std::shared_ptr<IteratorReplacer> iterator_replacer;
 };
 
@@ -74,6 +74,8 @@ enum class CompactionReason {
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
   kFilesMarkedForCompaction,
+  // [Universal] Oldest files contain only expired entries and are deleted without compaction
+  kUniversalExpiredFiles,
 };
 
 #ifndef ROCKSDB_LITE
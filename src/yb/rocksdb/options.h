@@ -1098,6 +1098,12 @@ struct DBOptions {
   // Default: true
   bool allow_os_buffer;
 
+  // Read SST files with O_DIRECT, bypassing the OS page cache, so blocks are cached only once, in
+  // the block cache. Applies to both user reads and compaction inputs. Files are read in buffered
+  // mode when the file system does not support O_DIRECT. Ignored when allow_mmap_reads is set.
+  // Default: false
+  bool use_direct_reads = false;
+
   // Allow the OS to mmap file for reading sst tables. Default: false
   bool allow_mmap_reads;
 
@@ -1347,6 +1353,12 @@ struct DBOptions {
   // Specific mem tracker for block based tables created by this RocksDB instance.
   std::shared_ptr<yb::MemTracker> block_based_table_mem_tracker;
 
+  // If set, top-level data index and fixed-size filter index blocks of block based tables are
+  // pinned in memory for the lifetime of table readers and charged to this tracker, instead of
+  // competing with data blocks in the block cache. Blocks that do not fit into the spare capacity
+  // of this tracker are handled as if it was not set.
+  std::shared_ptr<yb::MemTracker> pinned_index_and_filter_mem_tracker;
+
   // Adds ability to modify iterator created for SST file.
   // For instance some additional filtering could be added.
   std::shared_ptr<IteratorReplacer> iterator_replacer;
@@ -35,6 +35,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/iterator.h"
@@ -149,6 +150,18 @@ struct BlockBasedTableOptions {
   // Same as block_restart_interval but used for the index block.
   int index_block_restart_interval = 1;
 
+  // If set, data blocks of new SST files get a hash index over their restart points, keyed by the
+  // prefix of user keys returned by this extractor. Seeks to keys with a prefix present in a data
+  // block then binary search only the restart points of that prefix. Keys for which the extractor
+  // returns an empty prefix are not indexed. The index is used by reads only when this extractor
+  // is set, and does not help when it differs from the one the file was written with.
+  // Data blocks with a hash index could not be read by versions that do not support it.
+  std::shared_ptr<const SliceTransform> data_block_key_prefix_extractor = nullptr;
+
+  // Ratio of the number of distinct key prefixes of a data block to the number of buckets in its
+  // hash index.
+  double data_block_hash_table_util_ratio = 0.75;
+
   // Index block size for sharded index. Applied to data index when kMultiLevelBinarySearch is used.
   size_t index_block_size = 4_KB;
 
@@ -423,6 +436,12 @@ class TableFactory {
   // DocDbAwareFilterPolicy and HashedComponentsExtractor.
   virtual std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
       const ReadOptions &read_options, const Slice &user_key) const { return nullptr; }
+
+  // Same as above, but keeps files which could contain at least one of user_keys.
+  virtual std::shared_ptr<TableAwareReadFileFilter> NewTableAwareReadFileFilter(
+      const ReadOptions &read_options, const std::vector<Slice>& user_keys) const {
+    return nullptr;
+  }
 };
 
 #ifndef ROCKSDB_LITE
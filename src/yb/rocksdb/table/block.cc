@@ -34,6 +34,7 @@
 #include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/table/block_hash_index.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/logging.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
@@ -108,7 +109,9 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           const DataBlockHashIndex* data_block_hash_index,
+                           const SliceTransform* data_block_key_prefix_extractor) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -120,6 +123,8 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  data_block_hash_index_ = data_block_hash_index;
+  data_block_key_prefix_extractor_ = data_block_key_prefix_extractor;
 }
 
 
@@ -132,6 +137,8 @@ void BlockIter::Seek(const Slice& target) {
   bool ok = false;
   if (prefix_index_) {
     ok = PrefixSeek(target, &index);
+  } else if (data_block_hash_index_) {
+    ok = DataBlockHashSeek(target, &index);
   } else {
     ok = hash_index_ ? HashSeek(target, &index)
       : BinarySeek(target, 0, num_restarts_ - 1, &index);
@@ -355,9 +362,29 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
   }
 }
 
+bool BlockIter::DataBlockHashSeek(const Slice& target, uint32_t* index) {
+  const auto prefix = data_block_key_prefix_extractor_->Transform(ExtractUserKey(target));
+  uint32_t first_restart, last_restart;
+  if (prefix.empty() ||
+      !data_block_hash_index_->Lookup(prefix, &first_restart, &last_restart) ||
+      last_restart < first_restart || last_restart >= num_restarts_) {
+    return BinarySeek(target, 0, num_restarts_ - 1, index);
+  }
+
+  // The prefix of target could be missing from this block and share the bucket with another
+  // prefix, so check that target is within the range of restart intervals found.
+  if (first_restart > 0 && CompareBlockKey(first_restart, target) > 0) {
+    return status_.ok() && BinarySeek(target, 0, first_restart - 1, index);
+  }
+  if (last_restart + 1 < num_restarts_ && CompareBlockKey(last_restart + 1, target) <= 0) {
+    return status_.ok() && BinarySeek(target, last_restart + 1, num_restarts_ - 1, index);
+  }
+  return status_.ok() && BinarySeek(target, first_restart, last_restart, index);
+}
+
 uint32_t Block::NumRestarts() const {
   assert(size_ >= kMinBlockSize);
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kDataBlockHashIndexFlag;
 }
 
 Block::Block(BlockContents&& contents)
@@ -367,18 +394,25 @@ Block::Block(BlockContents&& contents)
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
-      // The size is too small for NumRestarts() and therefore
-      // restart_offset_ wrapped around.
+    const bool has_hash_index =
+        (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & kDataBlockHashIndexFlag) != 0;
+    size_t index_size = 0;
+    if (has_hash_index) {
+      index_size = data_block_hash_index_.Initialize(data_, size_ - sizeof(uint32_t));
+    }
+    const size_t trailer_size = (1 + NumRestarts()) * sizeof(uint32_t) + index_size;
+    if ((has_hash_index && index_size == 0) || trailer_size > size_) {
+      // The hash index is corrupted or the size is too small for NumRestarts() and the hash index.
       size_ = 0;
+    } else {
+      restart_offset_ = static_cast<uint32_t>(size_ - trailer_size);
     }
   }
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     const SliceTransform* data_block_key_prefix_extractor) {
   if (size_ < kMinBlockSize) {
     if (iter != nullptr) {
       iter->SetStatus(BadBlockContentsError());
@@ -401,12 +435,18 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index_.get();
 
+    const DataBlockHashIndex* data_block_hash_index_ptr =
+        data_block_key_prefix_extractor && data_block_hash_index_.initialized()
+            ? &data_block_hash_index_ : nullptr;
+
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, data_block_hash_index_ptr,
+                    data_block_key_prefix_extractor);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, data_block_hash_index_ptr,
+                           data_block_key_prefix_extractor);
     }
   }
 
@@ -31,6 +31,7 @@
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/flush_block_policy.h"
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table/block_based_table_builder.h"
 #include "yb/rocksdb/table/block_based_table_reader.h"
 #include "yb/rocksdb/table/format.h"
@@ -177,6 +178,13 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_prefix_extractor: %s\n",
+           table_options_.data_block_key_prefix_extractor == nullptr ?
+             "nullptr" : table_options_.data_block_key_prefix_extractor->Name());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_hash_table_util_ratio: %lf\n",
+           table_options_.data_block_hash_table_util_ratio);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
@@ -201,6 +209,11 @@ std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareR
   return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_key);
 }
 
+std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareReadFileFilter(
+    const ReadOptions &read_options, const std::vector<Slice>& user_keys) const {
+  return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_keys);
+}
+
 TableFactory* NewBlockBasedTableFactory(
     const BlockBasedTableOptions& _table_options) {
   return new BlockBasedTableFactory(_table_options);
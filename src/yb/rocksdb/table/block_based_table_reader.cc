@@ -200,6 +200,14 @@ struct BlockBasedTable::Rep {
     } else if (ioptions.mem_tracker) {
       mem_tracker = yb::MemTracker::FindOrCreateTracker("BlockBasedTable", ioptions.mem_tracker);
     }
+    pinned_mem_tracker = ioptions.pinned_index_and_filter_mem_tracker;
+  }
+
+  // Returns whether the block with the specified handle should be pinned in memory, i.e. there is
+  // a pinned blocks tracker and the block fits into its spare capacity.
+  bool ShouldPin(const BlockHandle& handle) const {
+    return pinned_mem_tracker &&
+           pinned_mem_tracker->SpareCapacity() >= static_cast<int64_t>(handle.size());
   }
 
   const ImmutableCFOptions& ioptions;
@@ -239,6 +247,9 @@ struct BlockBasedTable::Rep {
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
   yb::MemTrackerPtr mem_tracker;
+  // Tracker for blocks pinned for the lifetime of the table reader, see
+  // DBOptions::pinned_index_and_filter_mem_tracker.
+  yb::MemTrackerPtr pinned_mem_tracker;
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -323,22 +334,61 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
 
 BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
     const ReadOptions& read_options, const Slice& user_key)
-    : read_options_(read_options), user_key_(user_key.ToBuffer()) {}
+    : read_options_(read_options), user_keys_{user_key.ToBuffer()} {}
+
+BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
+    const ReadOptions& read_options, const std::vector<Slice>& user_keys)
+    : read_options_(read_options) {
+  user_keys_.reserve(user_keys.size());
+  for (const auto& user_key : user_keys) {
+    user_keys_.push_back(user_key.ToBuffer());
+  }
+}
 
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
-    const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
-    auto filter_entry = table->GetFilter(read_options_.query_id,
-        read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
-    FilterBlockReader* filter = filter_entry.value;
-    // If bloom filter was not useful, then take this file into account.
-    const bool use_file = table->NonBlockBasedFilterKeyMayMatch(filter, filter_key);
+    bool use_file = user_keys_.empty();
+    // Sorted keys that are close to each other usually share the filter key or the filter block,
+    // so the filter block is fetched from the block cache only when it changes.
+    BlockBasedTable::CachableEntry<FilterBlockReader> filter_entry;
+    BlockHandle filter_block_handle;
+    Slice prev_filter_key;
+    for (const auto& user_key : user_keys_) {
+      const auto filter_key = table->GetFilterKeyFromUserKey(user_key);
+      if (filter_entry.value && filter_key == prev_filter_key) {
+        continue;
+      }
+      prev_filter_key = filter_key;
+      BlockHandle handle;
+      if (table->GetFixedSizeFilterBlockHandle(filter_key, &handle).ok()) {
+        if (handle.IsNull()) {
+          // Key is beyond filter index, so it is not in this file.
+          continue;
+        }
+        if (!filter_entry.value || handle.offset() != filter_block_handle.offset()) {
+          filter_entry.Release(table->rep_->table_options.block_cache.get());
+          filter_entry = table->GetFilter(read_options_.query_id,
+              read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
+          filter_block_handle = handle;
+        }
+      } else {
+        // GetFilter reports the broken filter index, and the file is used.
+        filter_entry.Release(table->rep_->table_options.block_cache.get());
+        filter_entry = table->GetFilter(read_options_.query_id,
+            read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
+      }
+      // If bloom filter was not useful, then take this file into account.
+      use_file = table->NonBlockBasedFilterKeyMayMatch(filter_entry.value, filter_key);
+      if (use_file) {
+        break;
+      }
+    }
+    filter_entry.Release(table->rep_->table_options.block_cache.get());
     if (!use_file) {
       // Record that the bloom filter was useful.
       RecordTick(table->rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
     }
-    filter_entry.Release(table->rep_->table_options.block_cache.get());
     return use_file;
   } else {
     // For non fixed-size filters - take file into account. We are only using fixed-size bloom
@@ -411,7 +461,15 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   RETURN_NOT_OK(new_table->SetupFilter(meta_iter.get()));
 
-  if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
+  if (rep->ShouldPin(rep->footer.index_handle())) {
+    // Pin top-level data index regardless of data index load mode, so it is never evicted from
+    // memory together with data blocks. Lower levels of multi-level index are still accessed
+    // through the block cache.
+    std::unique_ptr<IndexReader> index_reader;
+    RETURN_NOT_OK(new_table->CreateDataBlockIndexReader(
+        &index_reader, meta_iter.get(), rep->pinned_mem_tracker));
+    rep->data_index_reader.reset(index_reader.release());
+  } else if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
     if (table_options.cache_index_and_filter_blocks) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
@@ -864,8 +922,12 @@ Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* fi
   auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
   auto footer = rep_->footer;
+  // Filter index is always kept in memory by the table reader, so we only need to decide which
+  // tracker its memory is charged to.
+  const auto& mem_tracker =
+      rep_->ShouldPin(rep_->filter_handle) ? rep_->pinned_mem_tracker : rep_->mem_tracker;
   return BinarySearchIndexReader::Create(base_file_reader, footer, rep_->filter_handle, env,
-      SharedBytewiseComparator(), filter_index_reader, rep_->mem_tracker);
+      SharedBytewiseComparator(), filter_index_reader, mem_tracker);
 }
 
 FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_handle, Rep* rep,
@@ -1228,7 +1290,10 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    iter = block.value->NewIterator(
+        rep_->comparator.get(), input_iter, true /* total_order_seek */,
+        block_type == BlockType::kData
+            ? rep_->table_options.data_block_key_prefix_extractor.get() : nullptr);
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1543,7 +1608,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 //  4. internal_comparator
 //  5. index_type
 Status BlockBasedTable::CreateDataBlockIndexReader(
-    std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
+    std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter,
+    const std::shared_ptr<yb::MemTracker>& pinned_mem_tracker) {
   // Some old version of block-based tables don't have index type present in
   // table properties. If that's the case we can safely use the kBinarySearch.
   auto index_type_on_file = IndexType::kBinarySearch;
@@ -1560,6 +1626,7 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
   auto env = rep_->ioptions.env;
   const auto& comparator = rep_->comparator;
   const Footer& footer = rep_->footer;
+  const auto& mem_tracker = pinned_mem_tracker ? pinned_mem_tracker : rep_->mem_tracker;
 
   if (index_type_on_file == IndexType::kHashSearch &&
       rep_->ioptions.prefix_extractor == nullptr) {
@@ -1573,7 +1640,7 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
   switch (index_type_on_file) {
     case IndexType::kBinarySearch: {
       return BinarySearchIndexReader::Create(
-          file, footer, footer.index_handle(), env, comparator, index_reader, rep_->mem_tracker);
+          file, footer, footer.index_handle(), env, comparator, index_reader, mem_tracker);
     }
     case IndexType::kHashSearch: {
       std::unique_ptr<Block> meta_guard;
@@ -1588,7 +1655,7 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
               "Unable to read the metaindex block."
               " Fall back to binary search index.");
           return BinarySearchIndexReader::Create(
-            file, footer, footer.index_handle(), env, comparator, index_reader, rep_->mem_tracker);
+            file, footer, footer.index_handle(), env, comparator, index_reader, mem_tracker);
         }
         meta_index_iter = meta_iter_guard.get();
       }
@@ -1600,7 +1667,7 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
       return HashIndexReader::Create(
           rep_->internal_prefix_transform.get(), footer, file, env, comparator,
           footer.index_handle(), meta_index_iter, index_reader,
-          rep_->hash_index_allow_collision, rep_->mem_tracker);
+          rep_->hash_index_allow_collision, mem_tracker);
     }
     case IndexType::kMultiLevelBinarySearch: {
       auto& props = DCHECK_NOTNULL(rep_->table_properties.get())->user_collected_properties;
@@ -1612,7 +1679,7 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
       }
       int num_levels = DecodeFixed32(pos->second.c_str());
       auto result = MultiLevelIndexReader::Create(
-          file, footer, num_levels, footer.index_handle(), env, comparator, rep_->mem_tracker);
+          file, footer, num_levels, footer.index_handle(), env, comparator, mem_tracker);
       RETURN_NOT_OK(result);
       *index_reader = std::move(*result);
       return Status::OK();
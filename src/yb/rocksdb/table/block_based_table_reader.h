@@ -28,6 +28,7 @@
 #include <memory>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
@@ -86,15 +87,19 @@ YB_DEFINE_ENUM(BlockType, (kData)(kIndex));
 // hashed components of key for filtering.
 // BloomFilterAwareFileFilter ignores an SST file completely if there are no keys with the same
 // hashed components as the key specified in constructor.
+// When several keys are specified, the file is ignored only if none of them may match, so a single
+// iterator can be used to read all of them.
 class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
  public:
   BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key);
 
+  BloomFilterAwareFileFilter(const ReadOptions& read_options, const std::vector<Slice>& user_keys);
+
   bool Filter(TableReader* reader) const override;
 
  private:
   const ReadOptions read_options_;
-  const std::string user_key_;
+  std::vector<std::string> user_keys_;
 };
 
 // A Table is a sorted map from strings to strings.  Tables are
@@ -282,9 +287,12 @@ class BlockBasedTable : public TableReader {
   // Optionally, user can pass a preloaded meta_index_iter for the index that
   // need to access extra meta blocks for index construction. This parameter
   // helps avoid re-reading meta index block if caller already created one.
+  // If pinned_mem_tracker is specified, memory of the index reader is charged to it instead of the
+  // table mem tracker.
   CHECKED_STATUS CreateDataBlockIndexReader(
       std::unique_ptr<IndexReader>* index_reader,
-      InternalIterator* preloaded_meta_index_iter = nullptr);
+      InternalIterator* preloaded_meta_index_iter = nullptr,
+      const std::shared_ptr<yb::MemTracker>& pinned_mem_tracker = nullptr);
 
   bool NonBlockBasedFilterKeyMayMatch(FilterBlockReader* filter, const Slice& filter_key) const;
 
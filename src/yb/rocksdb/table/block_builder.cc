@@ -44,6 +44,9 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// Data blocks could also have a hash index between the restart array and num_restarts, see
+// data_block_hash_index.h.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -57,13 +60,19 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           const SliceTransform* hash_index_key_prefix_extractor,
+                           double hash_index_util_ratio)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
       restarts_(),
       counter_(0),
       finished_(false) {
   assert(block_restart_interval_ >= 1);
+  if (hash_index_key_prefix_extractor) {
+    hash_index_builder_ = std::make_unique<DataBlockHashIndexBuilder>(
+        hash_index_key_prefix_extractor, hash_index_util_ratio);
+  }
   restarts_.push_back(0);       // First restart point is at offset 0
 }
 
@@ -74,6 +83,9 @@ void BlockBuilder::Reset() {
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  if (hash_index_builder_) {
+    hash_index_builder_->Reset();
+  }
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -82,6 +94,9 @@ size_t BlockBuilder::CurrentSizeEstimate() const {
     // Restarts haven't been flushed to buffer yet.
     size += restarts_.size() * sizeof(uint32_t) +    // Restart array.
             sizeof(uint32_t);                        // Restart array length.
+    if (hash_index_builder_) {
+      size += hash_index_builder_->EstimateSize();
+    }
   }
   return size;
 }
@@ -110,7 +125,11 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  auto num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (hash_index_builder_ && hash_index_builder_->Finish(num_restarts, &buffer_)) {
+    num_restarts |= kDataBlockHashIndexFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
@@ -133,6 +152,10 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   }
   const size_t non_shared = key.size() - shared;
 
+  if (hash_index_builder_) {
+    hash_index_builder_->Add(key, static_cast<uint32_t>(restarts_.size() - 1));
+  }
+
   // Add "<shared><non_shared><value_size>" to buffer_
   PutVarint32(&buffer_, static_cast<uint32_t>(shared));
   PutVarint32(&buffer_, static_cast<uint32_t>(non_shared));
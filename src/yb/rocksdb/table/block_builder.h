@@ -25,7 +25,12 @@
 #define YB_ROCKSDB_TABLE_BLOCK_BUILDER_H
 
 #include <stdint.h>
+
+#include <memory>
 #include <vector>
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -35,8 +40,12 @@ class BlockBuilder {
   BlockBuilder(const BlockBuilder&) = delete;
   void operator=(const BlockBuilder&) = delete;
 
+  // If hash_index_key_prefix_extractor is specified, the block gets a hash index keyed by prefixes
+  // of user keys, see data_block_hash_index.h. Keys should be internal keys in this case.
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        const SliceTransform* hash_index_key_prefix_extractor = nullptr,
+                        double hash_index_util_ratio = 0.75);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -73,6 +82,7 @@ class BlockBuilder {
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+  std::unique_ptr<DataBlockHashIndexBuilder> hash_index_builder_;
 };
 
 }  // namespace rocksdb
@@ -273,6 +273,74 @@ void CheckMiddleKey(
 
 } // namespace
 
+TEST_F(BlockTest, DataBlockHashIndex) {
+  const size_t kPrefixSize = 6;
+  const int kRestartInterval = 4;
+  InternalKeyComparator icmp(BytewiseComparator());
+  std::unique_ptr<const SliceTransform> prefix_extractor(NewFixedPrefixTransform(kPrefixSize));
+
+  // Only even primary keys are present, each with 5 secondary keys.
+  std::vector<std::string> user_keys;
+  std::vector<std::string> values;
+  GenerateRandomKVs(&user_keys, &values, 0, 200, 2 /* step */, 0 /* padding_size */,
+                    5 /* keys_share_prefix */);
+
+  BlockBuilder hash_builder(kRestartInterval, true /* use_delta_encoding */,
+                            prefix_extractor.get());
+  BlockBuilder regular_builder(kRestartInterval);
+  for (size_t i = 0; i < user_keys.size(); ++i) {
+    const InternalKey key(user_keys[i], 1, kTypeValue);
+    hash_builder.Add(key.Encode(), values[i]);
+    regular_builder.Add(key.Encode(), values[i]);
+  }
+  BlockContents hash_contents;
+  hash_contents.data = hash_builder.Finish();
+  hash_contents.cachable = false;
+  BlockContents regular_contents;
+  regular_contents.data = regular_builder.Finish();
+  regular_contents.cachable = false;
+  ASSERT_GT(hash_contents.data.size(), regular_contents.data.size());
+
+  Block hash_block(std::move(hash_contents));
+  Block regular_block(std::move(regular_contents));
+  ASSERT_EQ(regular_block.NumRestarts(), hash_block.NumRestarts());
+
+  std::unique_ptr<InternalIterator> hash_iter(hash_block.NewIterator(
+      &icmp, nullptr /* iter */, true /* total_order_seek */, prefix_extractor.get()));
+  std::unique_ptr<InternalIterator> regular_iter(regular_block.NewIterator(&icmp));
+
+  auto check_seek = [&](const std::string& user_key) {
+    const InternalKey target(user_key, kMaxSequenceNumber, kTypeValue);
+    hash_iter->Seek(target.Encode());
+    regular_iter->Seek(target.Encode());
+    ASSERT_OK(hash_iter->status());
+    ASSERT_EQ(regular_iter->Valid(), hash_iter->Valid()) << user_key;
+    if (regular_iter->Valid()) {
+      ASSERT_EQ(regular_iter->key(), hash_iter->key()) << user_key;
+      ASSERT_EQ(regular_iter->value(), hash_iter->value()) << user_key;
+    }
+  };
+
+  Random rnd(301);
+  for (const auto& user_key : user_keys) {
+    ASSERT_NO_FATALS(check_seek(user_key));
+  }
+  for (int primary_key = -1; primary_key <= 201; ++primary_key) {
+    // Absent prefixes, keys before and after all keys with the same prefix.
+    ASSERT_NO_FATALS(check_seek(GenerateKey(primary_key, 0, 0, &rnd)));
+    ASSERT_NO_FATALS(check_seek(GenerateKey(primary_key, 3, 0, &rnd)));
+    ASSERT_NO_FATALS(check_seek(GenerateKey(primary_key, 9999, 0, &rnd)));
+  }
+
+  // Without the extractor the index is not used.
+  std::unique_ptr<InternalIterator> iter(hash_block.NewIterator(&icmp));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++count) {
+    ASSERT_EQ(user_keys[count], ExtractUserKey(iter->key()).ToBuffer());
+  }
+  ASSERT_EQ(user_keys.size(), count);
+}
+
 TEST_F(BlockTest, GetMiddleKey) {
   const auto block_restart_interval = 1;
 
@@ -0,0 +1,142 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/data_block_hash_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/slice_transform.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr uint32_t kHashSeed = 0x6c2e9a3f;
+
+// Values of first_restart in empty buckets and buckets shared by several prefixes.
+constexpr uint16_t kNoEntry = 0xffff;
+constexpr uint16_t kCollision = 0xfffe;
+
+constexpr size_t kBucketSize = 2 * sizeof(uint16_t);
+
+inline uint32_t PrefixHash(const Slice& prefix) {
+  return Hash(prefix.cdata(), prefix.size(), kHashSeed);
+}
+
+inline uint16_t DecodeFixed16(const char* ptr) {
+  return static_cast<uint16_t>(static_cast<uint8_t>(ptr[0]) |
+                               (static_cast<uint16_t>(static_cast<uint8_t>(ptr[1])) << 8));
+}
+
+inline void EncodeFixed16(char* buf, uint16_t value) {
+  buf[0] = static_cast<char>(value & 0xff);
+  buf[1] = static_cast<char>(value >> 8);
+}
+
+} // namespace
+
+DataBlockHashIndexBuilder::DataBlockHashIndexBuilder(
+    const SliceTransform* key_prefix_extractor, double util_ratio)
+    : key_prefix_extractor_(key_prefix_extractor),
+      util_ratio_(util_ratio > 0 ? util_ratio : 0.75) {
+}
+
+void DataBlockHashIndexBuilder::Add(const Slice& key, uint32_t restart_index) {
+  const Slice prefix = key_prefix_extractor_->Transform(ExtractUserKey(key));
+  if (prefix.empty()) {
+    last_prefix_.clear();
+    return;
+  }
+  if (!entries_.empty() && prefix == Slice(last_prefix_)) {
+    entries_.back().last_restart = restart_index;
+    return;
+  }
+  entries_.push_back(Entry{PrefixHash(prefix), restart_index, restart_index});
+  last_prefix_.assign(prefix.cdata(), prefix.size());
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  if (entries_.empty()) {
+    return 0;
+  }
+  return static_cast<size_t>(std::ceil(entries_.size() / util_ratio_)) * kBucketSize +
+         sizeof(uint32_t);
+}
+
+bool DataBlockHashIndexBuilder::Finish(uint32_t num_restarts, std::string* buffer) {
+  if (entries_.empty() || num_restarts >= kCollision) {
+    return false;
+  }
+
+  const auto num_buckets = std::max<uint32_t>(
+      1, static_cast<uint32_t>(std::ceil(entries_.size() / util_ratio_)));
+  std::vector<uint16_t> first_restarts(num_buckets, kNoEntry);
+  std::vector<uint16_t> last_restarts(num_buckets, kNoEntry);
+  for (const auto& entry : entries_) {
+    auto bucket = entry.hash % num_buckets;
+    if (first_restarts[bucket] == kNoEntry) {
+      first_restarts[bucket] = static_cast<uint16_t>(entry.first_restart);
+      last_restarts[bucket] = static_cast<uint16_t>(entry.last_restart);
+    } else {
+      first_restarts[bucket] = kCollision;
+    }
+  }
+
+  const auto old_size = buffer->size();
+  buffer->resize(old_size + num_buckets * kBucketSize);
+  char* out = &(*buffer)[old_size];
+  for (uint32_t i = 0; i != num_buckets; ++i) {
+    EncodeFixed16(out, first_restarts[i]);
+    EncodeFixed16(out + sizeof(uint16_t), last_restarts[i]);
+    out += kBucketSize;
+  }
+  PutFixed32(buffer, num_buckets);
+  return true;
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  entries_.clear();
+  last_prefix_.clear();
+}
+
+size_t DataBlockHashIndex::Initialize(const char* data, size_t size) {
+  if (size < sizeof(uint32_t)) {
+    return 0;
+  }
+  const uint32_t num_buckets = DecodeFixed32(data + size - sizeof(uint32_t));
+  const size_t index_size = num_buckets * kBucketSize + sizeof(uint32_t);
+  if (num_buckets == 0 || index_size > size) {
+    return 0;
+  }
+  buckets_ = data + size - index_size;
+  num_buckets_ = num_buckets;
+  return index_size;
+}
+
+bool DataBlockHashIndex::Lookup(
+    const Slice& prefix, uint32_t* first_restart, uint32_t* last_restart) const {
+  const char* bucket = buckets_ + (PrefixHash(prefix) % num_buckets_) * kBucketSize;
+  const auto first = DecodeFixed16(bucket);
+  if (first == kNoEntry || first == kCollision) {
+    return false;
+  }
+  *first_restart = first;
+  *last_restart = DecodeFixed16(bucket + sizeof(uint16_t));
+  return true;
+}
+
+} // namespace rocksdb
@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// Hash index of a data block, keyed by key prefix (for DocDB - encoded DocKey).
+//
+// Each bucket of the index stores the range of restart intervals that contain keys with the
+// prefix hashed to this bucket. A seek for a key with such prefix binary searches only the restart
+// points of that range, instead of all restart points of the block. Buckets with colliding
+// prefixes are marked as such, and seeks for keys hashed to them fall back to full binary search.
+//
+// The index is appended after the restart array of the block:
+//     buckets: (first_restart: fixed16, last_restart: fixed16)[num_buckets]
+//     num_buckets: fixed32
+//     num_restarts | kDataBlockHashIndexFlag: fixed32
+// Since blocks without the index never have the highest bit of num_restarts set, such blocks
+// could be read by the same code.
+
+#ifndef YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+#define YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class SliceTransform;
+
+// Set in the trailing num_restarts field of blocks that have a hash index.
+constexpr uint32_t kDataBlockHashIndexFlag = 1u << 31;
+
+class DataBlockHashIndexBuilder {
+ public:
+  // key_prefix_extractor is applied to user keys. Keys with an empty prefix are not indexed.
+  // util_ratio is the ratio of the number of distinct prefixes to the number of buckets.
+  DataBlockHashIndexBuilder(const SliceTransform* key_prefix_extractor, double util_ratio);
+
+  // Adds internal key located in the restart interval with the specified index.
+  // Keys should be added in order.
+  void Add(const Slice& key, uint32_t restart_index);
+
+  // Returns estimated size of the index that would be appended by Finish.
+  size_t EstimateSize() const;
+
+  // Appends the index to buffer, unless there is nothing to index or the block has too many
+  // restart points. Returns true if the index was appended.
+  bool Finish(uint32_t num_restarts, std::string* buffer);
+
+  void Reset();
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    uint32_t first_restart;
+    uint32_t last_restart;
+  };
+
+  const SliceTransform* const key_prefix_extractor_;
+  const double util_ratio_;
+
+  std::vector<Entry> entries_;
+  std::string last_prefix_;
+};
+
+class DataBlockHashIndex {
+ public:
+  // Initializes the index from block data preceding the trailing num_restarts field.
+  // Returns the size of the index or 0 if it is corrupted.
+  size_t Initialize(const char* data, size_t size);
+
+  // Looks up the range of restart intervals that could contain keys with the specified prefix.
+  // Returns false if no prefix of the block or several of them are hashed to the same bucket as
+  // prefix. Since a prefix that is not present in the block could share the bucket with another
+  // prefix, the returned range could be wrong, so the caller should check its bounds.
+  bool Lookup(const Slice& prefix, uint32_t* first_restart, uint32_t* last_restart) const;
+
+  bool initialized() const {
+    return num_buckets_ != 0;
+  }
+
+ private:
+  const char* buckets_ = nullptr;
+  uint32_t num_buckets_ = 0;
+};
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_TABLE_DATA_BLOCK_HASH_INDEX_H
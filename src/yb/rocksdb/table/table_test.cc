@@ -63,6 +63,7 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/util/enums.h"
+#include "yb/util/mem_tracker.h"
 
 DECLARE_double(cache_single_touch_ratio);
 
@@ -1679,6 +1680,49 @@ TEST_F(BlockBasedTableTest, BlockCacheDisabledTest) {
   ASSERT_TRUE(reader->TEST_index_reader_loaded());
 }
 
+TEST_F(BlockBasedTableTest, PinnedIndexBlock) {
+  for (bool fits_budget : {true, false}) {
+    Options options;
+    options.create_if_missing = true;
+    options.statistics = CreateDBStatistics();
+    options.pinned_index_and_filter_mem_tracker = yb::MemTracker::CreateTracker(
+        fits_budget ? -1 : 1, "pinned", nullptr, yb::AddToParent::kFalse);
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(1024 / FLAGS_cache_single_touch_ratio);
+    table_options.cache_index_and_filter_blocks = true;
+    options.table_factory.reset(new BlockBasedTableFactory(table_options));
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+
+    TableConstructor c(BytewiseComparator());
+    c.Add("key", "value");
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    // Pinned index is loaded on open, even though index blocks should be cached.
+    auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+    ASSERT_EQ(fits_budget, reader->TEST_index_reader_loaded());
+    const auto pinned_bytes = options.pinned_index_and_filter_mem_tracker->consumption();
+    if (fits_budget) {
+      ASSERT_GT(pinned_bytes, 0);
+    } else {
+      ASSERT_EQ(0, pinned_bytes);
+    }
+
+    unique_ptr<InternalIterator> iter(reader->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("value", iter->value().ToString());
+    iter.reset();
+
+    // Pinned index is never looked up in the block cache.
+    BlockCachePropertiesSnapshot props(options.statistics.get());
+    props.AssertIndexBlockStat(fits_budget ? 0 : 1, 0);
+    ASSERT_EQ(pinned_bytes, options.pinned_index_and_filter_mem_tracker->consumption());
+  }
+}
+
 // Due to the difficulities of the intersaction between statistics, this test
 // only tests the case when "index block is put to block cache"
 TEST_F(BlockBasedTableTest, FilterBlockInBlockCache) {
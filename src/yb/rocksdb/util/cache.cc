@@ -26,6 +26,11 @@
 #include <stdlib.h>
 #include <gflags/gflags.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+
 #include "yb/util/metrics.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/statistics.h"
@@ -36,7 +41,9 @@
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/util/enums.h"
+#include "yb/util/locks.h"
 #include "yb/util/random_util.h"
+#include "yb/util/shared_lock.h"
 
 // 0 value means that there exist no single_touch cache and
 // 1 means that the entire cache is treated as a multi-touch cache.
@@ -839,11 +846,594 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
   }
 }
 
+// CLOCK cache implementation
+
+// An entry of the CLOCK cache.
+//
+// Unlike LRUCache, ClockCache does not relink entries on lookup, so a lookup only needs the shard
+// lock in shared mode. The entry is pinned by incrementing its reference count and marked as
+// recently used by setting its clock bit, both of which are atomic. The cache does not keep a
+// separate recency list: when space is needed, the clock hand sweeps over the buckets of the hash
+// table, clearing clock bits, and evicts the entries that were not referenced since the previous
+// pass of the hand and are not pinned.
+//
+// The "in cache" flag and the number of external references are packed into the single atomic
+// state, so whichever of Release and Erase/eviction drops the last claim on the entry frees it.
+// Only the last Release happens without holding the shard lock.
+//
+// Scan resistance follows LRUCache: an entry starts in the single touch sub-cache and is moved to
+// the multi touch sub-cache when it is looked up by a query other than the one that added it.
+struct ClockHandle {
+  static constexpr uint32_t kInCacheBit = 1;
+  static constexpr uint32_t kOneRef = 2;
+
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  ClockHandle* next_hash;
+  size_t charge;
+  size_t key_length;
+  uint32_t hash;
+  std::atomic<uint32_t> state;
+  std::atomic<bool> referenced;
+  std::atomic<QueryId> query_id;
+  char key_data[1];   // Beginning of key
+
+  static ClockHandle* Create(const Slice& key, uint32_t hash, QueryId query_id, void* value,
+                             size_t charge, void (*deleter)(const Slice& key, void* value)) {
+    auto* result = new (new char[sizeof(ClockHandle) - 1 + key.size()]) ClockHandle;
+    result->value = value;
+    result->deleter = deleter;
+    result->next_hash = nullptr;
+    result->charge = charge;
+    result->key_length = key.size();
+    result->hash = hash;
+    result->state.store(0, std::memory_order_relaxed);
+    result->referenced.store(false, std::memory_order_relaxed);
+    result->query_id.store(query_id, std::memory_order_relaxed);
+    memcpy(result->key_data, key.data(), key.size());
+    return result;
+  }
+
+  Slice key() const {
+    return Slice(key_data, key_length);
+  }
+
+  static uint32_t NumRefs(uint32_t state) {
+    return state / kOneRef;
+  }
+
+  void Free(yb::CacheMetrics* metrics) {
+    assert(state.load(std::memory_order_relaxed) == 0);
+    (*deleter)(key(), value);
+    if (metrics != nullptr) {
+      if (GetSubCacheType() == MULTI_TOUCH) {
+        metrics->multi_touch_cache_usage->DecrementBy(charge);
+      } else {
+        metrics->single_touch_cache_usage->DecrementBy(charge);
+      }
+      metrics->cache_usage->DecrementBy(charge);
+    }
+    delete[] reinterpret_cast<char*>(this);
+  }
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_acquire) == kInMultiTouchId ? MULTI_TOUCH
+                                                                        : SINGLE_TOUCH;
+  }
+};
+
+class ClockHandleDeleter {
+ public:
+  explicit ClockHandleDeleter(yb::CacheMetrics* metrics) : metrics_(metrics) {}
+
+  void Add(ClockHandle* handle) {
+    handles_.push_back(handle);
+  }
+
+  size_t TotalCharge() const {
+    size_t result = 0;
+    for (ClockHandle* handle : handles_) {
+      result += handle->charge;
+    }
+    return result;
+  }
+
+  ~ClockHandleDeleter() {
+    for (ClockHandle* handle : handles_) {
+      handle->Free(metrics_);
+    }
+  }
+
+ private:
+  yb::CacheMetrics* metrics_;
+  autovector<ClockHandle*> handles_;
+};
+
+// A single shard of sharded CLOCK cache.
+class ClockCache {
+ public:
+  ClockCache();
+  ~ClockCache();
+
+  void SetCapacity(size_t capacity);
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = metrics;
+  }
+
+  // Set the flag to reject insertion if cache if full.
+  void SetStrictCapacityLimit(bool strict_capacity_limit);
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                        Statistics* statistics = nullptr);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+  size_t Evict(size_t required);
+
+  size_t GetUsage() const {
+    return single_touch_usage_.load(std::memory_order_acquire) +
+           multi_touch_usage_.load(std::memory_order_acquire);
+  }
+
+  size_t GetPinnedUsage() const {
+    return pinned_usage_.load(std::memory_order_acquire);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe);
+
+  std::pair<size_t, size_t> TEST_GetIndividualUsages() {
+    return std::make_pair(single_touch_usage_.load(), multi_touch_usage_.load());
+  }
+
+ private:
+  // Returns the sub-cache that the entry is charged to.
+  static SubCacheType ChargedSubCacheType(const ClockHandle* e);
+
+  std::atomic<size_t>& SubCacheUsage(SubCacheType subcache_type) {
+    return subcache_type == MULTI_TOUCH ? multi_touch_usage_ : single_touch_usage_;
+  }
+
+  // Same as LRUCache::GetSubCacheCapacity.
+  size_t GetSubCacheCapacity(SubCacheType subcache_type);
+
+  bool IsOverCapacity(size_t charge, SubCacheType subcache_type) {
+    return SubCacheUsage(subcache_type).load(std::memory_order_acquire) + charge >
+           GetSubCacheCapacity(subcache_type);
+  }
+
+  // Moves the single touch entry to the multi touch sub-cache, if it is looked up by another
+  // query. The multi touch sub-cache is allowed to grow over its capacity here, because nothing
+  // could be evicted under the shared lock, the next insert brings it back to the capacity.
+  void MaybePromote(ClockHandle* e, QueryId query_id);
+
+  // Sweeps the clock hand until (usage + charge) of the sub-cache fits its capacity, or there
+  // is nothing left to evict.
+  // REQUIRES: mutex_ is held in exclusive mode.
+  void EvictFromClock(size_t charge, ClockHandleDeleter* deleted, SubCacheType subcache_type);
+
+  // Drops the claim of the cache on the entry, which was just removed from the table. The entry
+  // is added to deleted if it is not referenced externally.
+  // REQUIRES: mutex_ is held in exclusive mode.
+  void RemovedFromTable(ClockHandle* e, ClockHandleDeleter* deleted);
+
+  // Hash table routines, same as in HandleTable.
+  ClockHandle** FindPointer(const Slice& key, uint32_t hash) const;
+  void Resize();
+
+  // The table consists of an array of buckets where each bucket is a linked list of cache
+  // entries that hash into the bucket. It is modified only in exclusive mode.
+  uint32_t length_ = 0;
+  uint32_t elems_ = 0;
+  ClockHandle** list_ = nullptr;
+
+  // Index of the bucket the clock hand points to.
+  uint32_t hand_ = 0;
+
+  size_t total_capacity_ = 0;
+  size_t multi_touch_capacity_ = 0;
+
+  // Whether to reject insertion if cache reaches its full capacity.
+  bool strict_capacity_limit_ = false;
+
+  // Lookups lock only the lock of the current CPU, so they do not contend with each other.
+  mutable yb::percpu_rwlock mutex_;
+
+  // Memory size for entries that are not freed yet. Includes pinned entries and entries that
+  // were erased but are still referenced.
+  std::atomic<size_t> single_touch_usage_{0};
+  std::atomic<size_t> multi_touch_usage_{0};
+
+  // Memory size for entries that are referenced externally.
+  std::atomic<size_t> pinned_usage_{0};
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCache::ClockCache() {
+  Resize();
+}
+
+ClockCache::~ClockCache() {
+  for (uint32_t i = 0; i < length_; i++) {
+    ClockHandle* e = list_[i];
+    while (e != nullptr) {
+      auto next = e->next_hash;
+      // Entries still referenced externally are leaked, same as in LRUCache.
+      if (e->state.load(std::memory_order_acquire) == ClockHandle::kInCacheBit) {
+        e->state.store(0, std::memory_order_relaxed);
+        e->Free(metrics_.get());
+      }
+      e = next;
+    }
+  }
+  delete[] list_;
+}
+
+SubCacheType ClockCache::ChargedSubCacheType(const ClockHandle* e) {
+  if (FLAGS_cache_single_touch_ratio == 0) {
+    return MULTI_TOUCH;
+  } else if (FLAGS_cache_single_touch_ratio == 1) {
+    return SINGLE_TOUCH;
+  }
+  return e->GetSubCacheType();
+}
+
+size_t ClockCache::GetSubCacheCapacity(const SubCacheType subcache_type) {
+  switch (subcache_type) {
+    case SINGLE_TOUCH :
+      if (strict_capacity_limit_ || !FLAGS_cache_overflow_single_touch) {
+        return total_capacity_ - multi_touch_capacity_;
+      }
+      return total_capacity_ - std::min(
+          total_capacity_, multi_touch_usage_.load(std::memory_order_acquire));
+    case MULTI_TOUCH :
+      return multi_touch_capacity_;
+  }
+  FATAL_INVALID_ENUM_VALUE(SubCacheType, subcache_type);
+}
+
+ClockHandle** ClockCache::FindPointer(const Slice& key, uint32_t hash) const {
+  ClockHandle** ptr = &list_[hash & (length_ - 1)];
+  while (*ptr != nullptr && ((*ptr)->hash != hash || key != (*ptr)->key())) {
+    ptr = &(*ptr)->next_hash;
+  }
+  return ptr;
+}
+
+void ClockCache::Resize() {
+  uint32_t new_length = 16;
+  while (new_length < elems_ * 1.5) {
+    new_length *= 2;
+  }
+  ClockHandle** new_list = new ClockHandle*[new_length];
+  memset(new_list, 0, sizeof(new_list[0]) * new_length);
+  for (uint32_t i = 0; i < length_; i++) {
+    ClockHandle* h = list_[i];
+    while (h != nullptr) {
+      ClockHandle* next = h->next_hash;
+      ClockHandle** ptr = &new_list[h->hash & (new_length - 1)];
+      h->next_hash = *ptr;
+      *ptr = h;
+      h = next;
+    }
+  }
+  delete[] list_;
+  list_ = new_list;
+  length_ = new_length;
+  hand_ &= length_ - 1;
+}
+
+void ClockCache::RemovedFromTable(ClockHandle* e, ClockHandleDeleter* deleted) {
+  auto old_state = e->state.fetch_and(~ClockHandle::kInCacheBit, std::memory_order_acq_rel);
+  assert(old_state & ClockHandle::kInCacheBit);
+  if (old_state == ClockHandle::kInCacheBit) {
+    SubCacheUsage(ChargedSubCacheType(e)).fetch_sub(e->charge, std::memory_order_acq_rel);
+    deleted->Add(e);
+  }
+}
+
+void ClockCache::EvictFromClock(const size_t charge,
+                                ClockHandleDeleter* deleted,
+                                const SubCacheType subcache_type) {
+  // The first pass of the hand over an entry could only clear its clock bit, so two full
+  // rotations are enough to find every entry that could be evicted.
+  for (uint32_t visited = 0; visited <= 2 * length_; ++visited) {
+    ClockHandle** ptr = &list_[hand_];
+    while (*ptr != nullptr) {
+      if (!IsOverCapacity(charge, subcache_type)) {
+        return;
+      }
+      ClockHandle* e = *ptr;
+      if (ChargedSubCacheType(e) != subcache_type) {
+        ptr = &e->next_hash;
+        continue;
+      }
+      if (e->referenced.load(std::memory_order_relaxed)) {
+        e->referenced.store(false, std::memory_order_relaxed);
+        ptr = &e->next_hash;
+        continue;
+      }
+      // No lookup could pin the entry while we hold the exclusive lock.
+      if (e->state.load(std::memory_order_acquire) != ClockHandle::kInCacheBit) {
+        ptr = &e->next_hash;
+        continue;
+      }
+      *ptr = e->next_hash;
+      --elems_;
+      RemovedFromTable(e, deleted);
+    }
+    if (!IsOverCapacity(charge, subcache_type)) {
+      return;
+    }
+    hand_ = (hand_ + 1) & (length_ - 1);
+  }
+}
+
+void ClockCache::SetCapacity(size_t capacity) {
+  ClockHandleDeleter last_reference_list(metrics_.get());
+
+  {
+    std::lock_guard<yb::percpu_rwlock> l(mutex_);
+    multi_touch_capacity_ = round((1 - FLAGS_cache_single_touch_ratio) * capacity);
+    total_capacity_ = capacity;
+    EvictFromClock(0, &last_reference_list, MULTI_TOUCH);
+    EvictFromClock(0, &last_reference_list, SINGLE_TOUCH);
+  }
+}
+
+void ClockCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
+  std::lock_guard<yb::percpu_rwlock> l(mutex_);
+  // See LRUCache::SetStrictCapacityLimit.
+  assert(GetUsage() == 0 || !FLAGS_cache_overflow_single_touch);
+  strict_capacity_limit_ = strict_capacity_limit;
+}
+
+void ClockCache::MaybePromote(ClockHandle* e, const QueryId query_id) {
+  if (FLAGS_cache_single_touch_ratio >= 1) {
+    return;
+  }
+  QueryId old_query_id = e->query_id.load(std::memory_order_acquire);
+  if (old_query_id == kInMultiTouchId || old_query_id == query_id) {
+    return;
+  }
+  if (strict_capacity_limit_ &&
+      multi_touch_usage_.load(std::memory_order_acquire) + e->charge > multi_touch_capacity_) {
+    return;
+  }
+  // Concurrent lookups by different queries could try to promote the same entry.
+  if (!e->query_id.compare_exchange_strong(old_query_id, kInMultiTouchId,
+                                           std::memory_order_acq_rel)) {
+    return;
+  }
+  single_touch_usage_.fetch_sub(e->charge, std::memory_order_acq_rel);
+  multi_touch_usage_.fetch_add(e->charge, std::memory_order_acq_rel);
+  if (metrics_) {
+    metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+    metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+  }
+}
+
+Cache::Handle* ClockCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                  Statistics* statistics) {
+  ClockHandle* e;
+  {
+    yb::SharedLock<yb::rw_spinlock> l(mutex_.get_lock());
+    e = *FindPointer(key, hash);
+    if (e != nullptr) {
+      auto old_state = e->state.fetch_add(ClockHandle::kOneRef, std::memory_order_acq_rel);
+      assert(old_state & ClockHandle::kInCacheBit);
+      if (ClockHandle::NumRefs(old_state) == 0) {
+        pinned_usage_.fetch_add(e->charge, std::memory_order_acq_rel);
+      }
+      // Avoid writing to the cache line of a hot entry when the bit is already set.
+      if (!e->referenced.load(std::memory_order_relaxed)) {
+        e->referenced.store(true, std::memory_order_relaxed);
+      }
+      MaybePromote(e, query_id);
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (e != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      }
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MISS);
+    }
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCache::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+  auto old_state = e->state.fetch_sub(ClockHandle::kOneRef, std::memory_order_acq_rel);
+  assert(ClockHandle::NumRefs(old_state) > 0);
+  if (ClockHandle::NumRefs(old_state) == 1) {
+    pinned_usage_.fetch_sub(e->charge, std::memory_order_acq_rel);
+  }
+  // An unreferenced entry that is still in cache stays there until the clock hand evicts it.
+  if (old_state == ClockHandle::kOneRef) {
+    SubCacheUsage(ChargedSubCacheType(e)).fetch_sub(e->charge, std::memory_order_acq_rel);
+    e->Free(metrics_.get());
+  }
+}
+
+size_t ClockCache::Evict(size_t required) {
+  ClockHandleDeleter evicted(metrics_.get());
+  {
+    std::lock_guard<yb::percpu_rwlock> l(mutex_);
+    EvictFromClock(required, &evicted, SINGLE_TOUCH);
+    if (required > evicted.TotalCharge()) {
+      EvictFromClock(required, &evicted, MULTI_TOUCH);
+    }
+  }
+  return evicted.TotalCharge();
+}
+
+Status ClockCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                          void* value, size_t charge,
+                          void (*deleter)(const Slice& key, void* value),
+                          Cache::Handle** handle, Statistics* statistics) {
+  // Don't use the cache if disabled by the caller using the special query id.
+  if (query_id == kNoCacheQueryId) {
+    return Status::OK();
+  }
+  // Allocate the memory here outside of the mutex.
+  ClockHandle* e = ClockHandle::Create(key, hash, query_id, value, charge, deleter);
+  ClockHandle* rejected = nullptr;
+  Status s;
+  SubCacheType subcache_type;
+  ClockHandleDeleter last_reference_list(metrics_.get());
+
+  {
+    std::lock_guard<yb::percpu_rwlock> l(mutex_);
+    ClockHandle** ptr = FindPointer(key, hash);
+    ClockHandle* old = *ptr;
+    if (FLAGS_cache_single_touch_ratio == 0) {
+      e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+      subcache_type = MULTI_TOUCH;
+    } else if (FLAGS_cache_single_touch_ratio == 1) {
+      subcache_type = SINGLE_TOUCH;
+    } else if (query_id == kInMultiTouchId ||
+               (old != nullptr && (old->GetSubCacheType() == MULTI_TOUCH ||
+                                   old->query_id.load(std::memory_order_acquire) != query_id))) {
+      // Same as HandleTable::GetSubCacheTypeCandidate.
+      e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+      subcache_type = MULTI_TOUCH;
+    } else {
+      subcache_type = SINGLE_TOUCH;
+    }
+
+    EvictFromClock(charge, &last_reference_list, subcache_type);
+    if (strict_capacity_limit_ && IsOverCapacity(charge, subcache_type)) {
+      if (handle == nullptr) {
+        rejected = e;
+      } else {
+        delete[] reinterpret_cast<char*>(e);
+        *handle = nullptr;
+      }
+      s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+    } else {
+      // Eviction could have changed the chain, so look the key up again.
+      ptr = FindPointer(key, hash);
+      old = *ptr;
+      e->next_hash = old == nullptr ? nullptr : old->next_hash;
+      e->state.store(ClockHandle::kInCacheBit | (handle == nullptr ? 0 : ClockHandle::kOneRef),
+                     std::memory_order_release);
+      *ptr = e;
+      SubCacheUsage(subcache_type).fetch_add(charge, std::memory_order_acq_rel);
+      if (old != nullptr) {
+        RemovedFromTable(old, &last_reference_list);
+      } else if (++elems_ > length_) {
+        // Since each cache entry is fairly large, we aim for a small
+        // average linked list length (<= 1).
+        Resize();
+      }
+      if (handle != nullptr) {
+        pinned_usage_.fetch_add(charge, std::memory_order_acq_rel);
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+      if (metrics_ != nullptr) {
+        if (subcache_type == MULTI_TOUCH) {
+          metrics_->multi_touch_cache_usage->IncrementBy(charge);
+        } else {
+          metrics_->single_touch_cache_usage->IncrementBy(charge);
+        }
+        metrics_->cache_usage->IncrementBy(charge);
+      }
+      if (subcache_type == MULTI_TOUCH && FLAGS_cache_single_touch_ratio != 0) {
+        // See LRUCache::Insert.
+        EvictFromClock(0, &last_reference_list, SINGLE_TOUCH);
+      } else if (IsOverCapacity(0, MULTI_TOUCH)) {
+        // Lookups could have promoted entries over the multi touch capacity.
+        EvictFromClock(0, &last_reference_list, MULTI_TOUCH);
+      }
+    }
+  }
+
+  if (rejected != nullptr) {
+    // The entry was never charged to the cache, so it should not affect the metrics.
+    rejected->Free(nullptr /* metrics */);
+  }
+
+  if (statistics != nullptr) {
+    if (s.ok()) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+      if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+      }
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+  }
+
+  return s;
+}
+
+void ClockCache::Erase(const Slice& key, uint32_t hash) {
+  ClockHandleDeleter last_reference_list(metrics_.get());
+  {
+    std::lock_guard<yb::percpu_rwlock> l(mutex_);
+    ClockHandle** ptr = FindPointer(key, hash);
+    ClockHandle* e = *ptr;
+    if (e != nullptr) {
+      *ptr = e->next_hash;
+      --elems_;
+      RemovedFromTable(e, &last_reference_list);
+    }
+  }
+}
+
+void ClockCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) {
+  yb::rw_spinlock* lock = thread_safe ? &mutex_.get_lock() : nullptr;
+  if (lock != nullptr) {
+    lock->lock_shared();
+  }
+  for (uint32_t i = 0; i < length_; i++) {
+    for (ClockHandle* e = list_[i]; e != nullptr; e = e->next_hash) {
+      callback(e->value, e->charge);
+    }
+  }
+  if (lock != nullptr) {
+    lock->unlock_shared();
+  }
+}
+
 static int kNumShardBits = 4;          // default values, can be overridden
 
-class ShardedLRUCache : public Cache {
+// Cache that is split into 2^num_shard_bits shards of type CacheShard by hash of the key.
+template <class CacheShard, class CacheHandle>
+class ShardedCache : public Cache {
  private:
-  LRUCache* shards_;
+  CacheShard* shards_;
   port::Mutex id_mutex_;
   port::Mutex capacity_mutex_;
   uint64_t last_id_;
@@ -866,15 +1456,15 @@ class ShardedLRUCache : public Cache {
   }
 
  public:
-  ShardedLRUCache(size_t capacity, int num_shard_bits,
-                  bool strict_capacity_limit)
+  ShardedCache(size_t capacity, int num_shard_bits,
+               bool strict_capacity_limit)
       : last_id_(0),
         num_shard_bits_(num_shard_bits),
         capacity_(capacity),
         strict_capacity_limit_(strict_capacity_limit),
         metrics_(nullptr) {
     int num_shards = 1 << num_shard_bits_;
-    shards_ = new LRUCache[num_shards];
+    shards_ = new CacheShard[num_shards];
     const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
@@ -882,7 +1472,7 @@ class ShardedLRUCache : public Cache {
     }
   }
 
-  virtual ~ShardedLRUCache() {
+  virtual ~ShardedCache() {
     delete[] shards_;
   }
 
@@ -931,7 +1521,7 @@ class ShardedLRUCache : public Cache {
   }
 
   void Release(Handle* handle) override {
-    LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
+    CacheHandle* h = reinterpret_cast<CacheHandle*>(handle);
     shards_[Shard(h->hash)].Release(handle);
   }
 
@@ -941,7 +1531,7 @@ class ShardedLRUCache : public Cache {
   }
 
   void* Value(Handle* handle) override {
-    return reinterpret_cast<LRUHandle*>(handle)->value;
+    return reinterpret_cast<CacheHandle*>(handle)->value;
   }
 
   uint64_t NewId() override {
@@ -966,7 +1556,7 @@ class ShardedLRUCache : public Cache {
   }
 
   size_t GetUsage(Handle* handle) const override {
-    return reinterpret_cast<LRUHandle*>(handle)->charge;
+    return reinterpret_cast<CacheHandle*>(handle)->charge;
   }
 
   size_t GetPinnedUsage() const override {
@@ -980,7 +1570,7 @@ class ShardedLRUCache : public Cache {
   }
 
   SubCacheType GetSubCacheType(Handle* e) const override {
-    LRUHandle* h = reinterpret_cast<LRUHandle*>(e);
+    CacheHandle* h = reinterpret_cast<CacheHandle*>(e);
     return h->GetSubCacheType();
   }
 
@@ -1015,6 +1605,9 @@ class ShardedLRUCache : public Cache {
   }
 };
 
+typedef ShardedCache<LRUCache, LRUHandle> ShardedLRUCache;
+typedef ShardedCache<ClockCache, ClockHandle> ShardedClockCache;
+
 }  // end anonymous namespace
 
 shared_ptr<Cache> NewLRUCache(size_t capacity) {
@@ -1034,4 +1627,21 @@ shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                            strict_capacity_limit);
 }
 
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits) {
+  return NewClockCache(capacity, num_shard_bits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits,
+                                             strict_capacity_limit);
+}
+
 }  // namespace rocksdb
@@ -34,6 +34,8 @@ int main() {
 #include <stdio.h>
 #include <gflags/gflags.h>
 
+#include <vector>
+
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/env.h"
@@ -49,6 +51,9 @@ DEFINE_int32(threads, 16, "Number of concurrent threads to run.");
 DEFINE_int64(cache_size, 8 * KB * KB,
              "Number of bytes to use as a cache of uncompressed data.");
 DEFINE_int32(num_shard_bits, 4, "shard_bits.");
+DEFINE_bool(use_clock_cache, false, "Use CLOCK cache instead of LRU cache.");
+DEFINE_bool(compare_caches, false,
+            "Run the same workload against LRU and CLOCK caches, and report both results.");
 
 DEFINE_int64(max_key, 1 * KB * KB * KB, "Max number of key to place in cache");
 DEFINE_uint64(ops_per_thread, 1200000, "Number of operations per thread.");
@@ -144,8 +149,10 @@ struct ThreadState {
 
 class CacheBench {
  public:
-  CacheBench() :
-      cache_(NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)),
+  explicit CacheBench(bool use_clock_cache) :
+      cache_(use_clock_cache ? NewClockCache(FLAGS_cache_size, FLAGS_num_shard_bits)
+                             : NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits)),
+      cache_type_(use_clock_cache ? "CLOCK" : "LRU"),
       num_threads_(FLAGS_threads) {}
 
   ~CacheBench() {}
@@ -157,7 +164,7 @@ class CacheBench {
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       // do insert
-      cache_->Insert(key, new char[10], 1, &deleter);
+      cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
     }
   }
 
@@ -193,13 +200,14 @@ class CacheBench {
       double elapsed = static_cast<double>(end_time - start_time) * 1e-6;
       uint32_t qps = static_cast<uint32_t>(
           static_cast<double>(FLAGS_threads * FLAGS_ops_per_thread) / elapsed);
-      fprintf(stdout, "Complete in %.3f s; QPS = %u\n", elapsed, qps);
+      fprintf(stdout, "%s cache: complete in %.3f s; QPS = %u\n", cache_type_, elapsed, qps);
     }
     return true;
   }
 
  private:
   std::shared_ptr<Cache> cache_;
+  const char* cache_type_;
   uint32_t num_threads_;
 
   static void ThreadBody(void* v) {
@@ -235,11 +243,11 @@ class CacheBench {
       int32_t prob_op = thread->rnd.Uniform(100);
       if (prob_op >= 0 && prob_op < FLAGS_insert_percent) {
         // do insert
-        cache_->Insert(key, new char[10], 1, &deleter);
+        cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
       } else if (prob_op -= FLAGS_insert_percent &&
                  prob_op < FLAGS_lookup_percent) {
         // do lookup
-        auto handle = cache_->Lookup(key);
+        auto handle = cache_->Lookup(key, kDefaultQueryId);
         if (handle) {
           cache_->Release(handle);
         }
@@ -252,6 +260,7 @@ class CacheBench {
   }
 
   void PrintEnv() const {
+    printf("Cache type          : %s\n", cache_type_);
     printf("Number of threads   : %d\n", FLAGS_threads);
     printf("Ops per thread      : %" PRIu64 "\n", FLAGS_ops_per_thread);
     printf("Cache size          : %" PRIu64 "\n", FLAGS_cache_size);
@@ -274,15 +283,22 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
-  rocksdb::CacheBench bench;
-  if (FLAGS_populate_cache) {
-    bench.PopulateCache();
-  }
-  if (bench.Run()) {
-    return 0;
+  std::vector<bool> use_clock_cache;
+  if (FLAGS_compare_caches) {
+    use_clock_cache = {false, true};
   } else {
-    return 1;
+    use_clock_cache = {FLAGS_use_clock_cache};
+  }
+  for (bool use_clock : use_clock_cache) {
+    rocksdb::CacheBench bench(use_clock);
+    if (FLAGS_populate_cache) {
+      bench.PopulateCache();
+    }
+    if (!bench.Run()) {
+      return 1;
+    }
   }
+  return 0;
 }
 
 #endif  // GFLAGS
@@ -24,11 +24,13 @@
 #include "yb/rocksdb/cache.h"
 
 #include <forward_list>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <gflags/gflags.h>
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/random.h"
 #include "yb/util/string_util.h"
 #include "yb/rocksdb/util/testharness.h"
 
@@ -741,6 +743,183 @@ TEST_F(CacheTest, OverFlowTest) {
   cache->Release(h);
 }
 
+
+TEST_F(CacheTest, ClockHitAndMiss) {
+  auto cache = NewClockCache(kCacheSize, kNumShardBits);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(-1, Lookup(cache, 200));
+
+  ASSERT_OK(Insert(cache, 200, 201));
+  ASSERT_OK(Insert(cache, 100, 102));
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 200);
+  ASSERT_EQ(-1, Lookup(cache, 200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(1U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockEntriesArePinned) {
+  auto cache = NewClockCache(kCacheSize, kNumShardBits);
+  ASSERT_OK(Insert(cache, 100, 101, 5));
+  Cache::Handle* h1 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache->Value(h1)));
+  ASSERT_EQ(5U, cache->GetPinnedUsage());
+
+  ASSERT_OK(Insert(cache, 100, 102, 5));
+  Cache::Handle* h2 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(102, DecodeValue(cache->Value(h2)));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(10U, cache->GetUsage());
+  ASSERT_EQ(10U, cache->GetPinnedUsage());
+
+  cache->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(5U, cache->GetUsage());
+  ASSERT_EQ(5U, cache->GetPinnedUsage());
+
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+
+  cache->Release(h2);
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(102, deleted_values_[1]);
+  ASSERT_EQ(0U, cache->GetUsage());
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+}
+
+TEST_F(CacheTest, ClockEvictionPolicy) {
+  const int kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0);
+  for (int i = 0; i < kCapacity; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1));
+  }
+  Cache::Handle* pinned = cache->Lookup(EncodeKey(1), kTestQueryId);
+  // Sets the clock bit of the entry, so the hand should skip it on the first pass.
+  ASSERT_EQ(1, Lookup(cache, 0));
+
+  ASSERT_OK(Insert(cache, kCapacity, kCapacity + 1));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_NE(0, deleted_keys_[0]);
+  ASSERT_NE(1, deleted_keys_[0]);
+  ASSERT_EQ(1, Lookup(cache, 0));
+  ASSERT_EQ(kCapacity, cache->GetUsage());
+
+  // The pinned entry should survive a scan over the whole cache.
+  for (int i = 0; i < 3 * kCapacity; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, i));
+  }
+  ASSERT_EQ(2, DecodeValue(cache->Value(pinned)));
+  ASSERT_EQ(2, Lookup(cache, 1));
+  cache->Release(pinned);
+  ASSERT_EQ(kCapacity, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockMultiTouch) {
+  const QueryId qid1 = 1000;
+  const QueryId qid2 = 1001;
+  auto cache = NewClockCache(kCacheSize, kNumShardBits);
+  ASSERT_OK(Insert(cache, 100, 101, 1, qid1));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 100, 101, qid1));
+  // Lookup by another query moves the entry to the multi touch sub-cache.
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 100, 101, qid2));
+
+  ASSERT_OK(Insert(cache, 200, 201, 1, qid1));
+  ASSERT_OK(Insert(cache, 200, 202, 1, qid2));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 200, 202, qid2));
+
+  // Scan of single touch entries should not evict multi touch entries.
+  for (int i = 0; i < kCacheSize + 100; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i));
+    ASSERT_EQ(2000 + i, Lookup(cache, 1000 + i));
+  }
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 100, 101, qid1));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 200, 202, qid1));
+}
+
+TEST_F(CacheTest, ClockSetStrictCapacityLimit) {
+  auto cache = NewClockCache(10, 0, true);
+  std::vector<Cache::Handle*> handles(2);
+  Status s;
+
+  for (size_t i = 0; i < 2; i++) {
+    std::string key = ToString(i + 1);
+    s = cache->Insert(key, kTestQueryId, new Value(i + 1), 1, &deleter, &handles[i]);
+    ASSERT_TRUE(s.ok());
+    ASSERT_NE(nullptr, handles[i]);
+  }
+
+  Cache::Handle* handle;
+  std::string extra_key = "extra";
+  Value* extra_value = new Value(0);
+
+  s = cache->Insert(extra_key, kTestQueryId, extra_value, 1, &deleter, &handle);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  s = cache->Insert(extra_key, kTestQueryId, extra_value, 1, &deleter);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(2, cache->GetUsage());
+
+  for (size_t i = 0; i < 2; i++) {
+    cache->Release(handles[i]);
+  }
+}
+
+TEST_F(CacheTest, ClockConcurrentAccess) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumKeys = 2000;
+  constexpr int kOpsPerThread = 20000;
+  auto cache = NewClockCache(kCacheSize, kNumShardBits);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([cache, t] {
+      Random rnd(t + 1);
+      for (int i = 0; i != kOpsPerThread; ++i) {
+        const std::string key = EncodeKey(rnd.Uniform(kNumKeys));
+        // Use a few query ids, so entries are moved between sub-caches.
+        const QueryId query_id = rnd.Uniform(4);
+        switch (rnd.Uniform(4)) {
+          case 0:
+            ASSERT_OK(cache->Insert(key, query_id, EncodeValue(i), 1, &dumbDeleter));
+            break;
+          case 1:
+            cache->Erase(key);
+            break;
+          default: {
+            auto handle = cache->Lookup(key, query_id);
+            if (handle != nullptr) {
+              cache->Release(handle);
+            }
+            break;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+  size_t total_charge = 0;
+  for (const auto& usage : cache->TEST_GetIndividualUsages()) {
+    total_charge += usage.first + usage.second;
+  }
+  ASSERT_EQ(cache->GetUsage(), total_charge);
+  // Lookups could promote entries over the multi touch capacity, but only until the next insert.
+  ASSERT_LE(cache->GetUsage(), kCacheSize + kCacheSize / 10);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
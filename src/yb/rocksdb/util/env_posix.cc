@@ -64,6 +64,7 @@
 #include "yb/rocksdb/util/thread_local.h"
 #include "yb/rocksdb/util/thread_status_updater.h"
 
+#include "yb/util/logging.h"
 #include "yb/util/stats/iostats_context_imp.h"
 #include "yb/util/string_util.h"
 
@@ -131,6 +132,12 @@ static int LockOrUnlock(const std::string& fname, int fd, bool lock) {
   return value;
 }
 
+#if defined(__linux__)
+constexpr int kODirectReadFlags = O_DIRECT;
+#else
+constexpr int kODirectReadFlags = 0;
+#endif
+
 void SetFD_CLOEXEC(int fd, const EnvOptions* options) {
   if ((options == nullptr || options->set_fd_cloexec) && fd > 0) {
     fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
@@ -613,9 +620,18 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     result->reset();
     Status s;
     int fd;
+    const bool use_direct_reads = options.use_direct_reads && !options.use_mmap_reads;
+    bool direct_reads_failed = false;
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = open(fname.c_str(), O_RDONLY | (use_direct_reads ? kODirectReadFlags : 0));
+      if (fd < 0 && use_direct_reads && errno == EINVAL) {
+        // File system does not support O_DIRECT, e.g. tmpfs.
+        YB_LOG_FIRST_N(WARNING, 1) << "O_DIRECT is not supported for " << fname
+                                   << ", using buffered reads";
+        fd = open(fname.c_str(), O_RDONLY);
+        direct_reads_failed = true;
+      }
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
@@ -635,6 +651,8 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
         }
       }
       close(fd);
+    } else if (use_direct_reads && !direct_reads_failed) {
+      *result = std::make_unique<yb::PosixDirectIORandomAccessFile>(fname, fd, options);
     } else {
       *result = std::make_unique<yb::PosixRandomAccessFile>(fname, fd, options);
     }
@@ -808,6 +808,37 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, DirectReads) {
+  EnvOptions soptions;
+  std::string fname = test::TmpDir() + "/" + "testfile";
+  std::string data;
+  Random rnd(301);
+  RandomString(&rnd, 3 * 4096 + 100, &data);
+
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+
+  soptions.use_direct_reads = true;
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  std::string scratch(data.size(), '\0');
+  // Unaligned reads, including the ones that cross block boundaries and the end of the file.
+  for (auto offset_and_size : std::vector<std::pair<size_t, size_t>>{
+           {0, 11}, {4000, 200}, {4096, 4096}, {5, 2 * 4096}, {3 * 4096 + 50, 100}}) {
+    Slice result;
+    ASSERT_OK(file->Read(offset_and_size.first, offset_and_size.second, &result, &scratch[0]));
+    const auto expected_size =
+        std::min(offset_and_size.second, data.size() - offset_and_size.first);
+    ASSERT_EQ(data.substr(offset_and_size.first, expected_size), result.ToBuffer());
+  }
+
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // __linux__
 
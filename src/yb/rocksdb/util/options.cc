@@ -93,6 +93,7 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       row_cache(options.row_cache),
       mem_tracker(options.mem_tracker),
       block_based_table_mem_tracker(options.block_based_table_mem_tracker),
+      pinned_index_and_filter_mem_tracker(options.pinned_index_and_filter_mem_tracker),
       iterator_replacer(options.iterator_replacer) {}
 
 ColumnFamilyOptions::ColumnFamilyOptions()
@@ -353,6 +354,8 @@ void DBOptions::Dump(Logger* log) const {
          manifest_preallocation_size);
   RHEADER(log, "                         Options.allow_os_buffer: %d",
       allow_os_buffer);
+  RHEADER(log, "                        Options.use_direct_reads: %d",
+      use_direct_reads);
   RHEADER(log, "                        Options.allow_mmap_reads: %d",
       allow_mmap_reads);
   RHEADER(log, "                       Options.allow_mmap_writes: %d",
@@ -188,6 +188,9 @@ static std::unordered_map<std::string, OptionTypeInfo> db_options_type_info = {
     {"allow_os_buffer",
      {offsetof(struct DBOptions, allow_os_buffer), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
+    {"use_direct_reads",
+     {offsetof(struct DBOptions, use_direct_reads), OptionType::kBoolean,
+      OptionVerificationType::kNormal}},
     {"create_if_missing",
      {offsetof(struct DBOptions, create_if_missing), OptionType::kBoolean,
       OptionVerificationType::kNormal}},
@@ -515,6 +518,7 @@ static std::unordered_map<std::string,
     /* currently not supported
       std::shared_ptr<Cache> block_cache = nullptr;
       std::shared_ptr<Cache> block_cache_compressed = nullptr;
+      std::shared_ptr<const SliceTransform> data_block_key_prefix_extractor = nullptr;
      */
     {"flush_block_policy_factory",
      {offsetof(struct BlockBasedTableOptions, flush_block_policy_factory),
@@ -549,6 +553,9 @@ static std::unordered_map<std::string,
     {"index_block_restart_interval",
      {offsetof(struct BlockBasedTableOptions, index_block_restart_interval),
       OptionType::kInt, OptionVerificationType::kNormal}},
+    {"data_block_hash_table_util_ratio",
+     {offsetof(struct BlockBasedTableOptions, data_block_hash_table_util_ratio),
+      OptionType::kDouble, OptionVerificationType::kNormal}},
     {"index_block_size",
      {offsetof(struct BlockBasedTableOptions, index_block_size), OptionType::kSizeT,
       OptionVerificationType::kNormal}},
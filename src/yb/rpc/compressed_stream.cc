@@ -0,0 +1,946 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/compressed_stream.h"
+
+#include <lz4.h>
+
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/container/small_vector.hpp>
+
+#include "yb/gutil/casts.h"
+#include "yb/gutil/endian.h"
+
+#include "yb/rocksdb/util/compression.h"
+
+#include "yb/rpc/circular_read_buffer.h"
+#include "yb/rpc/outbound_data.h"
+
+#include "yb/util/coding.h"
+#include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/memory/memory_usage.h"
+#include "yb/util/monotime.h"
+#include "yb/util/net/sockaddr.h"
+#include "yb/util/net/socket.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/string_util.h"
+
+using namespace yb::size_literals;
+
+namespace {
+
+bool ValidateRpcCompressionAlgorithm(const char* flagname, const std::string& value);
+
+} // namespace
+
+DEFINE_string(rpc_compression_algorithm, "none",
+              "Algorithm used to compress messages sent over outbound RPC connections: none, "
+              "snappy or lz4. It is offered to the server when a connection is established, and "
+              "used only if the server accepts it. Servers accept compressed connections "
+              "regardless of the algorithm they use themselves.");
+TAG_FLAG(rpc_compression_algorithm, advanced);
+DEFINE_validator(rpc_compression_algorithm, &ValidateRpcCompressionAlgorithm);
+
+DEFINE_int32(rpc_compression_min_size, 1024,
+             "Messages smaller than this number of bytes are sent over compressed RPC connections "
+             "without compression.");
+TAG_FLAG(rpc_compression_min_size, advanced);
+TAG_FLAG(rpc_compression_min_size, runtime);
+
+DEFINE_test_flag(bool, rpc_reject_compression_header, false,
+                 "Close accepted connections that start with the compression header, as servers "
+                 "without compression support do.");
+
+METRIC_DEFINE_counter(server, rpc_compression_input_bytes,
+                      "RPC Compression Input Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes of outbound RPC messages passed to compression.");
+
+METRIC_DEFINE_counter(server, rpc_compression_output_bytes,
+                      "RPC Compression Output Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes sent for outbound RPC messages passed to compression. The "
+                      "compression ratio is rpc_compression_input_bytes divided by this value.");
+
+METRIC_DEFINE_counter(server, rpc_compression_time_us,
+                      "RPC Compression Time",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent by reactor threads compressing outbound RPC messages.");
+
+METRIC_DEFINE_counter(server, rpc_decompression_time_us,
+                      "RPC Decompression Time",
+                      yb::MetricUnit::kMicroseconds,
+                      "Time spent by reactor threads decompressing inbound RPC messages.");
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+// Sent by the connecting side before any other data, followed by one byte with the offered
+// compression type. The accepting side replies with the same magic followed by the accepted
+// compression type, or kNoCompression if it declines the offer.
+const char kCompressionHeaderMagic[] = { 'Y', 'B', 'C' };
+constexpr size_t kCompressionHeaderSize = sizeof(kCompressionHeaderMagic) + 1;
+
+// Servers that do not support compression close connection after receiving the compression
+// header. Connections to such servers are not compressed during this time.
+constexpr auto kPeerWithoutCompressionTimeout = std::chrono::minutes(5);
+
+// Each frame starts with payload size in network byte order, followed by one byte with payload
+// compression type.
+constexpr size_t kFrameHeaderSize = sizeof(uint32_t) + 1;
+
+// Messages are compressed in chunks of at most this size. So compressed frame always fits into
+// the read buffer and memory used for decompression is bounded.
+constexpr size_t kMaxChunkSize = 64_KB;
+
+constexpr size_t kMinReadBufferSize = 256_KB;
+
+// Handles returned for data queued before the compression state is known. They never overlap
+// with handles of the lower stream, which count data blocks sent since stream start.
+constexpr size_t kPendingHandleFlag = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+YB_DEFINE_ENUM(CompressionState, (kInitial)(kEnabled)(kDisabled));
+
+Result<rocksdb::CompressionType> ParseCompressionAlgorithm(const std::string& value) {
+  const auto name = boost::algorithm::to_lower_copy(value);
+  if (name == "none") {
+    return rocksdb::kNoCompression;
+  }
+  if (name == "snappy") {
+    return rocksdb::kSnappyCompression;
+  }
+  if (name == "lz4") {
+    return rocksdb::kLZ4Compression;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown RPC compression algorithm: $0", value);
+}
+
+bool IsValidCompressionType(uint8_t type) {
+  switch (type) {
+    case rocksdb::kNoCompression: FALLTHROUGH_INTENDED;
+    case rocksdb::kSnappyCompression: FALLTHROUGH_INTENDED;
+    case rocksdb::kLZ4Compression:
+      return true;
+  }
+  return false;
+}
+
+// Remote endpoints of servers that closed connection instead of replying to the compression
+// header.
+class PeersWithoutCompression {
+ public:
+  void Add(const Endpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peers_[endpoint] = CoarseMonoClock::now() + kPeerWithoutCompressionTimeout;
+  }
+
+  bool Contains(const Endpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peers_.find(endpoint);
+    if (it == peers_.end()) {
+      return false;
+    }
+    if (it->second < CoarseMonoClock::now()) {
+      peers_.erase(it);
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<Endpoint, CoarseTimePoint, EndpointHash> peers_;
+};
+
+bool Compress(rocksdb::CompressionType type, const Slice& input, std::string* output) {
+  rocksdb::CompressionOptions options;
+  switch (type) {
+    case rocksdb::kSnappyCompression:
+      return rocksdb::Snappy_Compress(options, input.cdata(), input.size(), output);
+    case rocksdb::kLZ4Compression: {
+      // LZ4 block is preceded by the decompressed size, that LZ4 does not store itself.
+      const int bound = LZ4_compressBound(static_cast<int>(input.size()));
+      output->resize(kMaxVarint32Length + bound);
+      auto* start = pointer_cast<uint8_t*>(&(*output)[0]);
+      auto* block = EncodeVarint32(start, static_cast<uint32_t>(input.size()));
+      const int compressed_size = LZ4_compress_default(
+          input.cdata(), pointer_cast<char*>(block), static_cast<int>(input.size()), bound);
+      if (compressed_size <= 0) {
+        return false;
+      }
+      output->resize(block - start + compressed_size);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+Status Decompress(rocksdb::CompressionType type, const Slice& input, std::string* output) {
+  switch (type) {
+    case rocksdb::kSnappyCompression: {
+      size_t size = 0;
+      if (!rocksdb::Snappy_GetUncompressedLength(input.cdata(), input.size(), &size) ||
+          size > kMaxChunkSize) {
+        break;
+      }
+      output->resize(size);
+      if (!rocksdb::Snappy_Uncompress(input.cdata(), input.size(), &(*output)[0])) {
+        break;
+      }
+      return Status::OK();
+    }
+    case rocksdb::kLZ4Compression: {
+      // Check the decompressed size before allocating memory for it.
+      uint32_t decompressed_size = 0;
+      const uint8_t* block = GetVarint32Ptr(input.data(), input.end(), &decompressed_size);
+      if (!block || decompressed_size > kMaxChunkSize) {
+        break;
+      }
+      output->resize(decompressed_size);
+      const int actual_size = LZ4_decompress_safe(
+          pointer_cast<const char*>(block), &(*output)[0],
+          static_cast<int>(input.end() - block), static_cast<int>(decompressed_size));
+      if (actual_size != static_cast<int>(decompressed_size)) {
+        break;
+      }
+      return Status::OK();
+    }
+    default:
+      break;
+  }
+  return STATUS_FORMAT(NetworkError, "Failed to decompress $0 bytes of $1 RPC frame",
+                       input.size(), rocksdb::CompressionTypeToString(type));
+}
+
+void IncrementCounterBy(const scoped_refptr<Counter>& counter, int64_t amount) {
+  if (counter) {
+    counter->IncrementBy(amount);
+  }
+}
+
+struct CompressionMetrics {
+  explicit CompressionMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
+    if (metric_entity) {
+      input_bytes = METRIC_rpc_compression_input_bytes.Instantiate(metric_entity);
+      output_bytes = METRIC_rpc_compression_output_bytes.Instantiate(metric_entity);
+      compression_time_us = METRIC_rpc_compression_time_us.Instantiate(metric_entity);
+      decompression_time_us = METRIC_rpc_decompression_time_us.Instantiate(metric_entity);
+    }
+  }
+
+  scoped_refptr<Counter> input_bytes;
+  scoped_refptr<Counter> output_bytes;
+  scoped_refptr<Counter> compression_time_us;
+  scoped_refptr<Counter> decompression_time_us;
+};
+
+class CompressedOutboundData : public OutboundData {
+ public:
+  typedef boost::container::small_vector<RefCntBuffer, 4> Buffers;
+
+  CompressedOutboundData(Buffers buffers, OutboundDataPtr lower_data)
+      : buffers_(std::move(buffers)), lower_data_(std::move(lower_data)) {}
+
+  void Transferred(const Status& status, Connection* conn) override {
+    if (lower_data_) {
+      lower_data_->Transferred(status, conn);
+    }
+  }
+
+  bool DumpPB(const DumpRunningRpcsRequestPB& req, RpcCallInProgressPB* resp) override {
+    return false;
+  }
+
+  void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) override {
+    for (auto& buffer : buffers_) {
+      output->push_back(std::move(buffer));
+    }
+    buffers_.clear();
+  }
+
+  bool IsFinished() const override {
+    return lower_data_ && lower_data_->IsFinished();
+  }
+
+  bool IsHeartbeat() const override {
+    return lower_data_ && lower_data_->IsHeartbeat();
+  }
+
+  std::string ToString() const override {
+    return Format("Compressed[$0]", lower_data_);
+  }
+
+  size_t ObjectSize() const override { return sizeof(*this); }
+
+  size_t DynamicMemoryUsage() const override {
+    size_t result = DynamicMemoryUsageOf(lower_data_);
+    for (const auto& buffer : buffers_) {
+      result += buffer.DynamicMemoryUsage();
+    }
+    return result;
+  }
+
+ private:
+  Buffers buffers_;
+  OutboundDataPtr lower_data_;
+};
+
+RefCntBuffer FrameHeader(rocksdb::CompressionType type, size_t payload_size) {
+  RefCntBuffer result(kFrameHeaderSize);
+  NetworkByteOrder::Store32(result.data(), static_cast<uint32_t>(payload_size));
+  result.data()[sizeof(uint32_t)] = type;
+  return result;
+}
+
+RefCntBuffer Frame(rocksdb::CompressionType type, const Slice& payload) {
+  RefCntBuffer result(kFrameHeaderSize + payload.size());
+  NetworkByteOrder::Store32(result.data(), static_cast<uint32_t>(payload.size()));
+  result.data()[sizeof(uint32_t)] = type;
+  memcpy(result.data() + kFrameHeaderSize, payload.data(), payload.size());
+  return result;
+}
+
+class CompressedStream : public Stream, public StreamContext {
+ public:
+  CompressedStream(
+      std::unique_ptr<Stream> lower_stream, rocksdb::CompressionType compression_type,
+      size_t receive_buffer_size, const MemTrackerPtr& buffer_tracker,
+      std::shared_ptr<CompressionMetrics> metrics,
+      std::shared_ptr<PeersWithoutCompression> peers_without_compression)
+      : lower_stream_(std::move(lower_stream)), compression_type_(compression_type),
+        read_buffer_size_(std::max(receive_buffer_size, kMinReadBufferSize)),
+        buffer_tracker_(buffer_tracker), metrics_(std::move(metrics)),
+        peers_without_compression_(std::move(peers_without_compression)) {
+  }
+
+  CompressedStream(const CompressedStream&) = delete;
+  void operator=(const CompressedStream&) = delete;
+
+  size_t GetPendingWriteBytes() override {
+    return lower_stream_->GetPendingWriteBytes();
+  }
+
+ private:
+  CHECKED_STATUS Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
+  void Close() override;
+  void Shutdown(const Status& status) override;
+  size_t Send(OutboundDataPtr data) override;
+  CHECKED_STATUS TryWrite() override;
+  void ParseReceived() override;
+  void Cancelled(size_t handle) override;
+
+  bool Idle(std::string* reason_not_idle) override;
+  bool IsConnected() override;
+  void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
+
+  const Endpoint& Remote() override;
+  const Endpoint& Local() override;
+
+  const Protocol* GetProtocol() override {
+    return lower_stream_->GetProtocol();
+  }
+
+  // Implementation StreamContext
+  void UpdateLastActivity() override;
+  void UpdateLastRead() override;
+  void UpdateLastWrite() override;
+  void Transferred(const OutboundDataPtr& data, const Status& status) override;
+  void Destroy(const Status& status) override;
+  Result<ProcessDataResult> ProcessReceived(
+      const IoVecs& data, ReadBufferFull read_buffer_full) override;
+  void Connected() override;
+  StreamReadBuffer& ReadBuffer() override;
+
+  std::string ToString() override;
+
+  void Established(CompressionState state);
+
+  void SendCompressionHeader();
+
+  // Detects whether the connecting peer offers compression by the first received bytes, and
+  // replies to the offer.
+  Result<ProcessDataResult> DetectCompression(const IoVecs& data);
+
+  // Processes reply of the accepting peer to the compression offer.
+  Result<ProcessDataResult> ProcessCompressionReply(const IoVecs& data);
+
+  // Parses received frames and passes their content to the upper layer.
+  Result<ProcessDataResult> ProcessFrames(const IoVecs& data);
+
+  // Passes data to the upper layer, same as the underlying stream passes data read from socket.
+  CHECKED_STATUS DeliverToContext(Slice data);
+  CHECKED_STATUS DeliverToContext(const IoVecs& data, size_t begin, size_t end);
+
+  // Splits serialized data into frames, compressing frames when worthwhile.
+  OutboundDataPtr MakeFrames(OutboundDataPtr data);
+  RefCntBuffer CompressChunk(const Slice& chunk);
+
+  std::unique_ptr<Stream> lower_stream_;
+  // For the connecting side it is the offered compression type until negotiation completes. After
+  // that it is the compression type used by both sides.
+  rocksdb::CompressionType compression_type_;
+  const size_t read_buffer_size_;
+  const MemTrackerPtr buffer_tracker_;
+  const std::shared_ptr<CompressionMetrics> metrics_;
+  const std::shared_ptr<PeersWithoutCompression> peers_without_compression_;
+  StreamContext* context_ = nullptr;
+  bool connect_ = false;
+  CompressionState state_ = CompressionState::kInitial;
+  // Compression header sent by the connecting side, until it is transferred to the peer.
+  OutboundDataPtr compression_header_;
+  bool compression_header_transferred_ = false;
+  // Data sent before the compression state is known. Entries of cancelled data are reset.
+  std::vector<OutboundDataPtr> pending_data_;
+  // Lower stream handles of pending_data_ entries, filled when they are passed to the lower
+  // stream.
+  std::vector<size_t> pending_handles_;
+
+  // Receives the compression header of the peer, until the compression state is known. So that a
+  // pass-through stream does not keep a read buffer of its own.
+  std::unique_ptr<CircularReadBuffer> header_read_buffer_;
+  // Receives frames, when compression is enabled.
+  std::unique_ptr<CircularReadBuffer> read_buffer_;
+
+  // Bytes left to pass to the upper layer from the uncompressed frame being received.
+  size_t raw_bytes_left_ = 0;
+  // Bytes that the upper layer asked to skip.
+  size_t upper_bytes_to_skip_ = 0;
+
+  std::string staging_buffer_;
+  std::string compressed_buffer_;
+  std::string decompressed_buffer_;
+};
+
+Status CompressedStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context) {
+  context_ = context;
+  connect_ = connect;
+  const bool negotiate = !connect || compression_type_ != rocksdb::kNoCompression;
+  if (negotiate) {
+    header_read_buffer_ = std::make_unique<CircularReadBuffer>(
+        kCompressionHeaderSize, buffer_tracker_);
+  }
+  RETURN_NOT_OK(lower_stream_->Start(connect, loop, this));
+  if (connect) {
+    if (negotiate) {
+      // Data is queued until the server replies, so it is known whether to compress it.
+      SendCompressionHeader();
+    } else {
+      Established(CompressionState::kDisabled);
+    }
+  }
+  return Status::OK();
+}
+
+void CompressedStream::Close() {
+  lower_stream_->Close();
+}
+
+void CompressedStream::Shutdown(const Status& status) {
+  for (auto& data : pending_data_) {
+    if (data) {
+      context_->Transferred(data, status);
+    }
+  }
+  pending_data_.clear();
+
+  lower_stream_->Shutdown(status);
+}
+
+size_t CompressedStream::Send(OutboundDataPtr data) {
+  switch (state_) {
+    case CompressionState::kInitial:
+      pending_data_.push_back(std::move(data));
+      return kPendingHandleFlag | (pending_data_.size() - 1);
+    case CompressionState::kEnabled:
+      return lower_stream_->Send(MakeFrames(std::move(data)));
+    case CompressionState::kDisabled:
+      return lower_stream_->Send(std::move(data));
+  }
+  FATAL_INVALID_ENUM_VALUE(CompressionState, state_);
+}
+
+OutboundDataPtr CompressedStream::MakeFrames(OutboundDataPtr data) {
+  boost::container::small_vector<RefCntBuffer, 4> input;
+  data->Serialize(&input);
+  size_t input_size = 0;
+  for (const auto& buffer : input) {
+    input_size += buffer.size();
+  }
+
+  CompressedOutboundData::Buffers frames;
+  if (compression_type_ == rocksdb::kNoCompression ||
+      input_size < implicit_cast<size_t>(FLAGS_rpc_compression_min_size)) {
+    // Send as a single uncompressed frame, that refers to serialized buffers without copying them.
+    frames.push_back(FrameHeader(rocksdb::kNoCompression, input_size));
+    for (auto& buffer : input) {
+      frames.push_back(std::move(buffer));
+    }
+    return std::make_shared<CompressedOutboundData>(std::move(frames), std::move(data));
+  }
+
+  auto start = MonoTime::Now();
+  size_t output_size = 0;
+  size_t buffer_idx = 0;
+  size_t buffer_pos = 0;
+  auto skip_consumed_buffers = [&input, &buffer_idx, &buffer_pos] {
+    while (buffer_pos == input[buffer_idx].size()) {
+      ++buffer_idx;
+      buffer_pos = 0;
+    }
+  };
+  for (size_t left = input_size; left > 0;) {
+    const size_t chunk_size = std::min(left, kMaxChunkSize);
+    left -= chunk_size;
+    skip_consumed_buffers();
+    Slice chunk;
+    if (input[buffer_idx].size() - buffer_pos >= chunk_size) {
+      // Chunk is contained in a single buffer, so could be compressed in place.
+      chunk = Slice(input[buffer_idx].data() + buffer_pos, chunk_size);
+      buffer_pos += chunk_size;
+    } else {
+      staging_buffer_.clear();
+      while (staging_buffer_.size() < chunk_size) {
+        skip_consumed_buffers();
+        const size_t len = std::min(
+            input[buffer_idx].size() - buffer_pos, chunk_size - staging_buffer_.size());
+        staging_buffer_.append(input[buffer_idx].data() + buffer_pos, len);
+        buffer_pos += len;
+      }
+      chunk = staging_buffer_;
+    }
+    frames.push_back(CompressChunk(chunk));
+    output_size += frames.back().size();
+  }
+
+  IncrementCounterBy(metrics_->input_bytes, input_size);
+  IncrementCounterBy(metrics_->output_bytes, output_size);
+  IncrementCounterBy(
+      metrics_->compression_time_us, MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+
+  return std::make_shared<CompressedOutboundData>(std::move(frames), std::move(data));
+}
+
+RefCntBuffer CompressedStream::CompressChunk(const Slice& chunk) {
+  compressed_buffer_.clear();
+  if (!Compress(compression_type_, chunk, &compressed_buffer_) ||
+      compressed_buffer_.size() >= chunk.size()) {
+    // Data that does not compress is sent as is.
+    return Frame(rocksdb::kNoCompression, chunk);
+  }
+  return Frame(compression_type_, compressed_buffer_);
+}
+
+Status CompressedStream::TryWrite() {
+  return lower_stream_->TryWrite();
+}
+
+void CompressedStream::ParseReceived() {
+  lower_stream_->ParseReceived();
+}
+
+void CompressedStream::Cancelled(size_t handle) {
+  if (handle & kPendingHandleFlag) {
+    const size_t index = handle & ~kPendingHandleFlag;
+    if (state_ == CompressionState::kInitial) {
+      // Not passed to the lower stream yet, so it is enough to drop it.
+      if (index < pending_data_.size()) {
+        pending_data_[index] = nullptr;
+      }
+      return;
+    }
+    if (index >= pending_handles_.size()) {
+      return;
+    }
+    handle = pending_handles_[index];
+    if (handle == std::numeric_limits<size_t>::max()) {
+      return;
+    }
+  }
+  lower_stream_->Cancelled(handle);
+}
+
+bool CompressedStream::Idle(std::string* reason_not_idle) {
+  bool result = true;
+  if (raw_bytes_left_ != 0) {
+    if (reason_not_idle) {
+      AppendWithSeparator("receiving uncompressed frame", reason_not_idle);
+    }
+    result = false;
+  }
+  return lower_stream_->Idle(reason_not_idle) && result;
+}
+
+bool CompressedStream::IsConnected() {
+  return lower_stream_->IsConnected();
+}
+
+void CompressedStream::DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {
+  lower_stream_->DumpPB(req, resp);
+}
+
+const Endpoint& CompressedStream::Remote() {
+  return lower_stream_->Remote();
+}
+
+const Endpoint& CompressedStream::Local() {
+  return lower_stream_->Local();
+}
+
+std::string CompressedStream::ToString() {
+  if (state_ == CompressionState::kDisabled) {
+    return lower_stream_->ToString();
+  }
+  return Format("COMPRESSED $0 $1", state_, lower_stream_->ToString());
+}
+
+void CompressedStream::UpdateLastActivity() {
+  context_->UpdateLastActivity();
+}
+
+void CompressedStream::UpdateLastRead() {
+  context_->UpdateLastRead();
+}
+
+void CompressedStream::UpdateLastWrite() {
+  context_->UpdateLastWrite();
+}
+
+void CompressedStream::Transferred(const OutboundDataPtr& data, const Status& status) {
+  if (compression_header_ && data == compression_header_) {
+    compression_header_transferred_ = status.ok();
+    compression_header_ = nullptr;
+  }
+  context_->Transferred(data, status);
+}
+
+void CompressedStream::Destroy(const Status& status) {
+  if (state_ == CompressionState::kInitial && compression_header_transferred_) {
+    // Server closed connection after receiving the compression header, so it does not support
+    // compression. Following connections to it are not compressed, so only calls queued on this
+    // connection fail while servers are being upgraded.
+    LOG_WITH_PREFIX(INFO) << "Server closed connection without replying to compression header, "
+                          << "disabling compression for it: " << status;
+    peers_without_compression_->Add(Remote());
+  }
+  context_->Destroy(status);
+}
+
+void CompressedStream::Connected() {
+  context_->Connected();
+}
+
+StreamReadBuffer& CompressedStream::ReadBuffer() {
+  switch (state_) {
+    case CompressionState::kInitial:
+      return *header_read_buffer_;
+    case CompressionState::kEnabled:
+      return *read_buffer_;
+    case CompressionState::kDisabled:
+      return context_->ReadBuffer();
+  }
+  FATAL_INVALID_ENUM_VALUE(CompressionState, state_);
+}
+
+void CompressedStream::Established(CompressionState state) {
+  VLOG_WITH_PREFIX(4) << "Established with state: " << state;
+
+  state_ = state;
+  ResetLogPrefix();
+  if (state == CompressionState::kEnabled) {
+    read_buffer_ = std::make_unique<CircularReadBuffer>(read_buffer_size_, buffer_tracker_);
+  }
+  pending_handles_.reserve(pending_data_.size());
+  for (auto& data : pending_data_) {
+    pending_handles_.push_back(
+        data ? Send(std::move(data)) : std::numeric_limits<size_t>::max());
+  }
+  pending_data_.clear();
+}
+
+void CompressedStream::SendCompressionHeader() {
+  RefCntBuffer header(kCompressionHeaderSize);
+  memcpy(header.data(), kCompressionHeaderMagic, sizeof(kCompressionHeaderMagic));
+  header.data()[sizeof(kCompressionHeaderMagic)] = compression_type_;
+  auto data = std::make_shared<CompressedOutboundData>(
+      CompressedOutboundData::Buffers{std::move(header)}, nullptr);
+  if (connect_) {
+    compression_header_ = data;
+  }
+  lower_stream_->Send(std::move(data));
+}
+
+Result<ProcessDataResult> CompressedStream::ProcessReceived(
+    const IoVecs& data, ReadBufferFull read_buffer_full) {
+  switch (state_) {
+    case CompressionState::kInitial:
+      return connect_ ? ProcessCompressionReply(data) : DetectCompression(data);
+    case CompressionState::kEnabled:
+      return ProcessFrames(data);
+    case CompressionState::kDisabled:
+      return context_->ProcessReceived(data, read_buffer_full);
+  }
+  return STATUS_FORMAT(IllegalState, "Unexpected state: $0", to_underlying(state_));
+}
+
+Result<ProcessDataResult> CompressedStream::DetectCompression(const IoVecs& data) {
+  // Data is read into header_read_buffer_, so there could not be more than a header.
+  char header[kCompressionHeaderSize];
+  const size_t size = IoVecsFullSize(data);
+  IoVecsToBuffer(data, 0, size, header);
+
+  if (memcmp(header, kCompressionHeaderMagic,
+             std::min(size, sizeof(kCompressionHeaderMagic))) != 0) {
+    // Peer does not use compression. Pass already received bytes to the upper layer, the rest
+    // will be read directly into the upper layer buffer.
+    Established(CompressionState::kDisabled);
+    RETURN_NOT_OK(DeliverToContext(Slice(header, size)));
+    return ProcessDataResult{ size, Slice(), std::exchange(upper_bytes_to_skip_, 0) };
+  }
+
+  if (size < kCompressionHeaderSize) {
+    return ProcessDataResult{ 0, Slice() };
+  }
+
+  if (FLAGS_TEST_rpc_reject_compression_header) {
+    return STATUS_FORMAT(NetworkError, "Invalid connection header: $0",
+                         Slice(header, size).ToDebugHexString());
+  }
+
+  // Offer of a compression type that is not supported is declined, so the peer falls back to
+  // sending uncompressed data.
+  const uint8_t offered_type = header[sizeof(kCompressionHeaderMagic)];
+  compression_type_ = IsValidCompressionType(offered_type)
+      ? static_cast<rocksdb::CompressionType>(offered_type) : rocksdb::kNoCompression;
+  VLOG_WITH_PREFIX(4) << "Offered compression: " << static_cast<int>(offered_type)
+                      << ", accepted: " << rocksdb::CompressionTypeToString(compression_type_);
+  SendCompressionHeader();
+  Established(compression_type_ == rocksdb::kNoCompression ? CompressionState::kDisabled
+                                                           : CompressionState::kEnabled);
+  return ProcessDataResult{ size, Slice() };
+}
+
+Result<ProcessDataResult> CompressedStream::ProcessCompressionReply(const IoVecs& data) {
+  // Data is read into header_read_buffer_, so there could not be more than a header.
+  const size_t size = IoVecsFullSize(data);
+  if (size < kCompressionHeaderSize) {
+    return ProcessDataResult{ 0, Slice() };
+  }
+  char header[kCompressionHeaderSize];
+  IoVecsToBuffer(data, 0, size, header);
+  if (memcmp(header, kCompressionHeaderMagic, sizeof(kCompressionHeaderMagic)) != 0) {
+    return STATUS_FORMAT(NetworkError, "Invalid RPC compression header: $0",
+                         Slice(header, kCompressionHeaderSize).ToDebugHexString());
+  }
+
+  const uint8_t accepted_type = header[sizeof(kCompressionHeaderMagic)];
+  VLOG_WITH_PREFIX(4) << "Accepted compression: " << static_cast<int>(accepted_type);
+  if (accepted_type == rocksdb::kNoCompression) {
+    compression_type_ = rocksdb::kNoCompression;
+    Established(CompressionState::kDisabled);
+  } else if (accepted_type == compression_type_) {
+    Established(CompressionState::kEnabled);
+  } else {
+    return STATUS_FORMAT(NetworkError, "Unexpected accepted RPC compression type: $0, offered: $1",
+                         static_cast<int>(accepted_type), static_cast<int>(compression_type_));
+  }
+  return ProcessDataResult{ size, Slice() };
+}
+
+Result<ProcessDataResult> CompressedStream::ProcessFrames(const IoVecs& data) {
+  const size_t full_size = IoVecsFullSize(data);
+  size_t consumed = 0;
+
+  while (consumed < full_size) {
+    if (raw_bytes_left_ != 0) {
+      const size_t len = std::min(raw_bytes_left_, full_size - consumed);
+      RETURN_NOT_OK(DeliverToContext(data, consumed, consumed + len));
+      raw_bytes_left_ -= len;
+      consumed += len;
+      continue;
+    }
+
+    if (full_size - consumed < kFrameHeaderSize) {
+      break;
+    }
+    char frame_header[kFrameHeaderSize];
+    IoVecsToBuffer(data, consumed, consumed + kFrameHeaderSize, frame_header);
+    const size_t payload_size = NetworkByteOrder::Load32(frame_header);
+    const uint8_t type = frame_header[sizeof(uint32_t)];
+
+    if (type == rocksdb::kNoCompression) {
+      // Uncompressed frames are passed to the upper layer as they arrive, so they could be of any
+      // size.
+      raw_bytes_left_ = payload_size;
+      consumed += kFrameHeaderSize;
+      continue;
+    }
+    if (type != compression_type_) {
+      return STATUS_FORMAT(NetworkError, "Unexpected RPC frame compression type: $0, expected: $1",
+                           static_cast<int>(type), static_cast<int>(compression_type_));
+    }
+    if (payload_size > kMaxChunkSize) {
+      return STATUS_FORMAT(NetworkError, "Too big compressed RPC frame: $0", payload_size);
+    }
+    if (full_size - consumed - kFrameHeaderSize < payload_size) {
+      break;
+    }
+    consumed += kFrameHeaderSize;
+
+    // Frame could be split between the end and the beginning of the circular buffer.
+    Slice payload;
+    size_t offset = 0;
+    for (const auto& iov : data) {
+      if (consumed >= offset && consumed + payload_size <= offset + iov.iov_len) {
+        payload = Slice(static_cast<const char*>(iov.iov_base) + consumed - offset, payload_size);
+        break;
+      }
+      offset += iov.iov_len;
+    }
+    if (payload.data() == nullptr) {
+      compressed_buffer_.resize(payload_size);
+      IoVecsToBuffer(data, consumed, consumed + payload_size, &compressed_buffer_[0]);
+      payload = compressed_buffer_;
+    }
+
+    auto start = MonoTime::Now();
+    RETURN_NOT_OK(Decompress(compression_type_, payload, &decompressed_buffer_));
+    IncrementCounterBy(
+        metrics_->decompression_time_us, MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+
+    RETURN_NOT_OK(DeliverToContext(decompressed_buffer_));
+    consumed += payload_size;
+  }
+
+  return ProcessDataResult{ consumed, Slice() };
+}
+
+Status CompressedStream::DeliverToContext(const IoVecs& data, size_t begin, size_t end) {
+  size_t offset = 0;
+  for (const auto& iov : data) {
+    const size_t iov_begin = std::max(begin, offset);
+    const size_t iov_end = std::min(end, offset + iov.iov_len);
+    if (iov_begin < iov_end) {
+      RETURN_NOT_OK(DeliverToContext(Slice(
+          static_cast<const char*>(iov.iov_base) + iov_begin - offset, iov_end - iov_begin)));
+    }
+    offset += iov.iov_len;
+  }
+  return Status::OK();
+}
+
+Status CompressedStream::DeliverToContext(Slice data) {
+  auto& read_buffer = context_->ReadBuffer();
+  while (!data.empty()) {
+    if (upper_bytes_to_skip_ != 0) {
+      const size_t len = std::min(upper_bytes_to_skip_, data.size());
+      data.remove_prefix(len);
+      upper_bytes_to_skip_ -= len;
+      continue;
+    }
+
+    auto out = VERIFY_RESULT(read_buffer.PrepareAppend());
+    size_t appended = 0;
+    for (const auto& iov : out) {
+      const size_t len = std::min(iov.iov_len, data.size());
+      memcpy(iov.iov_base, data.data(), len);
+      data.remove_prefix(len);
+      appended += len;
+      if (data.empty()) {
+        break;
+      }
+    }
+    read_buffer.DataAppended(appended);
+
+    if (read_buffer.ReadyToRead()) {
+      auto result = VERIFY_RESULT(context_->ProcessReceived(
+          read_buffer.AppendedVecs(), ReadBufferFull(read_buffer.Full())));
+      read_buffer.Consume(result.consumed, result.buffer);
+      DCHECK_EQ(upper_bytes_to_skip_, 0);
+      upper_bytes_to_skip_ = result.bytes_to_skip;
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+StreamFactoryPtr CompressedStreamFactory(
+    StreamFactoryPtr lower_layer_factory, const MemTrackerPtr& buffer_tracker,
+    const scoped_refptr<MetricEntity>& metric_entity) {
+  class CompressedStreamFactory : public StreamFactory {
+   public:
+    CompressedStreamFactory(
+        StreamFactoryPtr lower_layer_factory, const MemTrackerPtr& buffer_tracker,
+        const scoped_refptr<MetricEntity>& metric_entity)
+        : lower_layer_factory_(std::move(lower_layer_factory)), buffer_tracker_(buffer_tracker),
+          metrics_(std::make_shared<CompressionMetrics>(metric_entity)),
+          peers_without_compression_(std::make_shared<PeersWithoutCompression>()) {
+    }
+
+   private:
+    std::unique_ptr<Stream> Create(const StreamCreateData& data) override {
+      auto receive_buffer_size = data.socket->GetReceiveBufferSize();
+      if (!receive_buffer_size.ok()) {
+        LOG(WARNING) << "Compressed stream failure: " << receive_buffer_size.status();
+        receive_buffer_size = kMinReadBufferSize;
+      }
+      auto compression_type = ParseCompressionAlgorithm(FLAGS_rpc_compression_algorithm);
+      if (!compression_type.ok() || !IsValidCompressionType(*compression_type)) {
+        YB_LOG_EVERY_N_SECS(WARNING, 60)
+            << "RPC compression algorithm " << FLAGS_rpc_compression_algorithm
+            << " is not supported, sending uncompressed data";
+        compression_type = rocksdb::kNoCompression;
+      }
+      if (*compression_type != rocksdb::kNoCompression &&
+          peers_without_compression_->Contains(data.remote)) {
+        compression_type = rocksdb::kNoCompression;
+      }
+      auto lower_stream = lower_layer_factory_->Create(data);
+      return std::make_unique<CompressedStream>(
+          std::move(lower_stream), *compression_type, *receive_buffer_size, buffer_tracker_,
+          metrics_, peers_without_compression_);
+    }
+
+    StreamFactoryPtr lower_layer_factory_;
+    MemTrackerPtr buffer_tracker_;
+    std::shared_ptr<CompressionMetrics> metrics_;
+    std::shared_ptr<PeersWithoutCompression> peers_without_compression_;
+  };
+
+  return std::make_shared<CompressedStreamFactory>(
+      std::move(lower_layer_factory), buffer_tracker, metric_entity);
+}
+
+} // namespace rpc
+} // namespace yb
+
+namespace {
+
+bool ValidateRpcCompressionAlgorithm(const char* flagname, const std::string& value) {
+  auto type = yb::rpc::ParseCompressionAlgorithm(value);
+  if (!type.ok()) {
+    LOG(ERROR) << "Invalid value for --" << flagname << ": " << type.status();
+    return false;
+  }
+  return true;
+}
+
+} // namespace
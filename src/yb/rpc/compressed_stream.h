@@ -0,0 +1,42 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_COMPRESSED_STREAM_H
+#define YB_RPC_COMPRESSED_STREAM_H
+
+#include "yb/rpc/stream.h"
+
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace rpc {
+
+// Creates factory of streams that compress data sent over streams created by lower_layer_factory.
+//
+// Compression is negotiated per connection. The connecting side offers the algorithm specified by
+// --rpc_compression_algorithm in a short header sent before any other data, and queues other data
+// until the accepting side replies with the accepted algorithm, or with none if it does not
+// support the offered one. Then both sides exchange framed data, where each frame is either
+// compressed with the accepted algorithm or sent as is. When none is accepted or the connecting
+// side does not send the header, the stream is a pass-through, so servers accept connections from
+// clients that do not compress regardless of their own settings. A server that does not support
+// compression closes the connection on the header, after that connections to it are not
+// compressed for a while.
+StreamFactoryPtr CompressedStreamFactory(
+    StreamFactoryPtr lower_layer_factory, const MemTrackerPtr& buffer_tracker,
+    const scoped_refptr<MetricEntity>& metric_entity);
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_COMPRESSED_STREAM_H
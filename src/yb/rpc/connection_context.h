@@ -78,6 +78,9 @@ class ConnectionContext {
   virtual void UpdateLastRead(const ConnectionPtr& connection);
 
   virtual void UpdateLastWrite(const ConnectionPtr& connection) {}
+
+  // Whether the stream of this connection could negotiate compression of transferred data.
+  virtual bool SupportsCompression() const { return false; }
 };
 
 class ConnectionContextBase : public ConnectionContext {
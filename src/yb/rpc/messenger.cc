@@ -52,7 +52,9 @@
 #include "yb/gutil/strings/substitute.h"
 
 #include "yb/rpc/acceptor.h"
+#include "yb/rpc/compressed_stream.h"
 #include "yb/rpc/connection.h"
+#include "yb/rpc/connection_context.h"
 #include "yb/rpc/constants.h"
 #include "yb/rpc/proxy.h"
 #include "yb/rpc/rpc_header.pb.h"
@@ -65,6 +67,7 @@
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/dns_resolver.h"
@@ -551,10 +554,36 @@ void Messenger::RegisterInboundSocket(
       new_socket, remote, factory->Create(*receive_buffer_size), factory->buffer_tracker());
 }
 
+namespace {
+
+// Wraps streams of the listen protocol, so that compression could be negotiated on connections.
+// Used only for connections of the YB RPC protocol, see Messenger::StreamFactoriesFor.
+StreamFactories WrapListenStreamFactory(
+    StreamFactories factories, const Protocol* listen_protocol,
+    const std::shared_ptr<MemTracker>& parent_mem_tracker,
+    const scoped_refptr<MetricEntity>& metric_entity) {
+  auto it = factories.find(listen_protocol);
+  if (it != factories.end()) {
+    auto buffer_tracker = MemTracker::FindOrCreateTracker(
+        -1, "Compressed Read Buffer", parent_mem_tracker);
+    it->second = CompressedStreamFactory(std::move(it->second), buffer_tracker, metric_entity);
+  }
+  return factories;
+}
+
+} // namespace
+
+const StreamFactories& Messenger::StreamFactoriesFor(const ConnectionContext& context) const {
+  return context.SupportsCompression() ? compressed_stream_factories_ : stream_factories_;
+}
+
 Messenger::Messenger(const MessengerBuilder &bld)
     : name_(bld.name_),
       connection_context_factory_(bld.connection_context_factory_),
       stream_factories_(bld.stream_factories_),
+      compressed_stream_factories_(WrapListenStreamFactory(
+          bld.stream_factories_, bld.listen_protocol_, bld.last_used_parent_mem_tracker_,
+          bld.metric_entity_)),
       listen_protocol_(bld.listen_protocol_),
       metric_entity_(bld.metric_entity_),
       io_thread_pool_(name_, FLAGS_io_thread_pool_size),
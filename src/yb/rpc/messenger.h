@@ -322,12 +322,18 @@ class Messenger : public ProxyContext {
 
   bool TEST_ShouldArtificiallyRejectOutgoingCallsTo(const IpAddress &remote);
 
+  // Returns stream factories for connection with specified context.
+  const StreamFactories& StreamFactoriesFor(const ConnectionContext& context) const;
+
   const std::string name_;
 
   ConnectionContextFactoryPtr connection_context_factory_;
 
   const StreamFactories stream_factories_;
 
+  // Same as stream_factories_, but streams of the listen protocol negotiate compression.
+  const StreamFactories compressed_stream_factories_;
+
   const Protocol* const listen_protocol_;
 
   // Protects closing_, acceptor_pools_, rpc_services_.
@@ -568,7 +568,7 @@ Status Reactor::FindOrStartConnection(const ConnectionId &conn_id,
 
   auto context = messenger_->connection_context_factory_->Create(receive_buffer_size);
   auto stream = VERIFY_RESULT(CreateStream(
-      messenger_->stream_factories_, conn_id.protocol(),
+      messenger_->StreamFactoriesFor(*context), conn_id.protocol(),
       {conn_id.remote(), hostname, &sock,
        messenger_->connection_context_factory_->buffer_tracker()}));
 
@@ -866,7 +866,7 @@ void Reactor::RegisterInboundSocket(
   VLOG_WITH_PREFIX(3) << "New inbound connection to " << remote;
 
   auto stream = CreateStream(
-      messenger_->stream_factories_, messenger_->listen_protocol_,
+      messenger_->StreamFactoriesFor(*connection_context), messenger_->listen_protocol_,
       {remote, std::string(), socket, mem_tracker});
   if (!stream.ok()) {
     LOG_WITH_PREFIX(DFATAL) << "Failed to create stream for " << remote << ": " << stream.status();
@@ -64,6 +64,8 @@
 
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_counter(rpc_compression_input_bytes);
+METRIC_DECLARE_counter(rpc_compression_output_bytes);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -76,6 +78,8 @@ DECLARE_int32(rpc_throttle_threshold_bytes);
 DECLARE_bool(TEST_pause_calculator_echo_request);
 DECLARE_bool(binary_call_parser_reject_on_mem_tracker_hard_limit);
 DECLARE_string(vmodule);
+DECLARE_string(rpc_compression_algorithm);
+DECLARE_bool(TEST_rpc_reject_compression_header);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -102,6 +106,8 @@ class TestRpc : public RpcTestBase {
     ASSERT_EQ(metrics.num_client_connections_, num_connections)
         << "Client should have " << num_connections << " client connection(s)";
   }
+
+  void DoTestCompression(const std::string& algorithm);
 };
 
 namespace {
@@ -433,6 +439,106 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes);
 }
 
+// Test that calls and sidecars are transferred over a compressed connection.
+void TestRpc::DoTestCompression(const std::string& algorithm) {
+  FLAGS_rpc_compression_algorithm = algorithm;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  // Random sidecars do not compress, so they are sent in uncompressed frames.
+  DoTestSidecar(&p, {123, 456});
+  DoTestSidecar(&p, {3_MB, 2_MB, 240_MB});
+
+  auto input_bytes = METRIC_rpc_compression_input_bytes.Instantiate(
+      client_messenger->metric_entity());
+  auto output_bytes = METRIC_rpc_compression_output_bytes.Instantiate(
+      client_messenger->metric_entity());
+  auto input_bytes_before = input_bytes->value();
+  auto output_bytes_before = output_bytes->value();
+
+  // Data that spans several compression chunks.
+  for (auto size : {100_KB, 1_MB + 123}) {
+    rpc_test::EchoRequestPB req;
+    req.set_data(std::string(size, 'X'));
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+  }
+
+  auto input_delta = input_bytes->value() - input_bytes_before;
+  auto output_delta = output_bytes->value() - output_bytes_before;
+  LOG(INFO) << "Compressed " << input_delta << " bytes to " << output_delta;
+  ASSERT_GE(input_delta, 1_MB);
+  ASSERT_LT(output_delta * 10, input_delta);
+
+  // Client that does not compress should still be able to talk to the same server.
+  FLAGS_rpc_compression_algorithm = "none";
+  auto plain_messenger = CreateAutoShutdownMessengerHolder("PlainClient");
+  Proxy plain_proxy(plain_messenger.get(), server_addr);
+  DoTestSidecar(&plain_proxy, {123, 456});
+}
+
+TEST_F(TestRpc, TestSnappyCompression) {
+  DoTestCompression("snappy");
+}
+
+TEST_F(TestRpc, TestLZ4Compression) {
+  DoTestCompression("lz4");
+}
+
+// Test that client falls back to uncompressed connections to a server that does not support
+// compression.
+TEST_F(TestRpc, TestCompressionFallback) {
+  FLAGS_rpc_compression_algorithm = "lz4";
+  FLAGS_TEST_rpc_reject_compression_header = true;
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  rpc_test::EchoRequestPB req;
+  req.set_data(std::string(100_KB, 'X'));
+  rpc_test::EchoResponsePB resp;
+  {
+    // Server closes connection on the compression header, so the first call fails.
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_NOK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+  }
+
+  auto input_bytes = METRIC_rpc_compression_input_bytes.Instantiate(
+      client_messenger->metric_entity());
+  auto input_bytes_before = input_bytes->value();
+  {
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+  }
+  ASSERT_EQ(input_bytes->value(), input_bytes_before);
+}
+
+// Test that calls queued on a compressed connection could be cancelled on timeout.
+TEST_F(TestRpc, TestCompressionCallTimeout) {
+  FLAGS_rpc_compression_algorithm = "lz4";
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  for (uint64_t delay_ns = 1; delay_ns < 100ul * 1000 * 1000; delay_ns *= 2) {
+    ASSERT_NO_FATALS(DoTestExpectTimeout(&p, MonoDelta::FromNanoseconds(delay_ns)));
+  }
+  // Connection should still be usable after cancelled calls.
+  DoTestSidecar(&p, {123, 456});
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
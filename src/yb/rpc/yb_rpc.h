@@ -39,6 +39,8 @@ class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCal
 
   void Shutdown(const Status& status) override;
 
+  bool SupportsCompression() const override { return true; }
+
  protected:
   BinaryCallParser& parser() { return parser_; }
 
@@ -0,0 +1,78 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_key_tracker.h"
+
+#include "yb/util/format.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(tablet_hot_key_sampling_rate);
+
+namespace yb {
+namespace tablet {
+
+class HotKeyTrackerTest : public YBTest {
+};
+
+TEST_F(HotKeyTrackerTest, FindsHotKeys) {
+  constexpr size_t kCapacity = 16;
+  // Less than the number of samples after which counts are halved.
+  constexpr uint64_t kNumAccesses = 60000;
+  constexpr int kNumColdKeys = 10000;
+
+  HotKeyTracker tracker(kCapacity, nullptr /* metric_entity */);
+  std::mt19937_64 rng(42);
+  for (uint64_t i = 0; i != kNumAccesses; ++i) {
+    // Every 4th access reads "hot", every 10th writes "warm", the rest hit random cold keys.
+    if (i % 4 == 0) {
+      tracker.Record("hot", KeyAccessType::kRead);
+    } else if (i % 10 == 1) {
+      tracker.Record("warm", KeyAccessType::kWrite);
+    } else {
+      tracker.Record(Format("cold$0", RandomUniformInt(0, kNumColdKeys - 1, &rng)),
+                     KeyAccessType::kRead);
+    }
+  }
+
+  auto top_keys = tracker.TopKeys();
+  ASSERT_EQ(kCapacity, top_keys.size());
+  LOG(INFO) << "Top keys: " << yb::ToString(top_keys);
+
+  ASSERT_EQ("hot", top_keys[0].key);
+  ASSERT_EQ(top_keys[0].count, top_keys[0].reads + top_keys[0].error);
+  ASSERT_EQ(0U, top_keys[0].writes);
+  ASSERT_GE(top_keys[0].count - top_keys[0].error, kNumAccesses / 4 / 2);
+
+  ASSERT_EQ("warm", top_keys[1].key);
+  ASSERT_EQ(top_keys[1].count, top_keys[1].writes + top_keys[1].error);
+  ASSERT_GT(top_keys[1].count, top_keys[2].count);
+}
+
+TEST_F(HotKeyTrackerTest, Sampling) {
+  FLAGS_tablet_hot_key_sampling_rate = 0;
+  for (int i = 0; i != 1000; ++i) {
+    ASSERT_FALSE(HotKeyTracker::ShouldSample());
+  }
+
+  constexpr int kRate = 10;
+  FLAGS_tablet_hot_key_sampling_rate = kRate;
+  int sampled = 0;
+  for (int i = 0; i != kRate * 100; ++i) {
+    sampled += HotKeyTracker::ShouldSample();
+  }
+  ASSERT_EQ(100, sampled);
+}
+
+} // namespace tablet
+} // namespace yb
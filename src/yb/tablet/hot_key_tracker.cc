@@ -0,0 +1,157 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_key_tracker.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+
+DEFINE_int32(tablet_hot_key_sampling_rate, 128,
+             "Record one of this number of key accesses to find the hottest keys of each tablet. "
+             "0 disables hot key tracking.");
+TAG_FLAG(tablet_hot_key_sampling_rate, advanced);
+TAG_FLAG(tablet_hot_key_sampling_rate, runtime);
+
+METRIC_DEFINE_counter(tablet, hot_key_sampled_accesses, "Hot Key Sampled Accesses",
+                      yb::MetricUnit::kOperations,
+                      "Number of key accesses recorded by the hot key tracker of this tablet.");
+
+METRIC_DEFINE_gauge_uint64(tablet, hot_key_top_share_percent, "Hot Key Top Share",
+                           yb::MetricUnit::kUnits,
+                           "Percentage of recently sampled accesses to this tablet that hit its "
+                           "hottest key.");
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Counts are halved after this number of samples.
+constexpr uint64_t kDecayPeriod = 1ULL << 16;
+
+} // namespace
+
+std::string HotKeyInfo::ToString() const {
+  return Format("{ key: $0 count: $1 error: $2 reads: $3 writes: $4 }",
+                Slice(key).ToDebugHexString(), count, error, reads, writes);
+}
+
+HotKeyTracker::HotKeyTracker(size_t capacity, const scoped_refptr<MetricEntity>& metric_entity)
+    : capacity_(capacity) {
+  entries_.reserve(capacity);
+  if (metric_entity) {
+    sampled_accesses_ = METRIC_hot_key_sampled_accesses.Instantiate(metric_entity);
+    top_key_share_ = METRIC_hot_key_top_share_percent.Instantiate(metric_entity, 0);
+  }
+}
+
+bool HotKeyTracker::ShouldSample() {
+  const auto rate = FLAGS_tablet_hot_key_sampling_rate;
+  if (rate <= 0) {
+    return false;
+  }
+  static thread_local uint32_t counter = 0;
+  if (++counter < static_cast<uint32_t>(rate)) {
+    return false;
+  }
+  counter = 0;
+  return true;
+}
+
+void HotKeyTracker::Record(const Slice& key, KeyAccessType type) {
+  IncrementCounter(sampled_accesses_);
+
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  auto insert_result = index_.emplace(key.ToBuffer(), entries_.size());
+  HotKeyInfo* entry;
+  if (!insert_result.second) {
+    entry = &entries_[insert_result.first->second];
+  } else if (entries_.size() < capacity_) {
+    entries_.emplace_back();
+    entry = &entries_.back();
+    entry->key = insert_result.first->first;
+  } else {
+    // Replace the key with the lowest count. The new key could have been accessed up to that
+    // number of times while it was not tracked.
+    auto min_it = std::min_element(
+        entries_.begin(), entries_.end(),
+        [](const HotKeyInfo& lhs, const HotKeyInfo& rhs) { return lhs.count < rhs.count; });
+    index_.erase(min_it->key);
+    insert_result.first->second = min_it - entries_.begin();
+    entry = &*min_it;
+    entry->key = insert_result.first->first;
+    entry->error = entry->count;
+    entry->reads = 0;
+    entry->writes = 0;
+  }
+
+  ++entry->count;
+  switch (type) {
+    case KeyAccessType::kRead:
+      ++entry->reads;
+      break;
+    case KeyAccessType::kWrite:
+      ++entry->writes;
+      break;
+  }
+
+  if (++num_samples_ >= kDecayPeriod) {
+    Decay();
+  }
+
+  if (top_key_share_) {
+    auto top_count = entry->count;
+    if (top_count * 100 / num_samples_ < top_key_share_->value()) {
+      // The hottest key might be another one.
+      for (const auto& e : entries_) {
+        top_count = std::max(top_count, e.count);
+      }
+    }
+    top_key_share_->set_value(std::min<uint64_t>(top_count * 100 / num_samples_, 100));
+  }
+}
+
+void HotKeyTracker::Decay() {
+  num_samples_ = 0;
+  for (auto& entry : entries_) {
+    entry.count /= 2;
+    entry.error /= 2;
+    entry.reads /= 2;
+    entry.writes /= 2;
+    num_samples_ += entry.count;
+  }
+  num_samples_ = std::max<uint64_t>(num_samples_, 1);
+}
+
+std::vector<HotKeyInfo> HotKeyTracker::TopKeys() const {
+  std::vector<HotKeyInfo> result;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    result = entries_;
+  }
+  std::sort(result.begin(), result.end(), [](const HotKeyInfo& lhs, const HotKeyInfo& rhs) {
+    return lhs.count > rhs.count;
+  });
+  return result;
+}
+
+uint64_t HotKeyTracker::num_samples() const {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return num_samples_;
+}
+
+} // namespace tablet
+} // namespace yb
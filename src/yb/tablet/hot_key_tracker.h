@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEY_TRACKER_H
+#define YB_TABLET_HOT_KEY_TRACKER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/enums.h"
+#include "yb/util/locks.h"
+#include "yb/util/metrics.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+YB_DEFINE_ENUM(KeyAccessType, (kRead)(kWrite));
+
+struct HotKeyInfo {
+  // Encoded doc key.
+  std::string key;
+  // Estimated number of sampled accesses, could overestimate the real number by up to error.
+  uint64_t count = 0;
+  uint64_t error = 0;
+  uint64_t reads = 0;
+  uint64_t writes = 0;
+
+  std::string ToString() const;
+};
+
+// Tracks the most frequently accessed keys of a tablet.
+//
+// Only a sample of accesses is recorded, one per --tablet_hot_key_sampling_rate accesses. Sampled
+// keys are counted with the space saving algorithm: a fixed number of counters is kept, and a key
+// that is not tracked yet replaces the key with the lowest count, inheriting its count as the
+// error bound. So any key accessed more often than once per capacity samples is reported.
+// Counts are halved periodically, so keys that are no longer hot fade out.
+class HotKeyTracker {
+ public:
+  // Metrics are not reported when metric_entity is null.
+  HotKeyTracker(size_t capacity, const scoped_refptr<MetricEntity>& metric_entity);
+
+  HotKeyTracker(const HotKeyTracker&) = delete;
+  void operator=(const HotKeyTracker&) = delete;
+
+  // Whether the current access should be recorded. Cheap enough to be called for every access.
+  static bool ShouldSample();
+
+  void Record(const Slice& key, KeyAccessType type);
+
+  // Returns tracked keys, hottest first.
+  std::vector<HotKeyInfo> TopKeys() const;
+
+  // Number of samples counted since the last time counts were halved.
+  uint64_t num_samples() const;
+
+ private:
+  void Decay() REQUIRES(mutex_);
+
+  const size_t capacity_;
+
+  mutable simple_spinlock mutex_;
+  std::vector<HotKeyInfo> entries_ GUARDED_BY(mutex_);
+  std::unordered_map<std::string, size_t> index_ GUARDED_BY(mutex_);
+  uint64_t num_samples_ GUARDED_BY(mutex_) = 0;
+
+  scoped_refptr<Counter> sampled_accesses_;
+  scoped_refptr<AtomicGauge<uint64_t>> top_key_share_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEY_TRACKER_H
@@ -92,6 +92,7 @@
 #include "yb/docdb/lock_batch.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/primitive_value_util.h"
 #include "yb/docdb/redis_operation.h"
 
 #include "yb/gutil/atomicops.h"
@@ -269,6 +270,9 @@ using docdb::StorageDbType;
 
 namespace {
 
+// Number of keys tracked by the hot key tracker of each tablet.
+constexpr size_t kHotKeyTrackerCapacity = 32;
+
 void EmitRocksDbMetricsAsJson(
     std::shared_ptr<rocksdb::Statistics> rocksdb_statistics,
     JsonWriter* writer,
@@ -395,6 +399,7 @@ Tablet::Tablet(const TabletInitData& data)
           Format("tablet-$0", tablet_id()), data.parent_mem_tracker, AddToParent::kTrue,
           CreateMetrics::kFalse)),
       block_based_table_mem_tracker_(data.block_based_table_mem_tracker),
+      pinned_index_and_filter_mem_tracker_(data.pinned_index_and_filter_mem_tracker),
       clock_(data.clock),
       mvcc_(
           MakeTabletLogPrefix(data.metadata->raft_group_id(), data.log_prefix_suffix), data.clock),
@@ -446,10 +451,14 @@ Tablet::Tablet(const TabletInitData& data)
     });
 
     metrics_.reset(new TabletMetrics(metric_entity_));
+    shared_lock_manager_.SetMetrics(docdb::SharedLockManagerMetrics{
+        metrics_->key_lock_contentions, metrics_->key_lock_timeouts});
 
     mem_tracker_->SetMetricEntity(metric_entity_);
   }
 
+  hot_key_tracker_ = std::make_unique<HotKeyTracker>(kHotKeyTrackerCapacity, metric_entity_);
+
   auto table_info = metadata_->primary_table_info();
   bool has_index = !table_info->index_map.empty();
   if (txns_enabled_ &&
@@ -657,6 +666,16 @@ Status Tablet::OpenKeyValueTablet() {
     rocksdb_options.block_based_table_mem_tracker->SetMetricEntity(metric_entity_,
         Format("$0_$1", "BlockBasedTable", kRegularDB));
   }
+  if (pinned_index_and_filter_mem_tracker_) {
+    rocksdb_options.pinned_index_and_filter_mem_tracker =
+        MemTracker::FindOrCreateTracker(
+            Format("$0-$1", kRegularDB, tablet_id()), pinned_index_and_filter_mem_tracker_,
+            AddToParent::kTrue, CreateMetrics::kFalse);
+    if (metric_entity_) {
+      rocksdb_options.pinned_index_and_filter_mem_tracker->SetMetricEntity(metric_entity_,
+          Format("$0_$1", "PinnedIndexAndFilter", kRegularDB));
+    }
+  }
 
   key_bounds_ = docdb::KeyBounds(metadata()->lower_bound_key(), metadata()->upper_bound_key());
 
@@ -719,6 +738,16 @@ Status Tablet::OpenKeyValueTablet() {
       rocksdb_options.block_based_table_mem_tracker->SetMetricEntity(metric_entity_,
         Format("$0_$1", "BlockBasedTable", kIntentsDB));
     }
+    if (pinned_index_and_filter_mem_tracker_) {
+      rocksdb_options.pinned_index_and_filter_mem_tracker =
+          MemTracker::FindOrCreateTracker(
+              Format("$0-$1", kIntentsDB, tablet_id()), pinned_index_and_filter_mem_tracker_,
+              AddToParent::kTrue, CreateMetrics::kFalse);
+      if (metric_entity_) {
+        rocksdb_options.pinned_index_and_filter_mem_tracker->SetMetricEntity(metric_entity_,
+            Format("$0_$1", "PinnedIndexAndFilter", kIntentsDB));
+      }
+    }
 
     rocksdb::DB* intents_db = nullptr;
     RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options, db_dir + kIntentsDBSuffix, &intents_db));
@@ -1267,6 +1296,10 @@ Status Tablet::HandleQLReadRequest(
     return Status::OK();
   }
 
+  if (!ql_read_request.hashed_column_values().empty() && HotKeyTracker::ShouldSample()) {
+    SampleQLReadKey(ql_read_request);
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata, /* is_ysql_catalog_table */ false);
   RETURN_NOT_OK(txn_op_ctx);
@@ -1378,6 +1411,8 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
     return;
   }
 
+  SampleWriteKeys(doc_ops);
+
   StartDocWriteOperation(std::move(operation), std::move(scoped_read_operation),
                          [this](auto operation, const Status& status) {
     if (operation->restart_read_ht().is_valid()) {
@@ -1581,6 +1616,8 @@ Status Tablet::HandlePgsqlReadRequest(
     return Status::OK();
   }
 
+  SamplePgsqlReadKeys(pgsql_read_request, table_info->schema);
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(
           transaction_metadata,
@@ -1590,6 +1627,75 @@ Status Tablet::HandlePgsqlReadRequest(
       deadline, read_time, pgsql_read_request, *txn_op_ctx, result);
 }
 
+//--------------------------------------------------------------------------------------------------
+// Hot key tracking.
+
+void Tablet::RecordKeyAccess(Slice encoded_doc_key, KeyAccessType type) {
+  auto size = docdb::DocKey::EncodedSize(
+      encoded_doc_key, docdb::DocKeyPart::kUpToHashOrFirstRange);
+  if (size.ok()) {
+    encoded_doc_key = encoded_doc_key.Prefix(*size);
+  }
+  hot_key_tracker_->Record(encoded_doc_key, type);
+}
+
+void Tablet::SampleWriteKeys(const docdb::DocOperations& doc_ops) {
+  for (const auto& doc_op : doc_ops) {
+    if (!HotKeyTracker::ShouldSample()) {
+      continue;
+    }
+    docdb::DocPathsToLock paths;
+    IsolationLevel level;
+    if (doc_op->GetDocPaths(docdb::GetDocPathsMode::kLock, &paths, &level).ok() &&
+        !paths.empty()) {
+      RecordKeyAccess(paths.back().as_slice(), KeyAccessType::kWrite);
+    }
+  }
+}
+
+void Tablet::SampleQLReadKey(const QLReadRequestPB& ql_read_request) {
+  const auto schema = this->schema();
+  std::vector<docdb::PrimitiveValue> hashed_components;
+  if (!docdb::QLKeyColumnValuesToPrimitiveValues(
+          ql_read_request.hashed_column_values(), *schema, 0, schema->num_hash_key_columns(),
+          &hashed_components).ok()) {
+    return;
+  }
+  docdb::DocKey doc_key(*schema, ql_read_request.hash_code(), std::move(hashed_components));
+  RecordKeyAccess(doc_key.Encode().AsSlice(), KeyAccessType::kRead);
+}
+
+void Tablet::SamplePgsqlReadKeys(
+    const PgsqlReadRequestPB& pgsql_read_request, const Schema& schema) {
+  // Reads by ybctids from an index are batched, each ybctid is a separate key access.
+  for (const auto& batch_arg : pgsql_read_request.batch_arguments()) {
+    if (batch_arg.has_ybctid() && HotKeyTracker::ShouldSample()) {
+      RecordKeyAccess(batch_arg.ybctid().value().binary_value(), KeyAccessType::kRead);
+    }
+  }
+  if (pgsql_read_request.batch_arguments_size() > 0 || !HotKeyTracker::ShouldSample()) {
+    return;
+  }
+
+  const auto& ybctid = pgsql_read_request.ybctid_column_value().value().binary_value();
+  if (!ybctid.empty()) {
+    RecordKeyAccess(ybctid, KeyAccessType::kRead);
+    return;
+  }
+
+  // Scans without partition column values do not access any particular key.
+  if (pgsql_read_request.partition_column_values().empty()) {
+    return;
+  }
+  std::vector<docdb::PrimitiveValue> hashed_components;
+  if (!docdb::InitKeyColumnPrimitiveValues(
+          pgsql_read_request.partition_column_values(), schema, 0, &hashed_components).ok()) {
+    return;
+  }
+  docdb::DocKey doc_key(schema, pgsql_read_request.hash_code(), std::move(hashed_components));
+  RecordKeyAccess(doc_key.Encode().AsSlice(), KeyAccessType::kRead);
+}
+
 // Returns true if the query can be satisfied by rows present in current tablet.
 // Returns false if query requires other tablets to also be scanned. Examples of this include:
 //   (1) full table scan queries
@@ -1744,6 +1850,8 @@ void Tablet::KeyValueBatchFromPgsqlWriteBatch(std::unique_ptr<WriteOperation> op
     return;
   }
 
+  SampleWriteKeys(operation->doc_ops());
+
   StartDocWriteOperation(std::move(operation), std::move(scoped_read_operation),
                          [](auto operation, const Status& status) {
     if (!status.ok() || operation->restart_read_ht().is_valid()) {
@@ -3170,6 +3278,7 @@ void Tablet::ListenNumSSTFilesChanged(std::function<void()> listener) {
 
 void Tablet::InitRocksDBOptions(rocksdb::Options* options, const std::string& log_prefix) {
   docdb::InitRocksDBOptions(options, log_prefix, rocksdb_statistics_, tablet_options_);
+  docdb::SetDataDirRateLimiter(options, metadata_->data_root_dir());
 }
 
 rocksdb::Env& Tablet::rocksdb_env() const {
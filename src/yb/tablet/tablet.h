@@ -66,6 +66,7 @@
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tablet/abstract_tablet.h"
+#include "yb/tablet/hot_key_tracker.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
 #include "yb/tablet/tablet_metadata.h"
@@ -505,6 +506,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return transaction_participant_.get();
   }
 
+  // Tracker of the most frequently accessed keys of this tablet.
+  const HotKeyTracker& hot_key_tracker() const {
+    return *hot_key_tracker_;
+  }
+
   void ForceRocksDBCompactInTest();
 
   docdb::DocDB doc_db() const { return { regular_db_.get(), intents_db_.get(), &key_bounds_ }; }
@@ -721,6 +727,7 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
   std::shared_ptr<MemTracker> mem_tracker_;
   std::shared_ptr<MemTracker> block_based_table_mem_tracker_;
+  std::shared_ptr<MemTracker> pinned_index_and_filter_mem_tracker_;
 
   MetricEntityPtr metric_entity_;
   gscoped_ptr<TabletMetrics> metrics_;
@@ -792,6 +799,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<TransactionParticipant> transaction_participant_;
 
+  std::unique_ptr<HotKeyTracker> hot_key_tracker_;
+
   std::shared_future<client::YBClient*> client_future_;
 
   // Created only when secondary indexes are present.
@@ -821,6 +830,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status);
 
+  // Records an access to the key in hot key tracker. Encoded doc key could be followed by subkeys,
+  // only hashed components, or the first range component for range partitioned tables, are kept.
+  void RecordKeyAccess(Slice encoded_doc_key, KeyAccessType type);
+  void SampleWriteKeys(const docdb::DocOperations& doc_ops);
+  void SampleQLReadKey(const QLReadRequestPB& ql_read_request);
+  void SamplePgsqlReadKeys(const PgsqlReadRequestPB& pgsql_read_request, const Schema& schema);
+
   Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
 
   template <class Ids>
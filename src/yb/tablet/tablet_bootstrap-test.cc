@@ -54,6 +54,7 @@
 
 DECLARE_bool(skip_flushed_entries);
 DECLARE_int32(retryable_request_timeout_secs);
+DECLARE_int32(tablet_bootstrap_log_read_ahead_segments);
 
 using std::shared_ptr;
 using std::string;
@@ -510,6 +511,42 @@ TEST_F(BootstrapTest, TestBootstrapHighOpIdIndex) {
   ASSERT_OPID_EQ(last_opid, boot_info.last_committed_id);
 }
 
+// Compares the time to replay a log of many segments with and without reading segments ahead of
+// the one being replayed.
+TEST_F(BootstrapTest, LogReadAheadBenchmark) {
+  const int kNumSegments = NonTsanVsTsan(20, 5);
+  const int kEntriesPerSegment = NonTsanVsTsan(500, 100);
+  const int kNumEntries = kNumSegments * kEntriesPerSegment;
+
+  for (int read_ahead_segments : {0, 1, 4}) {
+    FLAGS_tablet_bootstrap_log_read_ahead_segments = read_ahead_segments;
+    CleanTablet();
+    test_hooks_->Clear();
+    BuildLog();
+
+    current_index_ = 1;
+    for (int i = 0; i != kNumEntries; ++i) {
+      if (i != 0 && i % kEntriesPerSegment == 0) {
+        ASSERT_OK(RollLog());
+      }
+      const auto op_id = MakeOpId(1, current_index_);
+      AppendReplicateBatch(op_id, op_id, {TupleForAppend(i, i, "value " + std::to_string(i))});
+      ++current_index_;
+    }
+
+    TabletPtr tablet;
+    ConsensusBootstrapInfo boot_info;
+    const auto start = MonoTime::Now();
+    ASSERT_OK(BootstrapTestTablet(&tablet, &boot_info));
+    const auto elapsed = MonoTime::Now() - start;
+
+    LOG(INFO) << "Replayed " << kNumEntries << " entries in " << kNumSegments << " segments with "
+              << read_ahead_segments << " read ahead segments in " << elapsed;
+    ASSERT_EQ(static_cast<size_t>(kNumEntries), test_hooks_->actual_report.replayed.size());
+    ASSERT_EQ(kNumEntries, boot_info.last_committed_id.index());
+  }
+}
+
 struct BootstrapInputEntry {
   const OpId& op_id() const { return batch_data.op_id; }
 
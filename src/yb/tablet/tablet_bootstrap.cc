@@ -31,6 +31,10 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log.h"
@@ -60,6 +64,7 @@
 #include "yb/util/scope_exit.h"
 #include "yb/util/status.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/thread.h"
 #include "yb/util/env_util.h"
 #include "yb/consensus/log_index.h"
 #include "yb/docdb/consensus_frontier.h"
@@ -95,6 +100,12 @@ DECLARE_int32(retryable_request_timeout_secs);
 DEFINE_uint64(transaction_status_tablet_log_segment_size_bytes, 4_MB,
               "The segment size for transaction status tablet log roll-overs, in bytes.");
 
+DEFINE_int32(tablet_bootstrap_log_read_ahead_segments, 1,
+             "Number of log segments to read, decode and verify in a background thread ahead of "
+             "the segment being replayed during tablet bootstrap. 0 means that segments are read "
+             "on the replaying thread.");
+TAG_FLAG(tablet_bootstrap_log_read_ahead_segments, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -397,6 +408,83 @@ ReplayDecision ShouldReplayOperation(
   return {index > regular_flushed_index};
 }
 
+// Reads log segments in a background thread, staying at most max_segments_ahead segments ahead of
+// the segment being replayed. This way reading, decoding and checksum verification of the next
+// segments overlap with applying the entries of the current one. Entries still have to be applied
+// in log order, so the apply itself stays on the replaying thread.
+class LogSegmentReadAhead {
+ public:
+  LogSegmentReadAhead(SegmentSequence::const_iterator begin,
+                      SegmentSequence::const_iterator end,
+                      size_t max_segments_ahead)
+      : next_to_read_(begin), end_(end), max_segments_ahead_(max_segments_ahead) {}
+
+  ~LogSegmentReadAhead() {
+    if (thread_) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+      }
+      cond_.notify_all();
+      thread_->Join();
+    }
+  }
+
+  CHECKED_STATUS Start() {
+    if (max_segments_ahead_ == 0 || next_to_read_ == end_) {
+      return Status::OK();
+    }
+    return Thread::Create(
+        "tablet-bootstrap", "log-read-ahead", &LogSegmentReadAhead::Run, this, &thread_);
+  }
+
+  // Returns the result of reading the next segment. Should be called once per segment.
+  log::ReadEntriesResult Next() {
+    if (!thread_) {
+      return (*next_to_read_++)->ReadEntries();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return !results_.empty(); });
+    auto result = std::move(results_.front());
+    results_.pop_front();
+    lock.unlock();
+    cond_.notify_all();
+    return result;
+  }
+
+ private:
+  void Run() {
+    for (; next_to_read_ != end_; ++next_to_read_) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return stop_ || results_.size() < max_segments_ahead_; });
+        if (stop_) {
+          return;
+        }
+      }
+      auto result = (*next_to_read_)->ReadEntries();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+      }
+      cond_.notify_all();
+    }
+  }
+
+  // Only accessed by the reading thread, after Start().
+  SegmentSequence::const_iterator next_to_read_;
+  const SegmentSequence::const_iterator end_;
+  const size_t max_segments_ahead_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<log::ReadEntriesResult> results_;
+  bool stop_ = false;
+
+  scoped_refptr<Thread> thread_;
+};
+
 }  // anonymous namespace
 
 YB_STRONGLY_TYPED_BOOL(NeedsRecovery);
@@ -1202,13 +1290,17 @@ class TabletBootstrap {
     // Find the earliest log segment we need to read, so the rest can be ignored.
     auto iter = FLAGS_skip_flushed_entries ? SkipFlushedEntries(&segments) : segments.begin();
 
+    LogSegmentReadAhead read_ahead(
+        iter, segments.end(), std::max(FLAGS_tablet_bootstrap_log_read_ahead_segments, 0));
+    RETURN_NOT_OK(read_ahead.Start());
+
     yb::OpId last_committed_op_id;
     yb::OpId last_read_entry_op_id;
     RestartSafeCoarseTimePoint last_entry_time;
     for (; iter != segments.end(); ++iter) {
       const scoped_refptr<ReadableLogSegment>& segment = *iter;
 
-      auto read_result = segment->ReadEntries();
+      auto read_result = read_ahead.Next();
       last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
       if (!read_result.entries.empty()) {
         last_read_entry_op_id = yb::OpId::FromPB(read_result.entries.back()->replicate().id());
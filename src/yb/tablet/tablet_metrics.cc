@@ -134,6 +134,16 @@ METRIC_DEFINE_counter(tablet, restart_read_requests,
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, key_lock_contentions,
+  "Contended Key Locks",
+  yb::MetricUnit::kRequests,
+  "Number of key locks that had to wait for a conflicting holder.");
+
+METRIC_DEFINE_counter(tablet, key_lock_timeouts,
+  "Key Lock Timeouts",
+  yb::MetricUnit::kRequests,
+  "Number of lock batches that could not be acquired before the deadline.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -152,6 +162,8 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
     MINIT(restart_read_requests),
+    MINIT(key_lock_contentions),
+    MINIT(key_lock_timeouts),
     MINIT(rows_inserted) {
 }
 #undef MINIT
@@ -61,6 +61,8 @@ struct TabletInitData {
   scoped_refptr<server::Clock> clock;
   std::shared_ptr<MemTracker> parent_mem_tracker;
   std::shared_ptr<MemTracker> block_based_table_mem_tracker;
+  // Budget for top-level index and filter index blocks pinned in memory, null if pinning is off.
+  std::shared_ptr<MemTracker> pinned_index_and_filter_mem_tracker;
   MetricRegistry* metric_registry = nullptr;
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry;
   TabletOptions tablet_options;
@@ -34,6 +34,10 @@
 
 #include "yb/common/ql_value.h"
 
+#include "yb/consensus/consensus.proxy.h"
+#include "yb/consensus/multi_raft_batcher.h"
+#include "yb/consensus/opid_util.h"
+
 #include "yb/gutil/strings/escaping.h"
 #include "yb/gutil/strings/substitute.h"
 
@@ -54,6 +58,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_admin.proxy.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/crc.h"
 #include "yb/util/curl_util.h"
 #include "yb/util/url-coding.h"
@@ -84,6 +89,9 @@ DECLARE_int32(metrics_retirement_age_ms);
 DECLARE_string(block_manager);
 DECLARE_string(rpc_bind_addresses);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(multi_raft_heartbeat_batch_window_ms);
+DECLARE_int32(multi_raft_batch_size);
+DECLARE_bool(TEST_multi_raft_batch_skip_last_request);
 
 // Declare these metrics prototypes for simpler unit testing of their behavior.
 METRIC_DECLARE_counter(rows_inserted);
@@ -824,6 +832,133 @@ TEST_F(TabletServerTest, TestWriteOutOfBounds) {
 
 namespace {
 
+consensus::ConsensusRequestPB MakeHeartbeat(const std::string& dest_uuid,
+                                            const std::string& tablet_id) {
+  consensus::ConsensusRequestPB req;
+  req.set_dest_uuid(dest_uuid);
+  req.set_tablet_id(tablet_id);
+  req.set_caller_uuid("fake-leader");
+  req.set_caller_term(0);
+  req.mutable_preceding_id()->CopyFrom(consensus::MinimumOpId());
+  req.mutable_committed_op_id()->CopyFrom(consensus::MinimumOpId());
+  return req;
+}
+
+// Collects the results of heartbeats added to a batcher.
+struct HeartbeatResults {
+  explicit HeartbeatResults(size_t count) : responses(count), statuses(count), latch(count) {}
+
+  void Add(consensus::MultiRaftHeartbeatBatcher* batcher,
+           const consensus::ConsensusRequestPB& req, size_t idx) {
+    batcher->AddRequestToBatch(req, &responses[idx], [this, idx](const Status& status) {
+      statuses[idx] = status;
+      latch.CountDown();
+    });
+  }
+
+  std::vector<consensus::ConsensusResponsePB> responses;
+  std::vector<Status> statuses;
+  CountDownLatch latch;
+};
+
+} // namespace
+
+TEST_F(TabletServerTest, TestMultiRaftUpdateConsensus) {
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  consensus::MultiRaftConsensusRequestPB req;
+  consensus::MultiRaftConsensusResponsePB resp;
+  RpcController controller;
+
+  *req.add_consensus_request() = MakeHeartbeat(uuid, kTabletId);
+  *req.add_consensus_request() = MakeHeartbeat("wrong-uuid", kTabletId);
+  *req.add_consensus_request() = MakeHeartbeat(uuid, "unknown-tablet");
+
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &controller));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_EQ(3, resp.consensus_response_size());
+
+  // Errors of one request do not affect the others, and each response stays in its own slot.
+  ASSERT_FALSE(resp.consensus_response(0).has_error());
+  ASSERT_EQ(uuid, resp.consensus_response(0).responder_uuid());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(1).error().code());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(2).error().code());
+
+  // An empty batch gets an empty response.
+  req.Clear();
+  resp.Clear();
+  controller.Reset();
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &controller));
+  ASSERT_EQ(0, resp.consensus_response_size());
+}
+
+TEST_F(TabletServerTest, TestMultiRaftBatcherWindow) {
+  FLAGS_multi_raft_heartbeat_batch_window_ms = 500;
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  auto batcher = std::make_shared<consensus::MultiRaftHeartbeatBatcher>(
+      client_messenger_.get(), std::make_unique<consensus::ConsensusServiceProxy>(
+          proxy_cache_.get(), HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr())));
+
+  HeartbeatResults results(2);
+  auto start = MonoTime::Now();
+  results.Add(batcher.get(), MakeHeartbeat(uuid, kTabletId), 0);
+  results.Add(batcher.get(), MakeHeartbeat(uuid, "unknown-tablet"), 1);
+  // Nothing is sent before the window expires.
+  ASSERT_FALSE(results.latch.WaitFor(MonoDelta::FromMilliseconds(250)));
+  ASSERT_TRUE(results.latch.WaitFor(MonoDelta::FromSeconds(10)));
+  ASSERT_GE(MonoTime::Now() - start, MonoDelta::FromMilliseconds(500));
+
+  ASSERT_OK(results.statuses[0]);
+  ASSERT_OK(results.statuses[1]);
+  ASSERT_EQ(uuid, results.responses[0].responder_uuid());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, results.responses[1].error().code());
+}
+
+TEST_F(TabletServerTest, TestMultiRaftBatcherFullBatch) {
+  FLAGS_multi_raft_heartbeat_batch_window_ms = 60000;
+  FLAGS_multi_raft_batch_size = 2;
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  auto batcher = std::make_shared<consensus::MultiRaftHeartbeatBatcher>(
+      client_messenger_.get(), std::make_unique<consensus::ConsensusServiceProxy>(
+          proxy_cache_.get(), HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr())));
+
+  HeartbeatResults results(3);
+  for (size_t i = 0; i != 3; ++i) {
+    results.Add(batcher.get(), MakeHeartbeat(uuid, kTabletId), i);
+  }
+  // The first two heartbeats fill the batch and are sent without waiting for the window.
+  ASSERT_OK(WaitFor([&results] { return results.latch.count() == 1; },
+                    MonoDelta::FromSeconds(10), "Full batch sent"));
+  ASSERT_OK(results.statuses[0]);
+  ASSERT_OK(results.statuses[1]);
+
+  // Destroying the batcher aborts the heartbeat that is still waiting for its batch.
+  batcher.reset();
+  ASSERT_TRUE(results.latch.WaitFor(MonoDelta::FromSeconds(10)));
+  ASSERT_TRUE(results.statuses[2].IsAborted()) << results.statuses[2];
+}
+
+TEST_F(TabletServerTest, TestMultiRaftBatcherResponseMismatch) {
+  FLAGS_multi_raft_heartbeat_batch_window_ms = 10;
+  FLAGS_TEST_multi_raft_batch_skip_last_request = true;
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  auto batcher = std::make_shared<consensus::MultiRaftHeartbeatBatcher>(
+      client_messenger_.get(), std::make_unique<consensus::ConsensusServiceProxy>(
+          proxy_cache_.get(), HostPort::FromBoundEndpoint(mini_server_->bound_rpc_addr())));
+
+  HeartbeatResults results(2);
+  results.Add(batcher.get(), MakeHeartbeat(uuid, kTabletId), 0);
+  results.Add(batcher.get(), MakeHeartbeat(uuid, kTabletId), 1);
+  ASSERT_TRUE(results.latch.WaitFor(MonoDelta::FromSeconds(10)));
+
+  // No response can be matched to its request, so all of them fail.
+  for (const auto& status : results.statuses) {
+    ASSERT_TRUE(status.IsIllegalState()) << status;
+  }
+  ASSERT_FALSE(results.responses[0].has_responder_uuid());
+}
+
+namespace {
+
 void CalcTestRowChecksum(uint64_t *out, int32_t key, uint8_t string_field_defined = true) {
   QLValue value;
 
@@ -90,6 +90,7 @@
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/string_util.h"
 #include "yb/consensus/consensus.pb.h"
@@ -224,6 +225,17 @@ DEFINE_test_flag(int32, txn_status_table_tablet_creation_delay_ms, 0,
 DEFINE_test_flag(int32, leader_stepdown_delay_ms, 0,
                  "Amount of time to delay before starting a leader stepdown change.");
 
+DEFINE_int32(multi_raft_update_max_threads, 16,
+             "Maximum number of threads applying the requests of MultiRaftUpdateConsensus "
+             "batches.");
+TAG_FLAG(multi_raft_update_max_threads, advanced);
+
+DEFINE_int32(multi_raft_update_entry_timeout_ms, 500,
+             "Time limit for applying a single request of a MultiRaftUpdateConsensus batch. A "
+             "tablet that does not get its update lock in time fails its own request without "
+             "delaying the rest of the batch.");
+TAG_FLAG(multi_raft_update_entry_timeout_ms, advanced);
+
 namespace yb {
 namespace tserver {
 
@@ -1470,6 +1482,24 @@ bool TabletServiceImpl::GetTabletOrRespond(
   return DoGetTabletOrRespond(req, resp, context, tablet, tablet_peer);
 }
 
+namespace {
+
+// Returns the read time of a YSQL read that a follower should serve without waiting for its safe
+// time. Such reads are retried on the leader when the follower is behind.
+template <class Req>
+ReadHybridTime FollowerReadTime(const Req& req) {
+  return ReadHybridTime();
+}
+
+ReadHybridTime FollowerReadTime(const ReadRequestPB& req) {
+  if (req.pgsql_batch_size() == 0) {
+    return ReadHybridTime();
+  }
+  return ReadHybridTime::FromReadTimePB(req);
+}
+
+} // namespace
+
 template <class Req, class Resp>
 bool TabletServiceImpl::DoGetTabletOrRespond(
     const Req* req, Resp* resp, rpc::RpcContext* context,
@@ -1517,6 +1547,15 @@ bool TabletServiceImpl::DoGetTabletOrRespond(
     // Peer is not the leader, so check that the time since it last heard from the leader is less
     // than FLAGS_max_stale_read_bound_time_ms.
     if (PREDICT_FALSE(!s.ok())) {
+      auto read_time = FollowerReadTime(*req);
+      if (read_time && !tablet_peer->tablet()->SafeTime(
+              tablet::RequireLease::kFalse, read_time.read, CoarseTimePoint::min()).is_valid()) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(IllegalState, "Follower safe time is behind read time $0", read_time),
+            TabletServerErrorPB::STALE_FOLLOWER, context);
+        return false;
+      }
       if (FLAGS_max_stale_read_bound_time_ms > 0) {
         shared_ptr <consensus::Consensus> consensus = tablet_peer->shared_consensus();
         // TODO(hector): This safe time could be reused by the read operation.
@@ -1557,7 +1596,7 @@ bool TabletServiceImpl::DoGetTabletOrRespond(
   }
 
   shared_ptr<tablet::Tablet> ptr;
-  TabletServerErrorPB::Code error_code;
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
   s = GetTabletRef(tablet_peer, &ptr, &error_code);
   if (PREDICT_FALSE(!s.ok())) {
     SetupErrorAndRespond(resp->mutable_error(), s, error_code, context);
@@ -2046,6 +2085,8 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
         read_context->read_time.local_limit = read_context->safe_ht_to_read;
         return read_context->read_time;
       }
+      // TODO: rows are serialized into faststring and copied into the sidecar buffers of the
+      // call. Sending them without the copy requires serializing rows directly into a RefCntBuffer.
       result.response.set_rows_data_sidecar(read_context->context->AddRpcSidecar(result.rows_data));
       read_context->resp->add_ql_batch()->Swap(&result.response);
     }
@@ -2084,9 +2125,55 @@ ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& me
                                            TabletPeerLookupIf* tablet_manager)
     : ConsensusServiceIf(metric_entity),
       tablet_manager_(tablet_manager) {
+  CHECK_OK(ThreadPoolBuilder("multi-raft-update")
+               .set_min_threads(1)
+               .set_max_threads(FLAGS_multi_raft_update_max_threads)
+               .Build(&multi_raft_update_pool_));
 }
 
 ConsensusServiceImpl::~ConsensusServiceImpl() {
+  multi_raft_update_pool_->Shutdown();
+}
+
+Status ConsensusServiceImpl::DoUpdateConsensus(ConsensusRequestPB* req,
+                                               ConsensusResponsePB* resp,
+                                               CoarseTimePoint deadline,
+                                               TabletServerErrorPB::Code* error_code) {
+  TabletPeerPtr tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    *error_code = s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                           : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return s;
+  }
+
+  tablet::RaftGroupStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStateError(state))
+        .CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING));
+  }
+
+  // Submit the update directly to the TabletPeer's Consensus instance.
+  auto consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+  }
+
+  s = consensus->Update(req, resp, deadline);
+  if (PREDICT_FALSE(!s.ok())) {
+    *error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+    return s;
+  }
+
+  auto tablet = tablet_peer->shared_tablet();
+  if (tablet) {
+    resp->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+  }
+
+  resp->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
+  return Status::OK();
 }
 
 void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
@@ -2096,37 +2183,106 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   if (!CheckUuidMatchOrRespond(tablet_manager_, "UpdateConsensus", req, resp, &context)) {
     return;
   }
-  auto tablet_peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
-      tablet_manager_, req->tablet_id(), resp, &context));
-
-  // Submit the update directly to the TabletPeer's Consensus instance.
-  shared_ptr<Consensus> consensus;
-  if (!GetConsensusOrRespond(tablet_peer, resp, &context, &consensus)) return;
 
   // Unfortunately, we have to use const_cast here, because the protobuf-generated interface only
   // gives us a const request, but we need to be able to move messages out of the request for
   // efficiency.
-  Status s = consensus->Update(
-      const_cast<ConsensusRequestPB*>(req), resp, context.GetClientDeadline());
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  Status s = DoUpdateConsensus(
+      const_cast<ConsensusRequestPB*>(req), resp, context.GetClientDeadline(), &error_code);
   if (PREDICT_FALSE(!s.ok())) {
     // Clear the response first, since a partially-filled response could
     // result in confusing a caller, or in having missing required fields
     // in embedded optional messages.
     resp->Clear();
 
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::UNKNOWN_ERROR,
-                         &context);
+    SetupErrorAndRespond(resp->mutable_error(), s, error_code, &context);
     return;
   }
 
-  auto tablet = tablet_peer->shared_tablet();
-  if (tablet) {
-    resp->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+  context.RespondSuccess();
+}
+
+namespace {
+
+// Shared by the tasks applying the requests of a single MultiRaftUpdateConsensus call. The last
+// task to finish sends the response.
+struct MultiRaftUpdateState {
+  MultiRaftUpdateState(rpc::RpcContext rpc_context, size_t num_entries)
+      : context(std::move(rpc_context)), pending(num_entries) {}
+
+  void EntryDone() {
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      context.RespondSuccess();
+    }
   }
 
-  resp->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
-  context.RespondSuccess();
+  rpc::RpcContext context;
+  std::atomic<size_t> pending;
+};
+
+} // namespace
+
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Raft Consensus Update RPC: " << req->ShortDebugString();
+  const auto num_requests = req->consensus_request_size();
+  if (num_requests == 0) {
+    context.RespondSuccess();
+    return;
+  }
+
+  // Allocate all response slots up front, so each task fills its own slot without touching the
+  // repeated field.
+  for (int i = 0; i != num_requests; ++i) {
+    resp->add_consensus_response();
+  }
+
+  // Heartbeats in the batch are independent, so a tablet that cannot take its update lock in time
+  // should fail on its own instead of holding up the response for the whole batch.
+  const auto deadline = std::min(
+      context.GetClientDeadline(),
+      CoarseMonoClock::now() + FLAGS_multi_raft_update_entry_timeout_ms * 1ms);
+  auto state = std::make_shared<MultiRaftUpdateState>(std::move(context), num_requests);
+  for (int i = 0; i != num_requests; ++i) {
+    // Requests in the batch carry no ops, so nothing is moved out of them. But Update still takes
+    // a non-const request.
+    auto* entry_req = const_cast<ConsensusRequestPB*>(&req->consensus_request(i));
+    auto* entry_resp = resp->mutable_consensus_response(i);
+    Status s = multi_raft_update_pool_->SubmitFunc([this, entry_req, entry_resp, deadline, state] {
+      UpdateConsensusInBatch(entry_req, entry_resp, deadline);
+      state->EntryDone();
+    });
+    if (PREDICT_FALSE(!s.ok())) {
+      StatusToPB(s, entry_resp->mutable_error()->mutable_status());
+      entry_resp->mutable_error()->set_code(TabletServerErrorPB::UNKNOWN_ERROR);
+      state->EntryDone();
+    }
+  }
+}
+
+void ConsensusServiceImpl::UpdateConsensusInBatch(
+    ConsensusRequestPB* req, ConsensusResponsePB* resp, CoarseTimePoint deadline) {
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  Status s;
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  if (PREDICT_FALSE(req->dest_uuid() != local_uuid)) {
+    s = STATUS_FORMAT(InvalidArgument,
+                      "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                      "Local UUID: $0. Requested UUID: $1",
+                      local_uuid, req->dest_uuid());
+    error_code = TabletServerErrorPB::WRONG_SERVER_UUID;
+  } else {
+    s = DoUpdateConsensus(req, resp, deadline, &error_code);
+  }
+
+  if (PREDICT_FALSE(!s.ok())) {
+    resp->Clear();
+    StatusToPB(s, resp->mutable_error()->mutable_status());
+    resp->mutable_error()->set_code(error_code);
+  }
 }
 
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
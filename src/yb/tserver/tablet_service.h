@@ -51,6 +51,7 @@ namespace yb {
 class Schema;
 class Status;
 class HybridTime;
+class ThreadPool;
 
 namespace tserver {
 
@@ -264,6 +265,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB* req,
+                                consensus::MultiRaftConsensusResponsePB* resp,
+                                rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -301,7 +306,25 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     rpc::RpcContext context) override;
 
  private:
+  // Looks up the tablet addressed by req and applies req to its consensus instance. Shared by
+  // UpdateConsensus and MultiRaftUpdateConsensus. On failure error_code is set to the code that
+  // should be reported to the caller.
+  CHECKED_STATUS DoUpdateConsensus(consensus::ConsensusRequestPB* req,
+                                   consensus::ConsensusResponsePB* resp,
+                                   CoarseTimePoint deadline,
+                                   TabletServerErrorPB::Code* error_code);
+
+  // Applies a single request from MultiRaftUpdateConsensus. Errors are reported in resp, since the
+  // other requests of the batch should still be processed.
+  void UpdateConsensusInBatch(consensus::ConsensusRequestPB* req,
+                              consensus::ConsensusResponsePB* resp,
+                              CoarseTimePoint deadline);
+
   TabletPeerLookupIf* tablet_manager_;
+
+  // Applies the requests of a MultiRaftUpdateConsensus batch in parallel, so a tablet that is slow
+  // to take its update lock does not delay heartbeats of the other tablets in the batch.
+  std::unique_ptr<ThreadPool> multi_raft_update_pool_;
 };
 
 }  // namespace tserver
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <string>
 #include <vector>
 
@@ -50,6 +51,7 @@
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
 #include "yb/consensus/retryable_requests.h"
@@ -99,6 +101,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
@@ -106,6 +109,7 @@
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
 
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
@@ -124,6 +128,17 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_bool(db_block_cache_use_clock, false,
+            "Use the CLOCK block cache, which does not lock a shard exclusively on every lookup, "
+            "instead of the LRU block cache.");
+TAG_FLAG(db_block_cache_use_clock, advanced);
+
+DEFINE_int64(db_pinned_index_and_filter_memory_bytes, 0,
+             "Memory budget for top-level data index and fixed-size filter index blocks of SST "
+             "files that are pinned in memory outside of the block cache. Blocks that do not fit "
+             "into the budget are accessed through the block cache. 0 disables pinning.");
+TAG_FLAG(db_pinned_index_and_filter_memory_bytes, advanced);
+
 DEFINE_bool(enable_log_cache_gc, true,
             "Set to true to enable log cache garbage collector.");
 
@@ -132,6 +147,13 @@ DEFINE_bool(log_cache_gc_evict_only_over_allocated, true,
             "allocated over limit for log cache. Otherwise it will try to evict requested number "
             "of bytes.");
 
+DEFINE_int64(log_cache_gc_max_compress_bytes, 4_MB,
+             "Maximum number of bytes of operations that one log cache garbage collection may "
+             "compress. Garbage collection runs on the thread that allocates log cache memory, "
+             "so this bounds the delay it adds to that thread. Memory that is still required "
+             "after that is freed by eviction. 0 disables compression by garbage collection.");
+TAG_FLAG(log_cache_gc_max_compress_bytes, advanced);
+
 DEFINE_bool(enable_block_based_table_cache_gc, false,
             "Set to true to enable block based table garbage collector.");
 
@@ -464,13 +486,20 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       block_cache_size_bytes, "BlockBasedTable", server_->mem_tracker());
 
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    tablet_options_.block_cache = FLAGS_db_block_cache_use_clock
+        ? rocksdb::NewClockCache(block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits)
+        : rocksdb::NewLRUCache(block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(tablet_options_.block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
   }
 
+  if (FLAGS_db_pinned_index_and_filter_memory_bytes > 0) {
+    pinned_index_and_filter_mem_tracker_ = MemTracker::FindOrCreateTracker(
+        FLAGS_db_pinned_index_and_filter_memory_bytes, "PinnedIndexAndFilter",
+        server_->mem_tracker());
+  }
+
   auto log_cache_mem_tracker = consensus::LogCache::GetServerMemTracker(server_->mem_tracker());
   log_cache_gc_ = std::make_shared<FunctorGC>(
       std::bind(&TSTabletManager::LogCacheGC, this, log_cache_mem_tracker.get(), _1));
@@ -550,6 +579,9 @@ Status TSTabletManager::Init() {
                 .set_metrics(std::move(metrics))
                 .Build(&open_tablet_pool_));
 
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(
+      server_->messenger(), &server_->proxy_cache());
+
   CleanupCheckpoints();
 
   // Search for tablets in the metadata dir.
@@ -1382,6 +1414,7 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
       .clock = scoped_refptr<server::Clock>(server_->clock()),
       .parent_mem_tracker = MemTracker::FindOrCreateTracker("Tablets", server_->mem_tracker()),
       .block_based_table_mem_tracker = block_based_table_mem_tracker_,
+      .pinned_index_and_filter_mem_tracker = pinned_index_and_filter_mem_tracker_,
       .metric_registry = metric_registry_,
       .log_anchor_registry = tablet_peer->log_anchor_registry(),
       .tablet_options = tablet_options_,
@@ -1423,7 +1456,8 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
         raft_pool(),
         tablet_prepare_pool(),
         &retryable_requests,
-        yb::OpId::FromPB(bootstrap_info.split_op_id));
+        yb::OpId::FromPB(bootstrap_info.split_op_id),
+        multi_raft_manager_.get());
 
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to init: "
@@ -2210,6 +2244,48 @@ size_t GetLogCacheSize(TabletPeer* peer) {
   return down_cast<consensus::RaftConsensus*>(peer->consensus())->LogCacheSize();
 }
 
+// Frees log cache memory of the given peers, oldest operations first across all peers.
+// In kCompress mode, stops when 'compress_budget' is used up.
+size_t FreeOldestLogCacheEntries(
+    const std::vector<TabletPeerPtr>& peers, consensus::LogCacheFreeMode mode,
+    size_t bytes_to_free, int64_t* compress_budget) {
+  typedef std::pair<CoarseTimePoint, consensus::RaftConsensus*> Candidate;
+  auto compare = [](const Candidate& lhs, const Candidate& rhs) {
+    // Note inverse order, so the peer with the oldest operation is at the top.
+    return lhs.first > rhs.first;
+  };
+  std::priority_queue<Candidate, std::vector<Candidate>, decltype(compare)> queue(compare);
+  for (const auto& peer : peers) {
+    auto* consensus = down_cast<consensus::RaftConsensus*>(peer->consensus());
+    auto oldest_entry_time = consensus->LogCacheOldestEntryTime(mode);
+    if (oldest_entry_time != CoarseTimePoint::max()) {
+      queue.emplace(oldest_entry_time, consensus);
+    }
+  }
+
+  size_t total_freed = 0;
+  while (total_freed < bytes_to_free && !queue.empty()) {
+    if (mode == consensus::LogCacheFreeMode::kCompress && *compress_budget <= 0) {
+      break;
+    }
+    auto* consensus = queue.top().second;
+    queue.pop();
+    // Free operations of this peer that are not newer than the oldest operation of other peers.
+    auto added_before = queue.empty() ? CoarseTimePoint::max() : queue.top().first;
+    auto freed = consensus->FreeLogCache(
+        mode, added_before, bytes_to_free - total_freed, compress_budget);
+    total_freed += freed;
+    if (freed == 0) {
+      continue;
+    }
+    auto oldest_entry_time = consensus->LogCacheOldestEntryTime(mode);
+    if (oldest_entry_time != CoarseTimePoint::max()) {
+      queue.emplace(oldest_entry_time, consensus);
+    }
+  }
+  return total_freed;
+}
+
 void TSTabletManager::LogCacheGC(MemTracker* log_cache_mem_tracker, size_t bytes_to_evict) {
   if (!FLAGS_enable_log_cache_gc) {
     return;
@@ -2242,16 +2318,30 @@ void TSTabletManager::LogCacheGC(MemTracker* log_cache_mem_tracker, size_t bytes
     return GetLogCacheSize(lhs.get()) > GetLogCacheSize(rhs.get());
   });
 
+  // Operations that were already replicated to all peers are the cheapest to evict, since they
+  // would only be read again by CDC.
   size_t total_evicted = 0;
   for (const auto& peer : peers) {
     size_t evicted = down_cast<consensus::RaftConsensus*>(
-        peer->consensus())->EvictLogCache(bytes_to_evict - total_evicted);
+        peer->consensus())->EvictReplicatedToAllLogCache(bytes_to_evict - total_evicted);
     total_evicted += evicted;
     if (total_evicted >= bytes_to_evict) {
       break;
     }
   }
 
+  // Then compress and, if that is not enough, evict the oldest operations of all tablets, so
+  // tablets with recent operations are not penalized for tablets that hold old ones.
+  // Compression is capped, since it runs synchronously on the allocating thread.
+  int64_t compress_budget = FLAGS_log_cache_gc_max_compress_bytes;
+  for (auto mode : {consensus::LogCacheFreeMode::kCompress, consensus::LogCacheFreeMode::kEvict}) {
+    if (total_evicted >= bytes_to_evict) {
+      break;
+    }
+    total_evicted += FreeOldestLogCacheEntries(
+        peers, mode, bytes_to_evict - total_evicted, &compress_budget);
+  }
+
   LOG(INFO) << "Evicted from log cache: " << HumanReadableNumBytes::ToString(total_evicted)
             << ", required: " << HumanReadableNumBytes::ToString(bytes_to_evict);
 }
@@ -534,6 +534,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Batches heartbeats that tablet leaders send to the same tablet server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -545,6 +548,7 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   std::shared_ptr<GarbageCollector> log_cache_gc_;
 
   std::shared_ptr<MemTracker> block_based_table_mem_tracker_;
+  std::shared_ptr<MemTracker> pinned_index_and_filter_mem_tracker_;
 
   std::atomic<int32_t> num_tablets_being_remote_bootstrapped_{0};
 
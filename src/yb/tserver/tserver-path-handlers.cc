@@ -42,6 +42,8 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
@@ -56,6 +58,7 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/url-coding.h"
 
 namespace {
@@ -210,7 +213,8 @@ void HandleTabletPage(
       {"tablet-consensus-status", "Consensus Status"},
       {"log-anchors", "Tablet Log Anchors"},
       {"transactions", "Transactions"},
-      {"rocksdb", "RocksDB" }};
+      {"rocksdb", "RocksDB" },
+      {"hot-keys", "Hot Keys" }};
 
   auto encoded_tablet_id = UrlEncodeToString(tablet_id);
   for (const auto& entry : entries) {
@@ -318,6 +322,43 @@ void HandleRocksDBPage(
   DumpRocksDB("Intents", doc_db.intents, output);
 }
 
+std::string HotKeyToString(const std::string& encoded_key) {
+  docdb::DocKey doc_key;
+  if (doc_key.DecodeFrom(encoded_key, docdb::DocKeyPart::kUpToHashOrFirstRange).ok()) {
+    return doc_key.ToString();
+  }
+  return Slice(encoded_key).ToDebugHexString();
+}
+
+void HandleHotKeysPage(
+    const std::string& tablet_id, const tablet::TabletPeerPtr& peer,
+    const Webserver::WebRequest& req, Webserver::WebResponse* resp) {
+  std::stringstream *output = &resp->output;
+  auto tablet = peer->shared_tablet();
+  if (!tablet) {
+    *output << "Tablet " << EscapeForHtmlToString(tablet_id) << " not running";
+    return;
+  }
+
+  *output << "<h1>Hot Keys for Tablet " << EscapeForHtmlToString(tablet_id) << "</h1>"
+          << std::endl;
+
+  const auto& tracker = tablet->hot_key_tracker();
+  const auto num_samples = std::max<uint64_t>(tracker.num_samples(), 1);
+  *output << "<p>Keys are sampled, counts are estimated from recent samples and could exceed the "
+          << "real ones by up to the error.</p>" << std::endl;
+  *output << "<table class='table table-striped'>" << std::endl;
+  *output << "  <tr><th>Key</th><th>Share</th><th>Count</th><th>Error</th><th>Reads</th>"
+          << "<th>Writes</th></tr>" << std::endl;
+  for (const auto& info : tracker.TopKeys()) {
+    *output << Format(
+        "  <tr><td>$0</td><td>$1%</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td></tr>\n",
+        EscapeForHtmlToString(HotKeyToString(info.key)), info.count * 100 / num_samples,
+        info.count, info.error, info.reads, info.writes);
+  }
+  *output << "</table>" << std::endl;
+}
+
 template<class F>
 void RegisterTabletPathHandler(
     Webserver* web_server, TabletServer* tserver, const std::string& path, const F& f) {
@@ -354,6 +395,7 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   RegisterTabletPathHandler(server, tserver_, "/log-anchors", &HandleLogAnchorsPage);
   RegisterTabletPathHandler(server, tserver_, "/transactions", &HandleTransactionsPage);
   RegisterTabletPathHandler(server, tserver_, "/rocksdb", &HandleRocksDBPage);
+  RegisterTabletPathHandler(server, tserver_, "/hot-keys", &HandleHotKeysPage);
   server->RegisterPathHandler(
       "/", "Dashboards",
       std::bind(&TabletServerPathHandlers::HandleDashboardsPage, this, _1, _2), true /* styled */,
@@ -362,6 +404,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/compactions", "",
+      std::bind(&TabletServerPathHandlers::HandleCompactionsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/api/v1/health-check", "TServer Health Check",
       std::bind(&TabletServerPathHandlers::HandleHealthCheck, this, _1, _2),
@@ -737,6 +783,24 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+void TabletServerPathHandlers::HandleCompactionsPage(const Webserver::WebRequest& req,
+                                                     Webserver::WebResponse* resp) {
+  std::stringstream *output = &resp->output;
+  auto tasks = docdb::GetPriorityThreadPoolForCompactionsAndFlushes()->TasksInfo();
+
+  *output << "<h1>Flushes and compactions</h1>\n";
+  *output << "<p>Tasks are listed in the order they are picked for running.</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Task</th><th>State</th><th>Priority</th></tr>\n";
+  for (const auto& task : tasks) {
+    *output << Substitute("<tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                          EscapeForHtmlToString(task.task),
+                          EscapeForHtmlToString(task.state),
+                          task.priority);
+  }
+  *output << "</table>\n";
+}
+
 void TabletServerPathHandlers::HandleHealthCheck(const Webserver::WebRequest& req,
                                                  Webserver::WebResponse* resp) {
   std::stringstream *output = &resp->output;
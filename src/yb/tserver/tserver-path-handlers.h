@@ -70,6 +70,8 @@ class TabletServerPathHandlers {
                             Webserver::WebResponse* resp);
   void HandleDashboardsPage(const Webserver::WebRequest& req,
                             Webserver::WebResponse* resp);
+  void HandleCompactionsPage(const Webserver::WebRequest& req,
+                             Webserver::WebResponse* resp);
   void HandleMaintenanceManagerPage(const Webserver::WebRequest& req,
                                     Webserver::WebResponse* resp);
   void HandleHealthCheck(const Webserver::WebRequest& req,
@@ -28,6 +28,9 @@
 #include <sys/syscall.h>
 #endif // __linux__
 
+#include "yb/gutil/gscoped_ptr.h"
+
+#include "yb/util/alignment.h"
 #include "yb/util/coding.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/errno.h"
@@ -35,6 +38,7 @@
 #include "yb/util/thread_restrictions.h"
 
 DECLARE_bool(suicide_on_eio);
+DECLARE_int32(o_direct_block_alignment_bytes);
 
 // For platforms without fdatasync (like OS X)
 #ifndef fdatasync
@@ -74,6 +78,36 @@ int Fadvise(int fd, off_t offset, size_t len, int advice) {
 
 #define STATUS_IO_ERROR(context, err_number) IOError(context, err_number, __FILE__, __LINE__)
 
+// Aligned buffer for O_DIRECT reads. It is kept per thread and reused by all direct reads done by
+// this thread, and is reallocated only when a larger buffer or another alignment is required.
+// Reads larger than kMaxThreadLocalAlignedReadBufferSize use a temporary buffer instead, so the
+// per thread buffer stays bounded.
+constexpr size_t kMaxThreadLocalAlignedReadBufferSize = 4 * 1024 * 1024;
+
+class AlignedReadBuffer {
+ public:
+  Result<uint8_t*> Get(size_t alignment, size_t size) {
+    if (size > capacity_ || alignment != alignment_) {
+      void* buffer = nullptr;
+      auto err = posix_memalign(&buffer, alignment, size);
+      if (err) {
+        return STATUS(RuntimeError, "Unable to allocate memory", Errno(err));
+      }
+      buffer_.reset(static_cast<uint8_t*>(buffer));
+      capacity_ = size;
+      alignment_ = alignment;
+    }
+    return buffer_.get();
+  }
+
+ private:
+  gscoped_ptr<uint8_t, FreeDeleter> buffer_;
+  size_t capacity_ = 0;
+  size_t alignment_ = 0;
+};
+
+thread_local AlignedReadBuffer aligned_read_buffer;
+
 } // namespace
 
 #if defined(__linux__)
@@ -199,6 +233,48 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+PosixDirectIORandomAccessFile::PosixDirectIORandomAccessFile(
+    const std::string& fname, int fd, const FileSystemOptions& options)
+    : PosixRandomAccessFile(fname, fd, options) {}
+
+Status PosixDirectIORandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
+                                           uint8_t* scratch) const {
+  ThreadRestrictions::AssertIOAllowed();
+  const size_t alignment = FLAGS_o_direct_block_alignment_bytes;
+  const uint64_t aligned_offset = offset - offset % alignment;
+  const size_t skip = offset - aligned_offset;
+  const size_t aligned_size = align_up(skip + n, alignment);
+
+  AlignedReadBuffer temp_buffer;
+  auto& buffer = aligned_size <= kMaxThreadLocalAlignedReadBufferSize ? aligned_read_buffer
+                                                                      : temp_buffer;
+  uint8_t* aligned_buffer = VERIFY_RESULT(buffer.Get(alignment, aligned_size));
+
+  Status s;
+  size_t bytes_read = 0;
+  while (bytes_read < aligned_size) {
+    ssize_t r = pread(fd_, aligned_buffer + bytes_read, aligned_size - bytes_read,
+                      static_cast<off_t>(aligned_offset + bytes_read));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      s = STATUS_IO_ERROR(filename_, errno);
+      break;
+    }
+    if (r == 0) {
+      // End of file.
+      break;
+    }
+    bytes_read += r;
+  }
+
+  const size_t result_size = bytes_read > skip ? std::min(bytes_read - skip, n) : 0;
+  memcpy(scratch, aligned_buffer + skip, result_size);
+  *result = Slice(scratch, s.ok() ? result_size : 0);
+  return s;
+}
+
 Result<uint64_t> PosixRandomAccessFile::Size() const {
   TRACE_EVENT1("io", __PRETTY_FUNCTION__, "path", filename_);
   ThreadRestrictions::AssertIOAllowed();
@@ -64,12 +64,24 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual void Hint(AccessPattern pattern) override;
   virtual CHECKED_STATUS InvalidateCache(size_t offset, size_t length) override;
 
- private:
+ protected:
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
 };
 
+// Random-access file opened with O_DIRECT. Reads are widened to --o_direct_block_alignment_bytes
+// boundaries and go through an aligned buffer, because O_DIRECT requires the offset, the length
+// and the destination to be aligned.
+class PosixDirectIORandomAccessFile : public PosixRandomAccessFile {
+ public:
+  PosixDirectIORandomAccessFile(const std::string& fname, int fd,
+                                const FileSystemOptions& options);
+
+  CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result,
+                      uint8_t* scratch) const override;
+};
+
 } // namespace yb
 
 #endif  // YB_UTIL_FILE_SYSTEM_POSIX_H
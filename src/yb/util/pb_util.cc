@@ -189,7 +189,7 @@ bool ParseFromSequentialFile(MessageLite *msg, SequentialFile *rfile) {
 
 Status ParseFromArray(MessageLite* msg, const uint8_t* data, uint32_t length) {
   CodedInputStream in(data, length);
-  in.SetTotalBytesLimit(511 * 1024 * 1024, -1);
+  in.SetTotalBytesLimit(kParseFromArrayMaxSize, -1);
   // Parse data into protobuf message
   if (!msg->ParseFromCodedStream(&in)) {
     return STATUS(Corruption, "Error parsing msg", InitializationErrorMessage("parse", *msg));
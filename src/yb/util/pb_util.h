@@ -89,6 +89,9 @@ bool SerializeToString(const MessageLite &msg, faststring *output);
 // TODO: change this to return Status - differentiate IO error from bad PB
 bool ParseFromSequentialFile(MessageLite *msg, SequentialFile *rfile);
 
+// Messages bigger than this are rejected by ParseFromArray.
+constexpr uint32_t kParseFromArrayMaxSize = 511 * 1024 * 1024;
+
 // Similar to MessageLite::ParseFromArray, with the difference that it returns
 // Status::kCorruption if the message could not be parsed.
 Status ParseFromArray(MessageLite* msg, const uint8_t* data, uint32_t length);
@@ -288,6 +288,14 @@ TEST(PriorityThreadPoolTest, ChangePriority) {
   ASSERT_TRUE(thread_pool.ChangeTaskPriority(task5, 6));
   share.FillRunningTaskPriorities(&running);
   ASSERT_EQ(running, std::vector<int>({2, 5, 6}));
+
+  // Tasks are listed in the order they would be picked.
+  std::vector<std::string> tasks;
+  for (const auto& info : thread_pool.TasksInfo()) {
+    tasks.push_back(Format("$0 $1", info.task, info.priority));
+  }
+  ASSERT_EQ(tasks, std::vector<std::string>(
+      {"{ index: 5 } 6", "{ index: 6 } 6", "{ index: 2 } 4", "{ index: 3 } 3"}));
 }
 
 } // namespace yb
@@ -107,7 +107,6 @@ class PriorityThreadPoolInternalTask {
                   TaskToString(), worker_, state(), priority(), serial_no_);
   }
 
- private:
   const std::string& TaskToString() const {
     if (!task_to_string_ready_.load(std::memory_order_acquire)) {
       std::lock_guard<simple_spinlock> lock(task_to_string_mutex_);
@@ -119,6 +118,7 @@ class PriorityThreadPoolInternalTask {
     return task_to_string_;
   }
 
+ private:
   std::atomic<int> priority_;
   const size_t serial_no_;
   std::atomic<PriorityThreadPoolTaskState> state_{PriorityThreadPoolTaskState::kNotStarted};
@@ -504,6 +504,17 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
     return DoStateToString();
   }
 
+  std::vector<PriorityThreadPoolTaskInfo> TasksInfo() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PriorityThreadPoolTaskInfo> result;
+    result.reserve(tasks_.size());
+    for (const auto& task : tasks_) {
+      result.push_back({
+          task.TaskToString(), task.priority(), yb::ToString(task.state()), task.serial_no()});
+    }
+    return result;
+  }
+
  private:
   std::string DoStateToString() REQUIRES(mutex_) {
     return Format(
@@ -717,6 +728,10 @@ std::string PriorityThreadPool::StateToString() {
   return impl_->StateToString();
 }
 
+std::vector<PriorityThreadPoolTaskInfo> PriorityThreadPool::TasksInfo() {
+  return impl_->TasksInfo();
+}
+
 bool PriorityThreadPool::ChangeTaskPriority(size_t serial_no, int priority) {
   return impl_->ChangeTaskPriority(serial_no, priority);
 }
@@ -15,6 +15,8 @@
 #define YB_UTIL_PRIORITY_THREAD_POOL_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "yb/util/locks.h"
 #include "yb/util/status.h"
@@ -54,6 +56,14 @@ class PriorityThreadPoolTask {
   const size_t serial_no_;
 };
 
+// Snapshot of task state, used for diagnostics.
+struct PriorityThreadPoolTaskInfo {
+  std::string task;
+  int priority;
+  std::string state;
+  size_t serial_no;
+};
+
 // Tasks submitted to this pool have assigned priority and are picked from queue using it.
 class PriorityThreadPool {
  public:
@@ -99,6 +109,9 @@ class PriorityThreadPool {
   // Dumps state to string, useful for debugging.
   std::string StateToString();
 
+  // Returns information about tasks of this pool, ordered by priority.
+  std::vector<PriorityThreadPoolTaskInfo> TasksInfo();
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
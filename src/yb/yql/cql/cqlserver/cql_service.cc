@@ -117,14 +117,15 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts)
     : CQLServerServiceIf(server->metric_entity()),
       server_(server),
       next_available_processor_(processors_.end()),
+      prepared_stmts_cache_(server->metric_entity()),
       password_cache_(FLAGS_password_hash_cache_size),
       // TODO(ENG-446): Handle metrics for all the methods individually.
       cql_metrics_(std::make_shared<CQLMetrics>(server->metric_entity())),
       parser_pool_(ParserFactory(cql_metrics_.get()), ParserDeleter(cql_metrics_.get())),
       messenger_(server->messenger()) {
 
-  // Setup prepared statements' memory tracker. Add garbage-collect function to delete least
-  // recently used statements when limit is hit.
+  // Setup prepared statements' memory tracker. Add garbage-collect function to delete statements
+  // that were not recently used when limit is hit.
   prepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
       FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
       FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
@@ -242,27 +243,10 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
 
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
-    // statement to contend on. The statement will then be prepared by one client while the rest
-    // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
-        query_id, std::make_shared<CQLStatement>(
-            keyspace, query, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
-  } else {
-    // Return existing statement if found.
-    stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
-  }
+  shared_ptr<CQLStatement> stmt = prepared_stmts_cache_.Allocate(query_id, keyspace, query);
 
   VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+          << prepared_stmts_cache_.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 
   return stmt;
@@ -270,38 +254,14 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
-  }
-
-  shared_ptr<CQLStatement> stmt = itr->second;
-
-  // If the statement has not finished preparing, do not return it.
-  if (stmt->unprepared()) {
-    return nullptr;
-  }
-  // If the statement is stale, delete it.
-  if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
-    return nullptr;
-  }
-
-  MoveLruPreparedStatementUnlocked(stmt);
-  return stmt;
+  return prepared_stmts_cache_.Get(query_id);
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
-  // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  DeletePreparedStatementUnlocked(stmt);
+  prepared_stmts_cache_.Delete(stmt);
 
   VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+          << prepared_stmts_cache_.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
@@ -344,44 +304,11 @@ bool CQLServiceImpl::CheckPassword(
   return correct;
 }
 
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
-void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
-  // Remove statement from cache by looking it up by query ID and only when it is same statement
-  // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
-  }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
-  }
-}
-
 void CQLServiceImpl::CollectGarbage(size_t required) {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
-  }
+  prepared_stmts_cache_.EvictOne();
 
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "EvictPreparedStatement: CQL prepared statement cache count = "
+          << prepared_stmts_cache_.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
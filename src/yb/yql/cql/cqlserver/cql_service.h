@@ -28,6 +28,7 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/cqlserver/cql_service.service.h"
 #include "yb/yql/cql/cqlserver/cql_statement.h"
+#include "yb/yql/cql/cqlserver/cql_statement_cache.h"
 #include "yb/yql/cql/cqlserver/system_query_cache.h"
 #include "yb/yql/cql/ql/statement.h"
 
@@ -115,19 +116,7 @@ class CQLServiceImpl : public CQLServerServiceIf,
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
-
-  // Delete the least recently used prepared statement from the cache to free up memory.
+  // Delete a prepared statement that was not recently used from the cache to free up memory.
   void CollectGarbage(size_t required) override;
 
   // CQLServer of this service.
@@ -149,13 +138,7 @@ class CQLServiceImpl : public CQLServerServiceIf,
   std::mutex processors_mutex_;
 
   // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
-
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
-
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  CQLStatementCache prepared_stmts_cache_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
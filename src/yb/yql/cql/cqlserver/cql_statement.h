@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -34,7 +35,8 @@ class CQLStatement;
 // it when it is being executed by another client in another thread.
 using CQLStatementMap = std::unordered_map<CQLMessage::QueryId, std::shared_ptr<CQLStatement>>;
 
-// A LRU list of CQL statements and position in the list.
+// A list of CQL statements for the CLOCK replacement of the statement cache, and position in the
+// list.
 using CQLStatementList = std::list<std::shared_ptr<CQLStatement>>;
 using CQLStatementListPos = CQLStatementList::iterator;
 
@@ -47,16 +49,29 @@ class CQLStatement : public ql::Statement {
   // Return the query id.
   CQLMessage::QueryId query_id() const { return GetQueryId(keyspace_, text_); }
 
-  // Get/set position of the statement in the LRU.
+  // Get/set position of the statement in the cache list.
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Get/set/clear the reference bit used by the cache to approximate LRU. The bit is only written
+  // when it changes, so that looking up a hot statement does not keep invalidating its cache line.
+  bool referenced() const { return referenced_.load(std::memory_order_relaxed); }
+  void set_referenced() const {
+    if (!referenced()) {
+      referenced_.store(true, std::memory_order_relaxed);
+    }
+  }
+  void clear_referenced() const { referenced_.store(false, std::memory_order_relaxed); }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& query);
 
  private:
-  // Position of the statement in the LRU.
+  // Position of the statement in the cache list.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement was used since the cache's clock hand last passed it.
+  mutable std::atomic<bool> referenced_{true};
 };
 
 }  // namespace cqlserver
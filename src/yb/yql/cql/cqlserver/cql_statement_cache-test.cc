@@ -0,0 +1,87 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "yb/yql/cql/cqlserver/cql_statement_cache.h"
+
+#include "yb/util/format.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace cqlserver {
+
+namespace {
+
+const std::string kKeyspace = "test_keyspace";
+
+std::string Query(size_t i) {
+  return Format("SELECT * FROM t WHERE k = $0", i);
+}
+
+std::shared_ptr<CQLStatement> Allocate(CQLStatementCache* cache, size_t i) {
+  return cache->Allocate(CQLStatement::GetQueryId(kKeyspace, Query(i)), kKeyspace, Query(i));
+}
+
+} // namespace
+
+TEST(CQLStatementCacheTest, AllocateAndDelete) {
+  CQLStatementCache cache(nullptr /* metric_entity */);
+
+  auto stmt = Allocate(&cache, 1);
+  ASSERT_EQ(stmt, Allocate(&cache, 1));
+  ASSERT_NE(stmt, Allocate(&cache, 2));
+  ASSERT_EQ(2U, cache.size());
+
+  // Statement is not prepared yet, so it should not be returned.
+  ASSERT_EQ(nullptr, cache.Get(stmt->query_id()));
+
+  cache.Delete(stmt);
+  ASSERT_EQ(1U, cache.size());
+  auto new_stmt = Allocate(&cache, 1);
+  ASSERT_NE(stmt, new_stmt);
+
+  // Deleting the old statement object should not remove the new one.
+  cache.Delete(stmt);
+  ASSERT_EQ(2U, cache.size());
+  ASSERT_EQ(new_stmt, Allocate(&cache, 1));
+}
+
+TEST(CQLStatementCacheTest, EvictNotRecentlyUsed) {
+  constexpr size_t kNumStatements = 256;
+  constexpr size_t kNumEvictions = kNumStatements / 4;
+
+  CQLStatementCache cache(nullptr /* metric_entity */);
+  std::vector<std::shared_ptr<CQLStatement>> stmts;
+  for (size_t i = 0; i != kNumStatements; ++i) {
+    stmts.push_back(Allocate(&cache, i));
+  }
+
+  // Keep using one statement while others are evicted.
+  const auto& hot_stmt = stmts[kNumStatements / 2];
+  for (size_t i = 0; i != kNumEvictions; ++i) {
+    ASSERT_EQ(hot_stmt, Allocate(&cache, kNumStatements / 2));
+    ASSERT_TRUE(cache.EvictOne());
+  }
+  ASSERT_EQ(kNumStatements - kNumEvictions, cache.size());
+  ASSERT_EQ(hot_stmt, Allocate(&cache, kNumStatements / 2));
+
+  while (cache.size() != 0) {
+    ASSERT_TRUE(cache.EvictOne());
+  }
+  ASSERT_FALSE(cache.EvictOne());
+}
+
+}  // namespace cqlserver
+}  // namespace yb
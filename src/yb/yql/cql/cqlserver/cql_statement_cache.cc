@@ -0,0 +1,172 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/cql/cqlserver/cql_statement_cache.h"
+
+#include <mutex>
+
+#include "yb/util/shared_lock.h"
+
+METRIC_DEFINE_counter(server, cql_prepared_statement_cache_hits,
+                      "CQL Prepared Statement Cache Hits",
+                      yb::MetricUnit::kCacheHits,
+                      "Number of lookups of prepared statements that found a prepared statement.");
+
+METRIC_DEFINE_counter(server, cql_prepared_statement_cache_queries,
+                      "CQL Prepared Statement Cache Queries",
+                      yb::MetricUnit::kCacheQueries,
+                      "Number of lookups of prepared statements.");
+
+METRIC_DEFINE_counter(server, cql_prepared_statement_cache_evictions,
+                      "CQL Prepared Statement Cache Evictions",
+                      yb::MetricUnit::kEntries,
+                      "Number of prepared statements evicted to free up memory.");
+
+namespace yb {
+namespace cqlserver {
+
+using std::shared_ptr;
+using std::string;
+
+CQLStatementCache::CQLStatementCache(const scoped_refptr<MetricEntity>& metric_entity) {
+  if (metric_entity) {
+    hits_ = METRIC_cql_prepared_statement_cache_hits.Instantiate(metric_entity);
+    queries_ = METRIC_cql_prepared_statement_cache_queries.Instantiate(metric_entity);
+    evictions_ = METRIC_cql_prepared_statement_cache_evictions.Instantiate(metric_entity);
+  }
+}
+
+CQLStatementCache::~CQLStatementCache() {
+}
+
+CQLStatementCache::Shard& CQLStatementCache::GetShard(const CQLMessage::QueryId& query_id) {
+  return shards_[std::hash<CQLMessage::QueryId>()(query_id) % kNumShards];
+}
+
+shared_ptr<CQLStatement> CQLStatementCache::Allocate(
+    const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
+  Shard& shard = GetShard(query_id);
+  {
+    SharedLock<rw_spinlock> lock(shard.mutex);
+    const auto itr = shard.map.find(query_id);
+    if (itr != shard.map.end()) {
+      itr->second->set_referenced();
+      return itr->second;
+    }
+  }
+
+  std::lock_guard<rw_spinlock> lock(shard.mutex);
+  auto& stmt = shard.map[query_id];
+  if (stmt) {
+    // Allocated by another client after the lookup above.
+    stmt->set_referenced();
+    return stmt;
+  }
+  // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
+  // statement to contend on. The statement will then be prepared by one client while the rest
+  // wait for the results.
+  stmt = std::make_shared<CQLStatement>(keyspace, query, shard.clock.end());
+  stmt->set_pos(shard.clock.insert(shard.hand, stmt));
+  size_.fetch_add(1, std::memory_order_acq_rel);
+  return stmt;
+}
+
+shared_ptr<const CQLStatement> CQLStatementCache::Get(const CQLMessage::QueryId& query_id) {
+  IncrementCounter(queries_);
+  Shard& shard = GetShard(query_id);
+  shared_ptr<CQLStatement> stmt;
+  {
+    SharedLock<rw_spinlock> lock(shard.mutex);
+    const auto itr = shard.map.find(query_id);
+    if (itr != shard.map.end()) {
+      stmt = itr->second;
+    }
+  }
+
+  // If the statement has not finished preparing, do not return it.
+  if (stmt == nullptr || stmt->unprepared()) {
+    return nullptr;
+  }
+  // If the statement is stale, delete it.
+  if (stmt->stale()) {
+    Delete(stmt);
+    return nullptr;
+  }
+
+  stmt->set_referenced();
+  IncrementCounter(hits_);
+  return stmt;
+}
+
+void CQLStatementCache::Delete(const shared_ptr<const CQLStatement>& stmt) {
+  Shard& shard = GetShard(stmt->query_id());
+  std::lock_guard<rw_spinlock> lock(shard.mutex);
+  DeleteUnlocked(&shard, stmt);
+}
+
+void CQLStatementCache::DeleteUnlocked(Shard* shard, const shared_ptr<const CQLStatement> stmt) {
+  // Remove statement from cache by looking it up by query ID and only when it is same statement
+  // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
+  // a separate copy of the shared_ptr and not the very shared_ptr in the map or the clock list we
+  // are deleting.
+  const auto itr = shard->map.find(stmt->query_id());
+  if (itr != shard->map.end() && itr->second == stmt) {
+    shard->map.erase(itr);
+  }
+  // Remove statement from the clock list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != shard->clock.end()) {
+    if (shard->hand == stmt->pos()) {
+      ++shard->hand;
+    }
+    shard->clock.erase(stmt->pos());
+    stmt->set_pos(shard->clock.end());
+    size_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+bool CQLStatementCache::EvictOne() {
+  const size_t start = next_evict_shard_.fetch_add(1, std::memory_order_relaxed);
+  for (size_t i = 0; i != kNumShards; ++i) {
+    if (EvictFromShard(&shards_[(start + i) % kNumShards])) {
+      IncrementCounter(evictions_);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CQLStatementCache::EvictFromShard(Shard* shard) {
+  std::lock_guard<rw_spinlock> lock(shard->mutex);
+  if (shard->clock.empty()) {
+    return false;
+  }
+
+  // Give every statement a second chance. After a full sweep all reference bits are cleared, so
+  // two sweeps are always enough to find a victim.
+  for (size_t steps = 2 * shard->clock.size(); steps-- > 0;) {
+    if (shard->hand == shard->clock.end()) {
+      shard->hand = shard->clock.begin();
+    }
+    const auto& stmt = *shard->hand;
+    if (!stmt->referenced() || steps == 0) {
+      DeleteUnlocked(shard, stmt);
+      return true;
+    }
+    stmt->clear_referenced();
+    ++shard->hand;
+  }
+  return false;
+}
+
+}  // namespace cqlserver
+}  // namespace yb
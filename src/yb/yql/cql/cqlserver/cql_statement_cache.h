@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains the cache of prepared statements shared by all CQL connections of a server.
+
+#ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_CACHE_H_
+#define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_CACHE_H_
+
+#include <array>
+#include <atomic>
+
+#include "yb/gutil/port.h"
+
+#include "yb/util/locks.h"
+#include "yb/util/metrics.h"
+
+#include "yb/yql/cql/cqlserver/cql_statement.h"
+
+namespace yb {
+namespace cqlserver {
+
+// Cache of prepared statements keyed by query id.
+//
+// The cache is split into shards, each guarded by its own reader-writer spinlock. Looking up an
+// existing statement, which is what every EXECUTE does, takes only a shared lock and sets the
+// statement's reference bit. Recency is approximated with the CLOCK (second chance) algorithm: to
+// free up memory, a clock hand sweeps over the statements of a shard, clearing reference bits, and
+// evicts the first statement that has not been referenced since the previous sweep.
+class CQLStatementCache {
+ public:
+  // Metrics are not reported when metric_entity is null.
+  explicit CQLStatementCache(const scoped_refptr<MetricEntity>& metric_entity);
+  ~CQLStatementCache();
+
+  // Allocate a statement. If the statement already exists, return it instead.
+  std::shared_ptr<CQLStatement> Allocate(
+      const CQLMessage::QueryId& query_id, const std::string& keyspace, const std::string& query);
+
+  // Look up a prepared statement by its id. Nullptr is returned if the statement is not found or
+  // has not finished preparing. A stale statement is deleted and nullptr is returned.
+  std::shared_ptr<const CQLStatement> Get(const CQLMessage::QueryId& query_id);
+
+  // Delete the statement from the cache, if it is still the cached one for its query id.
+  void Delete(const std::shared_ptr<const CQLStatement>& stmt);
+
+  // Evict one statement that was not recently used. Returns false if the cache is empty.
+  bool EvictOne();
+
+  // Number of cached statements.
+  size_t size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct CACHELINE_ALIGNED Shard {
+    Shard() NO_THREAD_SAFETY_ANALYSIS : hand(clock.end()) {}
+
+    rw_spinlock mutex;
+
+    CQLStatementMap map GUARDED_BY(mutex);
+
+    // All statements of the shard, swept by the clock hand. New statements are inserted right
+    // before the hand, so they are visited last.
+    CQLStatementList clock GUARDED_BY(mutex);
+    CQLStatementListPos hand GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(const CQLMessage::QueryId& query_id);
+
+  // Delete a statement from the shard. The shard mutex needs to be locked exclusively before this
+  // call.
+  void DeleteUnlocked(Shard* shard, std::shared_ptr<const CQLStatement> stmt);
+
+  // Evict one statement from the shard. Returns false if the shard is empty.
+  bool EvictFromShard(Shard* shard);
+
+  std::array<Shard, kNumShards> shards_;
+
+  // Shard to start looking for a statement to evict from, so that eviction is spread evenly.
+  std::atomic<size_t> next_evict_shard_{0};
+
+  std::atomic<size_t> size_{0};
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> queries_;
+  scoped_refptr<Counter> evictions_;
+};
+
+}  // namespace cqlserver
+}  // namespace yb
+
+#endif  // YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_CACHE_H_
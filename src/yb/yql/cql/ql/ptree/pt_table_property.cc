@@ -48,7 +48,8 @@ const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPrope
     {"read_repair_chance", KVProperty::kReadRepairChance},
     {"speculative_retry", KVProperty::kSpeculativeRetry},
     {"transactions", KVProperty::kTransactions},
-    {"tablets", KVProperty::kNumTablets}
+    {"tablets", KVProperty::kNumTablets},
+    {"partition_tombstones", KVProperty::kPartitionTombstones}
 };
 
 PTTableProperty::PTTableProperty(MemoryContext *memctx,
@@ -162,6 +163,7 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
   long double double_val;
   int64_t int_val;
   string str_val;
+  bool bool_val;
 
   switch (iterator->second) {
     case KVProperty::kBloomFilterFpChance:
@@ -243,6 +245,9 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
             this, "Number of tablets exceeds system limit", ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kPartitionTombstones:
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetBoolValueFromExpr(rhs_, table_property_name, &bool_val));
+      break;
   }
 
   PTAlterTable *alter_table = sem_context->current_alter_table();
@@ -408,6 +413,14 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       }
       table_property->SetNumTablets(val);
       break;
+    case KVProperty::kPartitionTombstones: {
+      bool bool_val;
+      if (!GetBoolValueFromExpr(rhs_, table_property_name, &bool_val).ok()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for partition_tombstones"));
+      }
+      table_property->SetUsePartitionTombstones(bool_val);
+      break;
+    }
   }
   return Status::OK();
 }
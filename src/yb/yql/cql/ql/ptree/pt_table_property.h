@@ -54,7 +54,8 @@ class PTTableProperty : public PTProperty {
     kReadRepairChance,
     kSpeculativeRetry,
     kTransactions,
-    kNumTablets
+    kNumTablets,
+    kPartitionTombstones
   };
 
   //------------------------------------------------------------------------------------------------
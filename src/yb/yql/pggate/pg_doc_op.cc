@@ -49,12 +49,19 @@ namespace yb {
 namespace pggate {
 
 PgDocResult::PgDocResult(string&& data) : data_(move(data)) {
-  PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
 }
 
 PgDocResult::PgDocResult(string&& data, std::list<int64_t>&& row_orders)
     : data_(move(data)), row_orders_(move(row_orders)) {
+}
+
+Status PgDocResult::LoadCache(PgsqlRowsDataFormat format) {
+  if (format == PGSQL_ROWS_DATA_COLUMNAR) {
+    is_columnar_ = true;
+    return PgDocData::LoadColumnarCache(data_, &row_count_, &columns_);
+  }
   PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
+  return Status::OK();
 }
 
 PgDocResult::~PgDocResult() {
@@ -66,7 +73,13 @@ int64_t PgDocResult::NextRowOrder() {
 
 Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *pg_tuple,
                                  int64_t *row_order) {
+  if (is_columnar_) {
+    SCHECK_EQ(targets.size(), columns_.size(), InternalError,
+              "Number of targets does not match number of columns in the result");
+  }
+
   int attr_num = 0;
+  int column_index = 0;
   for (const PgExpr *target : targets) {
     if (!target->is_colref() && !target->is_aggregate()) {
       return STATUS(InternalError,
@@ -78,8 +91,10 @@ Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *p
       attr_num++;
     }
 
-    PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
-    target->TranslateData(&row_iterator_, header, attr_num - 1, pg_tuple);
+    TranslateColumn(target, column_index++, attr_num - 1, pg_tuple);
+  }
+  if (is_columnar_) {
+    current_row_++;
   }
 
   if (row_orders_.size()) {
@@ -91,12 +106,47 @@ Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *p
   return Status::OK();
 }
 
+void PgDocResult::TranslateColumn(const PgExpr *target, int column_index, int attr_index,
+                                  PgTuple *pg_tuple) {
+  if (!is_columnar_) {
+    PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
+    target->TranslateData(&row_iterator_, header, attr_index, pg_tuple);
+    return;
+  }
+
+  // In columnar format, NULL-ness comes from the bitmap and only non-NULL values are stored.
+  PgDocColumnCursor& column = columns_[column_index];
+  PgWireDataHeader header;
+  if (column.IsNull(current_row_)) {
+    header.set_null();
+  }
+  target->TranslateData(&column.data, header, attr_index, pg_tuple);
+}
+
 Status PgDocResult::ProcessSystemColumns() {
   if (syscol_processed_) {
     return Status::OK();
   }
   syscol_processed_ = true;
 
+  if (is_columnar_) {
+    // Only ybctid is selected when system columns are processed.
+    SCHECK_EQ(columns_.size(), 1U, InternalError, "Unexpected columns when reading ybctids");
+    PgDocColumnCursor& column = columns_[0];
+    for (int64_t row = 0; row < row_count_; row++) {
+      SCHECK(!column.IsNull(row), InternalError, "System column ybctid cannot be NULL");
+
+      int64_t data_size;
+      size_t read_size = PgDocData::ReadNumber(&column.data, &data_size);
+      column.data.remove_prefix(read_size);
+
+      ybctids_.emplace_back(column.data.data(), data_size);
+      column.data.remove_prefix(data_size);
+    }
+    current_row_ = row_count_;
+    return Status::OK();
+  }
+
   for (int i = 0; i < row_count_; i++) {
     PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
     SCHECK(!header.is_null(), InternalError, "System column ybctid cannot be NULL");
@@ -162,6 +212,7 @@ Status PgDocOp::GetResult(list<PgDocResult> *rowsets) {
     }
 
     DCHECK(response_.InProgress());
+    waited_for_response_ = !response_.Ready();
     auto rows = VERIFY_RESULT(ProcessResponse(response_.GetStatus(*pg_session_)));
     // In case ProcessResponse doesn't fail with an error
     // it should return non empty rows and/or set end_of_data_.
@@ -295,6 +346,7 @@ Result<std::list<PgDocResult>> PgDocOp::ProcessResponseResult() {
       } else {
         result.emplace_back(pgsql_op->rows_data(), std::move(batch_row_orders_[op_index]));
       }
+      RETURN_NOT_OK(result.back().LoadCache(pgsql_op->response().rows_data_format()));
     }
   }
 
@@ -317,15 +369,30 @@ void PgDocReadOp::ExecuteInit(const PgExecParameters *exec_params) {
   PgDocOp::ExecuteInit(exec_params);
 
   template_op_->mutable_request()->set_return_paging_state(true);
+  if (FLAGS_ysql_enable_columnar_rows_data) {
+    template_op_->mutable_request()->set_rows_data_format(PGSQL_ROWS_DATA_COLUMNAR);
+  }
   SetRequestPrefetchLimit();
   SetRowMark();
   SetReadTime();
 }
 
 Result<std::list<PgDocResult>> PgDocReadOp::ProcessResponseImpl() {
+  size_t response_bytes = 0;
+  for (int op_index = 0; op_index < active_op_count_; op_index++) {
+    response_bytes += pgsql_ops_[op_index]->rows_data().size();
+  }
+
   // Process result from tablet server and check result status.
   auto result = VERIFY_RESULT(ProcessResponseResult());
 
+  int64_t response_rows = 0;
+  for (const auto& rowset : result) {
+    response_rows += rowset.row_count();
+  }
+  rows_fetched_ += response_rows;
+  AdjustPrefetchLimit(response_rows, response_bytes);
+
   // Process paging state and check status.
   RETURN_NOT_OK(ProcessResponsePagingState());
   return result;
@@ -637,6 +704,9 @@ Status PgDocReadOp::ProcessResponsePagingState() {
         innermost_req = innermost_req->mutable_index_request();
       }
       *innermost_req->mutable_paging_state() = std::move(*res.mutable_paging_state());
+      if (UseAdaptivePrefetch()) {
+        req->set_limit(prefetch_limit_);
+      }
 
       // Parse/Analysis/Rewrite catalog version has already been checked on the first request.
       // The docdb layer will check the target table's schema version is compatible.
@@ -694,12 +764,64 @@ void PgDocReadOp::SetRequestPrefetchLimit() {
 
   // Use statement LIMIT(count + offset) if it is smaller than the predicted limit.
   int64_t limit_count = exec_params_.limit_count + exec_params_.limit_offset;
+  statement_limit_ = exec_params_.limit_use_default ? -1 : limit_count;
   suppress_next_result_prefetching_ = true;
   if (exec_params_.limit_use_default || limit_count > predicted_limit) {
     limit_count = predicted_limit;
     suppress_next_result_prefetching_ = false;
   }
   req->set_limit(limit_count);
+  initial_prefetch_limit_ = limit_count;
+  prefetch_limit_ = limit_count;
+  rows_fetched_ = 0;
+}
+
+bool PgDocReadOp::UseAdaptivePrefetch() const {
+  // Only paged scans are adjusted. Pages of COUNT() and of reads by ybctids from an index are
+  // sized by other means.
+  return FLAGS_ysql_enable_adaptive_prefetch && !suppress_next_result_prefetching_ &&
+         !template_op_->request().is_aggregate() && batch_row_orders_.empty();
+}
+
+void PgDocReadOp::AdjustPrefetchLimit(int64_t response_rows, size_t response_bytes) {
+  if (response_rows == 0 || !UseAdaptivePrefetch()) {
+    return;
+  }
+
+  const int64_t row_width = std::max<int64_t>(response_bytes / response_rows, 1);
+  const int num_ops = std::max(std::min(parallelism_level_, active_op_count_), 1);
+  const int64_t rows_left = statement_limit_ >= 0 ? statement_limit_ - rows_fetched_ : -1;
+  const int64_t limit = NextPrefetchLimit(
+      prefetch_limit_, initial_prefetch_limit_, waited_for_response_, row_width, num_ops,
+      rows_left);
+  VLOG_IF(2, limit != prefetch_limit_)
+      << "Prefetch limit changed from " << prefetch_limit_ << " to " << limit
+      << ", row width: " << row_width << ", ops: " << num_ops
+      << ", waited for response: " << waited_for_response_;
+  prefetch_limit_ = limit;
+}
+
+int64_t PgDocReadOp::NextPrefetchLimit(
+    int64_t prefetch_limit, int64_t initial_prefetch_limit, bool waited_for_response,
+    int64_t row_width, int num_ops, int64_t rows_left) {
+  // When postgres had to wait for rows, the scan is bound by round trips, so request more rows
+  // per page. Otherwise the next page is already fetched by the time postgres needs it, and a
+  // smaller page is enough to keep it busy.
+  int64_t limit = waited_for_response
+      ? prefetch_limit * 2 : std::max(prefetch_limit / 2, initial_prefetch_limit);
+  limit = std::min<int64_t>(
+      limit, std::max<int64_t>(FLAGS_ysql_max_prefetch_limit, initial_prefetch_limit));
+
+  // Keep pages of wide rows within the byte budget. The budget is for the whole statement, so it
+  // is shared by the operations that are sent together.
+  limit = std::min<int64_t>(limit, FLAGS_ysql_prefetch_max_bytes / (row_width * num_ops));
+
+  // Do not read rows past the statement LIMIT.
+  if (rows_left >= 0) {
+    limit = std::min(limit, rows_left);
+  }
+
+  return std::max<int64_t>(limit, 1);
 }
 
 void PgDocReadOp::SetRowMark() {
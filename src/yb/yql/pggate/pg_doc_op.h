@@ -22,6 +22,7 @@
 #include "yb/util/locks.h"
 #include "yb/client/yb_op.h"
 #include "yb/yql/pggate/pg_session.h"
+#include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
 namespace pggate {
@@ -39,11 +40,18 @@ class PgDocResult {
   PgDocResult(const PgDocResult&) = delete;
   PgDocResult& operator=(const PgDocResult&) = delete;
 
+  // Setup the reading cursors according to the layout of "data_". Must be called before any rows
+  // are read. Fails if the data is corrupted.
+  CHECKED_STATUS LoadCache(PgsqlRowsDataFormat format);
+
   // Get the order of the next row in this batch.
   int64_t NextRowOrder();
 
   // End of this batch.
   bool is_eof() const {
+    if (is_columnar_) {
+      return current_row_ >= row_count_;
+    }
     return row_count_ == 0 || row_iterator_.empty();
   }
 
@@ -68,9 +76,17 @@ class PgDocResult {
   }
 
  private:
+  // Translate one column of the current row and advance its cursor.
+  void TranslateColumn(const PgExpr *target, int column_index, int attr_index, PgTuple *pg_tuple);
+
   // Data selected from DocDB.
   string data_;
 
+  // Columnar layout: one cursor per selected column and the row currently being read.
+  bool is_columnar_ = false;
+  std::vector<PgDocColumnCursor> columns_;
+  int64_t current_row_ = 0;
+
   // Iterator on "data_" from row to row.
   Slice row_iterator_;
 
@@ -295,6 +311,10 @@ class PgDocOp : public std::enable_shared_from_this<PgDocOp> {
   // Next request will be sent in case upper level will ask for additional data.
   bool suppress_next_result_prefetching_ = false;
 
+  // Whether the last response was not yet received when postgres asked for more rows, i.e. rows
+  // are consumed faster than they are fetched.
+  bool waited_for_response_ = false;
+
   // Populated protobuf request.
   std::vector<std::shared_ptr<client::YBPgsqlOp>> pgsql_ops_;
 
@@ -383,6 +403,14 @@ class PgDocReadOp : public PgDocOp {
 
   void ExecuteInit(const PgExecParameters *exec_params) override;
 
+  // Returns the number of rows each of 'num_ops' operations, which are sent together, should
+  // request for the next page of a scan. 'prefetch_limit' is the limit of the current page and
+  // 'initial_prefetch_limit' the limit of the first one. 'row_width' is the observed size of a row
+  // in bytes and 'rows_left' is the number of rows left under the statement LIMIT, or -1.
+  static int64_t NextPrefetchLimit(
+      int64_t prefetch_limit, int64_t initial_prefetch_limit, bool waited_for_response,
+      int64_t row_width, int num_ops, int64_t rows_left);
+
  private:
   // Create protobuf requests using template_op_.
   CHECKED_STATUS CreateRequests() override;
@@ -425,6 +453,13 @@ class PgDocReadOp : public PgDocOp {
   // Analyze options and pick the appropriate prefetch limit.
   void SetRequestPrefetchLimit();
 
+  // Whether the prefetch limit is adjusted while the scan progresses.
+  bool UseAdaptivePrefetch() const;
+
+  // Adjust the prefetch limit for the next page of a scan after receiving a response with the
+  // given number of rows and bytes.
+  void AdjustPrefetchLimit(int64_t response_rows, size_t response_bytes);
+
   // Set the row_mark_type field of our read request based on our exec control parameter.
   void SetRowMark();
 
@@ -449,6 +484,17 @@ class PgDocReadOp : public PgDocOp {
   // Template operation, used to fill in pgsql_ops_ by either assigning or cloning.
   std::shared_ptr<client::YBPgsqlReadOp> template_op_;
 
+  // Number of rows requested by each page, the limit picked by SetRequestPrefetchLimit() and
+  // the adaptively adjusted limit for the next page.
+  int64_t initial_prefetch_limit_ = 0;
+  int64_t prefetch_limit_ = 0;
+
+  // Number of rows requested by the statement LIMIT clause, or -1 when there is no limit.
+  int64_t statement_limit_ = -1;
+
+  // Number of rows received since the execution started.
+  int64_t rows_fetched_ = 0;
+
   // Used internally for PopulateNextHashPermutationOps to keep track of which permutation should
   // be used to construct the next read_op.
   // Is valid as long as request_population_completed_ is false.
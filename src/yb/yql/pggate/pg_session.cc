@@ -250,6 +250,11 @@ bool PgSessionAsyncRunResult::InProgress() const {
   return future_status_.valid();
 }
 
+bool PgSessionAsyncRunResult::Ready() const {
+  return InProgress() &&
+         future_status_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
 //--------------------------------------------------------------------------------------------------
 // Class PgSession::RunHelper
 //--------------------------------------------------------------------------------------------------
@@ -337,6 +342,10 @@ Status PgSession::RunHelper::Apply(std::shared_ptr<client::YBPgsqlOp> op,
   auto session = VERIFY_RESULT(pg_session_.GetSession(transactional_,
                                                       read_only,
                                                       needs_pessimistic_locking));
+  if (transactional_ && read_only && pg_session_.pg_txn_manager_->IsFollowerReadsEnabled()) {
+    down_cast<client::YBPgsqlReadOp*>(op.get())->set_yb_consistency_level(
+        YBConsistencyLevel::CONSISTENT_PREFIX);
+  }
   if (!yb_session_) {
     yb_session_ = session->shared_from_this();
     if (transactional_ && read_time) {
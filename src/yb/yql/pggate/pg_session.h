@@ -65,6 +65,9 @@ class PgSessionAsyncRunResult {
   CHECKED_STATUS GetStatus(const PgSession& session);
   bool InProgress() const;
 
+  // Whether the response has already arrived, so GetStatus() would not block.
+  bool Ready() const;
+
  private:
   // buffered_operations_ holds buffered operations (if any) which were applied to
   // the YBSession object before the very first non-bufferable operation.
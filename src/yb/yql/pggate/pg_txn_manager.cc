@@ -19,6 +19,7 @@
 #include "yb/client/transaction.h"
 
 #include "yb/common/common.pb.h"
+#include "yb/common/read_hybrid_time.h"
 #include "yb/common/transaction_priority.h"
 
 #include "yb/tserver/tserver_shared_mem.h"
@@ -36,6 +37,10 @@ constexpr uint64_t txn_priority_highpri_lower_bound = yb::kHighPriTxnLowerBound;
 uint64_t txn_priority_regular_upper_bound = yb::kRegularTxnUpperBound;
 uint64_t txn_priority_regular_lower_bound = yb::kRegularTxnLowerBound;
 
+// Local copies of yb_read_from_followers and yb_follower_read_staleness_ms.
+bool read_from_followers = false;
+int32_t follower_read_staleness_ms = 30000;
+
 // Converts double value in range 0..1 to uint64_t value in range
 // 0..(txn_priority_highpri_lower_bound - 1)
 uint64_t ConvertBound(double value) {
@@ -64,6 +69,14 @@ void YBCAssignTransactionPriorityUpperBound(double newval, void* extra) {
   DCHECK_LE(txn_priority_regular_lower_bound, txn_priority_regular_upper_bound);
 }
 
+void YBCAssignReadFromFollowers(bool newval, void* extra) {
+  read_from_followers = newval;
+}
+
+void YBCAssignFollowerReadStalenessMs(int newval, void* extra) {
+  follower_read_staleness_ms = newval;
+}
+
 }
 
 using namespace std::literals;
@@ -154,6 +167,15 @@ Status PgTxnManager::BeginWriteTransactionIfNecessary(bool read_only_op,
     if (defer) {
       // This call is idempotent, meaning it has no affect after the first call.
       session_->DeferReadPoint();
+    } else if (read_only_ && read_from_followers && !follower_reads_) {
+      // Read-only transactions could read from the closest replica at a read time in the past.
+      // The read time is picked once, so all reads of the transaction see the same snapshot.
+      // Replicas whose safe time is behind the read time reject the read, and it is retried
+      // on the leader.
+      auto read_time = clock_->Now().AddMilliseconds(-follower_read_staleness_ms);
+      VLOG(2) << "Reading from followers at " << read_time;
+      session_->SetReadPoint(ReadHybridTime::SingleTime(read_time));
+      follower_reads_ = true;
     }
   } else {
     if (tserver_shared_object_) {
@@ -283,6 +305,7 @@ Result<client::YBSession*> PgTxnManager::GetTransactionalSession() {
 
 void PgTxnManager::ResetTxnAndSession() {
   txn_in_progress_ = false;
+  follower_reads_ = false;
   session_ = nullptr;
   txn_ = nullptr;
   can_restart_.store(true, std::memory_order_release);
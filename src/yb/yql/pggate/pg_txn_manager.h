@@ -72,6 +72,10 @@ class PgTxnManager : public RefCountedThreadSafe<PgTxnManager> {
 
   bool IsDdlMode() const { return ddl_session_.get() != nullptr; }
 
+  // Whether reads of the current transaction are served by the closest replica instead of the
+  // leader. See yb_read_from_followers.
+  bool IsFollowerReadsEnabled() const { return follower_reads_; }
+
  private:
 
   client::TransactionManager* GetOrCreateTransactionManager();
@@ -95,6 +99,10 @@ class PgTxnManager : public RefCountedThreadSafe<PgTxnManager> {
   bool read_only_ = false;
   bool deferrable_ = false;
 
+  // Whether the read point of the current read-only transaction was picked in the past, so its
+  // reads could be served by followers.
+  bool follower_reads_ = false;
+
   client::YBTransactionPtr ddl_txn_;
   client::YBSessionPtr ddl_session_;
 
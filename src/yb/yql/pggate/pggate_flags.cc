@@ -54,6 +54,22 @@ DEFINE_int32(ysql_prefetch_limit, 1024,
 DEFINE_double(ysql_backward_prefetch_scale_factor, 0.0625 /* 1/16th */,
               "Scale factor to reduce ysql_prefetch_limit for backward scan");
 
+DEFINE_bool(ysql_enable_adaptive_prefetch, true,
+            "Adjust the number of rows requested by each page of a scan. The page grows while "
+            "postgres waits for rows and shrinks back when rows are fetched faster than they are "
+            "consumed.");
+
+DEFINE_int32(ysql_max_prefetch_limit, 16384,
+             "Maximum number of rows to prefetch when the prefetch limit is adjusted adaptively");
+
+DEFINE_int32(ysql_prefetch_max_bytes, 4 * 1024 * 1024,
+             "Approximate maximum size of a page of rows, used to cap the adaptive prefetch limit "
+             "for wide rows");
+
+DEFINE_bool(ysql_enable_columnar_rows_data, false,
+            "Request read results from tablet servers in columnar format, which groups values of "
+            "each selected column together and is cheaper to encode and decode for wide scans.");
+
 DEFINE_int32(ysql_session_max_batch_size, 512,
              "Maximum batch size for buffered writes between PostgreSQL server and YugaByte DocDB "
              "services");
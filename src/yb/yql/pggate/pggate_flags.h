@@ -26,6 +26,10 @@ DECLARE_bool(TEST_pggate_ignore_tserver_shm);
 DECLARE_int32(ysql_request_limit);
 DECLARE_int32(ysql_prefetch_limit);
 DECLARE_double(ysql_backward_prefetch_scale_factor);
+DECLARE_bool(ysql_enable_adaptive_prefetch);
+DECLARE_int32(ysql_max_prefetch_limit);
+DECLARE_int32(ysql_prefetch_max_bytes);
+DECLARE_bool(ysql_enable_columnar_rows_data);
 DECLARE_int32(ysql_session_max_batch_size);
 DECLARE_bool(ysql_non_txn_copy);
 DECLARE_int32(ysql_max_read_restart_attempts);
@@ -0,0 +1,92 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+#include "yb/yql/pggate/pg_doc_op.h"
+#include "yb/yql/pggate/pggate_flags.h"
+
+namespace yb {
+namespace pggate {
+
+namespace {
+
+constexpr int64_t kInitialLimit = 1024;
+constexpr int64_t kNarrowRow = 16;
+constexpr int64_t kNoStatementLimit = -1;
+
+} // namespace
+
+class PggateTestPrefetch : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_ysql_max_prefetch_limit = 16384;
+    FLAGS_ysql_prefetch_max_bytes = 4 * 1024 * 1024;
+  }
+};
+
+TEST_F(PggateTestPrefetch, TestRowLimit) {
+  // The page grows while postgres waits for rows, up to ysql_max_prefetch_limit.
+  int64_t limit = kInitialLimit;
+  for (int i = 0; i != 10; ++i) {
+    limit = PgDocReadOp::NextPrefetchLimit(
+        limit, kInitialLimit, true /* waited_for_response */, kNarrowRow, 1 /* num_ops */,
+        kNoStatementLimit);
+  }
+  ASSERT_EQ(FLAGS_ysql_max_prefetch_limit, limit);
+
+  // And shrinks back to the initial limit, but not below it, when rows are fetched in time.
+  for (int i = 0; i != 10; ++i) {
+    limit = PgDocReadOp::NextPrefetchLimit(
+        limit, kInitialLimit, false /* waited_for_response */, kNarrowRow, 1 /* num_ops */,
+        kNoStatementLimit);
+  }
+  ASSERT_EQ(kInitialLimit, limit);
+
+  // Rows past the statement LIMIT are not requested, but at least one row is.
+  ASSERT_EQ(100, PgDocReadOp::NextPrefetchLimit(
+      kInitialLimit, kInitialLimit, true /* waited_for_response */, kNarrowRow, 1 /* num_ops */,
+      100 /* rows_left */));
+  ASSERT_EQ(1, PgDocReadOp::NextPrefetchLimit(
+      kInitialLimit, kInitialLimit, true /* waited_for_response */, kNarrowRow, 1 /* num_ops */,
+      0 /* rows_left */));
+}
+
+TEST_F(PggateTestPrefetch, TestByteLimit) {
+  // Pages of wide rows are capped by ysql_prefetch_max_bytes.
+  const int64_t kWideRow = 64 * 1024;
+  const int64_t rows_per_budget = FLAGS_ysql_prefetch_max_bytes / kWideRow;
+  ASSERT_EQ(rows_per_budget, PgDocReadOp::NextPrefetchLimit(
+      kInitialLimit, kInitialLimit, true /* waited_for_response */, kWideRow, 1 /* num_ops */,
+      kNoStatementLimit));
+
+  // The budget is shared by the operations that are sent together.
+  const int kNumOps = 4;
+  const int64_t limit = PgDocReadOp::NextPrefetchLimit(
+      kInitialLimit, kInitialLimit, true /* waited_for_response */, kWideRow, kNumOps,
+      kNoStatementLimit);
+  ASSERT_EQ(rows_per_budget / kNumOps, limit);
+  ASSERT_LE(limit * kWideRow * kNumOps, FLAGS_ysql_prefetch_max_bytes);
+
+  // Rows wider than the whole budget are still fetched one at a time.
+  ASSERT_EQ(1, PgDocReadOp::NextPrefetchLimit(
+      kInitialLimit, kInitialLimit, true /* waited_for_response */,
+      FLAGS_ysql_prefetch_max_bytes * 2, kNumOps, kNoStatementLimit));
+}
+
+} // namespace pggate
+} // namespace yb
@@ -0,0 +1,154 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "yb/common/ql_value.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+#include "yb/yql/pggate/util/pg_doc_data.h"
+
+namespace yb {
+namespace pggate {
+
+namespace {
+
+// Serializes rows the way the tablet server does: row count, then the columnar writer output.
+std::string SerializeColumnar(const std::vector<std::vector<QLValuePB>>& rows,
+                              size_t column_count) {
+  PgDocColumnarWriter writer(column_count);
+  for (const auto& row : rows) {
+    for (size_t i = 0; i != row.size(); ++i) {
+      CHECK_OK(writer.WriteColumn(i, row[i]));
+    }
+    writer.FinishRow();
+  }
+  faststring buffer;
+  PgWire::WriteInt64(writer.row_count(), &buffer);
+  writer.Serialize(&buffer);
+  return buffer.ToString();
+}
+
+QLValuePB Int64Value(int64_t value) {
+  QLValuePB result;
+  result.set_int64_value(value);
+  return result;
+}
+
+QLValuePB StringValue(const std::string& value) {
+  QLValuePB result;
+  result.set_string_value(value);
+  return result;
+}
+
+boost::optional<int64_t> ReadInt64(PgDocColumnCursor* column, int64_t row) {
+  if (column->IsNull(row)) {
+    return boost::none;
+  }
+  int64_t value;
+  column->data.remove_prefix(PgDocData::ReadNumber(&column->data, &value));
+  return value;
+}
+
+// Text is stored with its length, which includes the terminating '\0'.
+boost::optional<std::string> ReadString(PgDocColumnCursor* column, int64_t row) {
+  if (column->IsNull(row)) {
+    return boost::none;
+  }
+  int64_t length;
+  column->data.remove_prefix(PgDocData::ReadNumber(&column->data, &length));
+  std::string value(column->data.cdata(), length - 1);
+  column->data.remove_prefix(length);
+  return value;
+}
+
+} // namespace
+
+TEST(PgDocDataTest, ColumnarRoundTrip) {
+  const QLValuePB null_value;
+  std::vector<boost::optional<int64_t>> ints;
+  std::vector<boost::optional<std::string>> strings;
+  std::vector<std::vector<QLValuePB>> rows;
+  // More than 8 rows, so the null bitmaps span several bytes.
+  for (int i = 0; i != 19; ++i) {
+    ints.push_back(i % 3 == 0 ? boost::none : boost::make_optional<int64_t>(i * 1000));
+    // Variable length values, including an empty string that is not NULL.
+    strings.push_back(i % 5 == 4 ? boost::none
+                                 : boost::make_optional(std::string(i % 7, 'a' + i)));
+    rows.push_back({ ints.back() ? Int64Value(*ints.back()) : null_value,
+                     strings.back() ? StringValue(*strings.back()) : null_value });
+  }
+
+  const auto data = SerializeColumnar(rows, 2);
+  int64_t row_count = 0;
+  std::vector<PgDocColumnCursor> columns;
+  ASSERT_OK(PgDocData::LoadColumnarCache(data, &row_count, &columns));
+  ASSERT_EQ(static_cast<int64_t>(rows.size()), row_count);
+  ASSERT_EQ(2, columns.size());
+
+  for (int64_t row = 0; row != row_count; ++row) {
+    SCOPED_TRACE(Format("Row: $0", row));
+    ASSERT_EQ(ints[row], ReadInt64(&columns[0], row));
+    ASSERT_EQ(strings[row], ReadString(&columns[1], row));
+  }
+  ASSERT_TRUE(columns[0].data.empty());
+  ASSERT_TRUE(columns[1].data.empty());
+}
+
+TEST(PgDocDataTest, ColumnarAllNulls) {
+  const QLValuePB null_value;
+  const std::vector<std::vector<QLValuePB>> rows(3, { null_value });
+  const auto data = SerializeColumnar(rows, 1);
+
+  int64_t row_count = 0;
+  std::vector<PgDocColumnCursor> columns;
+  ASSERT_OK(PgDocData::LoadColumnarCache(data, &row_count, &columns));
+  ASSERT_EQ(3, row_count);
+  ASSERT_EQ(1, columns.size());
+  for (int64_t row = 0; row != row_count; ++row) {
+    ASSERT_TRUE(columns[0].IsNull(row));
+  }
+  ASSERT_TRUE(columns[0].data.empty());
+}
+
+TEST(PgDocDataTest, ColumnarEmptyBatch) {
+  const auto data = SerializeColumnar({}, 3);
+
+  int64_t row_count = -1;
+  std::vector<PgDocColumnCursor> columns;
+  ASSERT_OK(PgDocData::LoadColumnarCache(data, &row_count, &columns));
+  ASSERT_EQ(0, row_count);
+  ASSERT_EQ(3, columns.size());
+  for (const auto& column : columns) {
+    ASSERT_TRUE(column.data.empty());
+  }
+}
+
+TEST(PgDocDataTest, ColumnarTruncated) {
+  const auto data = SerializeColumnar({{ Int64Value(1) }, { Int64Value(2) }}, 1);
+
+  int64_t row_count = 0;
+  std::vector<PgDocColumnCursor> columns;
+  for (size_t size = 0; size != data.size(); ++size) {
+    auto status = PgDocData::LoadColumnarCache(data.substr(0, size), &row_count, &columns);
+    ASSERT_TRUE(status.IsCorruption()) << "Size: " << size << ", status: " << status;
+  }
+}
+
+}  // namespace pggate
+}  // namespace yb
@@ -38,6 +38,10 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
     return Status::OK();
   }
 
+  return WriteColumnValue(col_value, buffer);
+}
+
+Status WriteColumnValue(const QLValuePB& col_value, faststring *buffer) {
   switch (col_value.value_case()) {
     case InternalType::VALUE_NOT_SET:
       break;
@@ -102,6 +106,39 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
   return Status::OK();
 }
 
+//--------------------------------------------------------------------------------------------------
+// Columnar Format.
+//--------------------------------------------------------------------------------------------------
+
+PgDocColumnarWriter::PgDocColumnarWriter(size_t column_count) : columns_(column_count) {
+}
+
+Status PgDocColumnarWriter::WriteColumn(size_t column_index, const QLValuePB& col_value) {
+  DCHECK_LT(column_index, columns_.size());
+  Column& column = columns_[column_index];
+
+  // Start a new byte of null bitmap every 8 rows.
+  if ((row_count_ & 7) == 0) {
+    column.nulls.push_back(0);
+  }
+  if (QLValue::IsNull(col_value)) {
+    column.nulls.data()[column.nulls.size() - 1] |= 1 << (row_count_ & 7);
+    return Status::OK();
+  }
+  return WriteColumnValue(col_value, &column.data);
+}
+
+void PgDocColumnarWriter::Serialize(faststring *buffer) const {
+  const size_t bitmap_size = (row_count_ + 7) / 8;
+  PgWire::WriteInt64(columns_.size(), buffer);
+  for (const Column& column : columns_) {
+    DCHECK_EQ(column.nulls.size(), bitmap_size);
+    buffer->append(column.nulls.data(), bitmap_size);
+    PgWire::WriteInt64(column.data.size(), buffer);
+    buffer->append(column.data.data(), column.data.size());
+  }
+}
+
 //--------------------------------------------------------------------------------------------------
 // Read Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
@@ -118,6 +155,39 @@ void PgDocData::LoadCache(const string& cache, int64_t *total_row_count, Slice *
   cursor->remove_prefix(read_size);
 }
 
+Status PgDocData::LoadColumnarCache(const string& cache, int64_t *total_row_count,
+                                    std::vector<PgDocColumnCursor> *columns) {
+  Slice cursor(cache);
+  SCHECK_GE(cursor.size(), 2 * sizeof(int64_t), Corruption, "Columnar rows data is truncated");
+
+  int64_t row_count;
+  cursor.remove_prefix(ReadNumber(&cursor, &row_count));
+  int64_t column_count;
+  cursor.remove_prefix(ReadNumber(&cursor, &column_count));
+
+  SCHECK_GE(row_count, 0, Corruption, "Invalid row count in columnar rows data");
+  const size_t bitmap_size = (row_count + 7) / 8;
+  columns->clear();
+  for (int64_t i = 0; i < column_count; i++) {
+    SCHECK_GE(cursor.size(), bitmap_size + sizeof(int64_t), Corruption,
+              "Columnar rows data is truncated");
+    PgDocColumnCursor column;
+    column.nulls = cursor.data();
+    cursor.remove_prefix(bitmap_size);
+
+    int64_t data_size;
+    cursor.remove_prefix(ReadNumber(&cursor, &data_size));
+    SCHECK_GE(static_cast<int64_t>(cursor.size()), data_size, Corruption,
+              "Columnar rows data is truncated");
+    column.data = Slice(cursor.data(), data_size);
+    cursor.remove_prefix(data_size);
+    columns->push_back(column);
+  }
+
+  *total_row_count = row_count;
+  return Status::OK();
+}
+
 PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
   // Read for NULL value.
   uint8_t header_data;
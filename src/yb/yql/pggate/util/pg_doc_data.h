@@ -14,6 +14,8 @@
 #ifndef YB_YQL_PGGATE_UTIL_PG_DOC_DATA_H_
 #define YB_YQL_PGGATE_UTIL_PG_DOC_DATA_H_
 
+#include <vector>
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/yql/pggate/util/pg_wire.h"
 
@@ -22,10 +24,68 @@ namespace pggate {
 
 CHECKED_STATUS WriteColumn(const QLValuePB& col_value, faststring *buffer);
 
+// Write the value of a column without its data header. The value must not be NULL.
+CHECKED_STATUS WriteColumnValue(const QLValuePB& col_value, faststring *buffer);
+
+// Collects result rows column by column and serializes them in columnar format.
+//   row_count    : int64
+//   column_count : int64
+//   For each column:
+//     null bitmap : (row_count + 7) / 8 bytes, bit (row % 8) of byte (row / 8) is set for NULL.
+//     data size   : int64
+//     data        : Values of non-NULL rows in row order, each encoded as in row-wise format but
+//                   without the data header.
+class PgDocColumnarWriter {
+ public:
+  explicit PgDocColumnarWriter(size_t column_count);
+
+  // Write the value of the given column for the current row.
+  CHECKED_STATUS WriteColumn(size_t column_index, const QLValuePB& col_value);
+
+  // Complete the current row. All columns must have been written.
+  void FinishRow() {
+    ++row_count_;
+  }
+
+  int64_t row_count() const {
+    return row_count_;
+  }
+
+  // Append the column count and the collected columns to the buffer. Same as row-wise format, the
+  // row count that precedes them is written by the caller.
+  void Serialize(faststring *buffer) const;
+
+ private:
+  struct Column {
+    faststring nulls;
+    faststring data;
+  };
+
+  std::vector<Column> columns_;
+  int64_t row_count_ = 0;
+};
+
+// Position of the reader within one column of a columnar batch.
+struct PgDocColumnCursor {
+  // Null bitmap of the column.
+  const uint8_t *nulls = nullptr;
+
+  // Values of non-NULL rows that are not yet read.
+  Slice data;
+
+  bool IsNull(int64_t row) const {
+    return (nulls[row >> 3] >> (row & 7)) & 1;
+  }
+};
+
 class PgDocData : public PgWire {
  public:
   static void LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
 
+  // Setup column cursors to read a batch of tuples in columnar format.
+  static CHECKED_STATUS LoadColumnarCache(const string& data, int64_t *total_row_count,
+                                          std::vector<PgDocColumnCursor> *columns);
+
   static PgWireDataHeader ReadDataHeader(Slice *cursor);
 };
 
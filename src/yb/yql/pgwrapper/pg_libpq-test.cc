@@ -2297,5 +2297,33 @@ TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(CacheRefreshRetryEnabled)) {
   TestCacheRefreshRetry(false /* is_retry_disabled */);
 }
 
+// Read-only transactions with yb_read_from_followers read data as of
+// yb_follower_read_staleness_ms ago, no matter whether they are served by a follower or the leader.
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(FollowerReads)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, value TEXT)"));
+  ASSERT_OK(conn.Execute("INSERT INTO t VALUES (1, 'old')"));
+  std::this_thread::sleep_for(5s);
+  ASSERT_OK(conn.Execute("UPDATE t SET value = 'new' WHERE key = 1"));
+
+  ASSERT_OK(conn.Execute("SET yb_read_from_followers = true"));
+  ASSERT_OK(conn.Execute("SET yb_follower_read_staleness_ms = 2500"));
+  const std::string kQuery = "SELECT value FROM t WHERE key = 1";
+
+  // Not a read-only transaction, so the read is served by the leader at the current time.
+  ASSERT_EQ("new", ASSERT_RESULT(conn.FetchValue<std::string>(kQuery)));
+
+  ASSERT_OK(conn.Execute("SET default_transaction_read_only = true"));
+  ASSERT_EQ("old", ASSERT_RESULT(conn.FetchValue<std::string>(kQuery)));
+
+  ASSERT_OK(conn.Execute("BEGIN"));
+  ASSERT_EQ("old", ASSERT_RESULT(conn.FetchValue<std::string>(kQuery)));
+  ASSERT_EQ("old", ASSERT_RESULT(conn.FetchValue<std::string>("SELECT value FROM t")));
+  ASSERT_OK(conn.Execute("COMMIT"));
+
+  ASSERT_OK(conn.Execute("SET yb_read_from_followers = false"));
+  ASSERT_EQ("new", ASSERT_RESULT(conn.FetchValue<std::string>(kQuery)));
+}
+
 } // namespace pgwrapper
 } // namespace yb